@@ -0,0 +1,340 @@
+using System;
+using System.Diagnostics;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace SongLedPc;
+
+internal enum CoverSendResult
+{
+    Delivered,
+    Unsupported,
+    Failed,
+    Aborted,
+    Rejected
+}
+
+/// <summary>
+/// 一次封面传输的负载：格式（RAW / Q565 / JPG）、图像尺寸、线上字节
+/// </summary>
+internal sealed record CoverPayload(string Format, int Width, int Height, byte[] Bytes)
+{
+    /// <summary>
+    /// 无损负载：Q565，压缩无收益时退回 RAW；交错模式按 Adam7 顺序发送（格式名加 I）
+    /// </summary>
+    public static CoverPayload Lossless(ushort[] pixels, int width, int height, bool interlaced)
+    {
+        ushort[] ordered = interlaced ? Q565Codec.Adam7Order(pixels, width, height) : pixels;
+        string suffix = interlaced ? "I" : string.Empty;
+        byte[] q565 = Q565Codec.Encode(ordered);
+        return q565.Length < ordered.Length * 2
+            ? new CoverPayload("Q565" + suffix, width, height, q565)
+            : new CoverPayload("RAW" + suffix, width, height, Q565Codec.Raw(ordered));
+    }
+}
+
+/// <summary>
+/// 封面窗口化传输：分块编号 + CRC16 + 滑动窗口 + 累计确认 + 选择重传
+/// PC -> ESP32: NP COV BEGIN w h xfer chunkBytes fmt totalBytes / NP COV CHK xfer idx crc hex / NP COV END xfer / NP COV ABORT xfer
+/// ESP32 -> PC: COV ACK xfer cum sack / COV NAK xfer reason
+/// 缓存协商: PC -> ESP32 NP COV HAS key / ESP32 -> PC COV HIT key | COV MISS key
+/// 负载为编码后的字节流（Q565 / RAW / JPG）
+/// </summary>
+internal sealed class CoverTransfer
+{
+    public const int ChunkBytes = 80;
+    private const int Window = 8;
+    private const int AckTimeoutMs = 600;
+    private const int MinAckTimeoutMs = 50;
+    private const int InitialRttMs = 300;
+    private const int MinRttMs = 10;
+    private const int UnsupportedProbeMs = 1500;
+    private const int MaxTimeouts = 8;
+    private const int CacheQueryTimeoutMs = 400;
+
+    private readonly SerialWorker _serial;
+    private readonly Logger _log;
+    private readonly object _ackLock = new();
+    private readonly SemaphoreSlim _ackSignal = new(0);
+    private int _nextXferId;
+    private int _activeXfer;
+    private int _ackCum;
+    private uint _ackSack;
+    private bool _ackSeen;
+    private string? _nakReason;
+    private string? _cacheKey;
+    private TaskCompletionSource<bool>? _cacheReply;
+
+    public CoverTransfer(SerialWorker serial, Logger log)
+    {
+        _serial = serial;
+        _log = log;
+        _serial.CoverAckReceived += OnAck;
+        _serial.CoverNakReceived += OnNak;
+        _serial.CoverCacheReply += OnCacheReply;
+    }
+
+    /// <summary>
+    /// 询问设备是否已缓存该封面；true 命中、false 未命中、null 无应答（旧固件）
+    /// </summary>
+    public async Task<bool?> QueryCacheAsync(string key, CancellationToken ct)
+    {
+        var reply = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+        lock (_ackLock)
+        {
+            _cacheKey = key;
+            _cacheReply = reply;
+        }
+        try
+        {
+            _serial.SendLine($"NP COV HAS {key}");
+            var done = await Task.WhenAny(reply.Task, Task.Delay(CacheQueryTimeoutMs, ct));
+            ct.ThrowIfCancellationRequested();
+            return done == reply.Task ? reply.Task.Result : null;
+        }
+        finally
+        {
+            lock (_ackLock)
+            {
+                if (_cacheReply == reply) _cacheReply = null;
+            }
+        }
+    }
+
+    /// <summary>
+    /// 封面内容键：RGB565 大端字节的 64 位 FNV-1a
+    /// </summary>
+    public static string ContentKey(ushort[] pixels)
+    {
+        ulong hash = 0xCBF29CE484222325UL;
+        foreach (ushort px in pixels)
+        {
+            hash = (hash ^ (byte)(px >> 8)) * 0x100000001B3UL;
+            hash = (hash ^ (byte)(px & 0xFF)) * 0x100000001B3UL;
+        }
+        return hash.ToString("X16");
+    }
+
+    public async Task<CoverSendResult> SendAsync(CoverPayload cover, CancellationToken ct)
+    {
+        int xfer = (Interlocked.Increment(ref _nextXferId) & 0x7FFF) + 1;
+        byte[] payload = cover.Bytes;
+        string format = cover.Format;
+        int chunks = (payload.Length + ChunkBytes - 1) / ChunkBytes;
+        var lines = new string[chunks];
+        for (int i = 0; i < chunks; i++)
+        {
+            lines[i] = BuildChunkLine(xfer, i, payload);
+        }
+        var acked = new bool[chunks];
+        var sentAt = new long[chunks];
+        var sendCount = new int[chunks];
+
+        lock (_ackLock)
+        {
+            _activeXfer = xfer;
+            _ackCum = 0;
+            _ackSack = 0;
+            _ackSeen = false;
+            _nakReason = null;
+        }
+        while (_ackSignal.CurrentCount > 0) _ackSignal.Wait(0);
+
+        var sw = Stopwatch.StartNew();
+        int baseIdx = 0;
+        int next = 0;
+        int resent = 0;
+        int timeouts = 0;
+        double srtt = 0;
+
+        // 往返时间取自 ACK 实测（只用发过一次的分块采样），测到之前用保守初值
+        long RttMs() => srtt > 0 ? Math.Max((long)srtt, MinRttMs) : InitialRttMs;
+        // 超时取 4 倍 RTT，连续超时逐次翻倍，上限 AckTimeoutMs
+        int AckWaitMs() => (int)Math.Min(AckTimeoutMs, Math.Max(MinAckTimeoutMs, RttMs() * 4) << Math.Min(timeouts, 4));
+
+        void Send(int idx)
+        {
+            sentAt[idx] = sw.ElapsedMilliseconds;
+            sendCount[idx]++;
+            _serial.SendBulkLine(lines[idx], xfer);
+        }
+
+        try
+        {
+            _serial.SendBulkLine($"NP COV BEGIN {cover.Width} {cover.Height} {xfer} {ChunkBytes} {format} {payload.Length}", xfer);
+            while (baseIdx < chunks)
+            {
+                while (next < chunks && next < baseIdx + Window)
+                {
+                    Send(next++);
+                }
+
+                bool gotAck = await _ackSignal.WaitAsync(AckWaitMs(), ct);
+                int cum;
+                uint sack;
+                bool seen;
+                string? nak;
+                lock (_ackLock)
+                {
+                    cum = _ackCum;
+                    sack = _ackSack;
+                    seen = _ackSeen;
+                    nak = _nakReason;
+                }
+
+                if (nak != null)
+                {
+                    _serial.ClearBulk(xfer);
+                    _log.Info($"Cover xfer {xfer} rejected by device: {format} {payload.Length} B ({nak})");
+                    return CoverSendResult.Rejected;
+                }
+
+                if (!gotAck)
+                {
+                    if (!seen && sw.ElapsedMilliseconds >= UnsupportedProbeMs)
+                    {
+                        _serial.ClearBulk(xfer);
+                        return CoverSendResult.Unsupported;
+                    }
+                    if (++timeouts > MaxTimeouts)
+                    {
+                        _log.Info($"Cover xfer {xfer} failed: no progress at chunk {baseIdx}/{chunks}");
+                        AbortOnDevice(xfer);
+                        return CoverSendResult.Failed;
+                    }
+                    // Nothing heard for a whole timeout: anything still unacked in the window may be gone.
+                    for (int i = baseIdx; i < next; i++)
+                    {
+                        if (acked[i]) continue;
+                        Send(i);
+                        resent++;
+                    }
+                    continue;
+                }
+
+                timeouts = 0;
+                long now = sw.ElapsedMilliseconds;
+                long sample = -1;
+                void Ack(int idx)
+                {
+                    if (acked[idx]) return;
+                    acked[idx] = true;
+                    if (sendCount[idx] == 1) sample = now - sentAt[idx];
+                }
+                cum = Math.Clamp(cum, 0, chunks);
+                for (int i = baseIdx; i < cum; i++) Ack(i);
+                int highest = cum - 1;
+                for (int b = 0; b < 32; b++)
+                {
+                    int idx = cum + 1 + b;
+                    if (idx >= chunks) break;
+                    if ((sack & (1u << b)) != 0)
+                    {
+                        Ack(idx);
+                        highest = idx;
+                    }
+                }
+                baseIdx = Math.Max(baseIdx, cum);
+                // 首个 ACK（哪怕只确认了 BEGIN）也给出一个 RTT 上界：BEGIN 在计时开始时入队
+                if (sample < 0 && srtt == 0) sample = now;
+                if (sample >= 0) srtt = srtt > 0 ? srtt * 0.875 + sample * 0.125 : Math.Max(sample, 1);
+
+                // The link is in-order, so a hole below a selectively acked chunk is a loss:
+                // resend it at once; a resent hole gets one RTT for its copy to be acked first.
+                for (int i = baseIdx; i < highest; i++)
+                {
+                    if (acked[i]) continue;
+                    if (sendCount[i] == 1 || now - sentAt[i] >= RttMs())
+                    {
+                        Send(i);
+                        resent++;
+                    }
+                }
+            }
+
+            _serial.SendBulkLine($"NP COV END {xfer}", xfer);
+            double seconds = Math.Max(sw.Elapsed.TotalSeconds, 0.001);
+            int pixelBytes = cover.Width * cover.Height * 2;
+            _log.Info($"Cover xfer {xfer}: {format} {cover.Width}x{cover.Height} {payload.Length}/{pixelBytes} B, {chunks} chunks, {resent} resent, {sw.ElapsedMilliseconds} ms ({pixelBytes / 1024.0 / seconds:F2} KB/s goodput)");
+            return CoverSendResult.Delivered;
+        }
+        catch (OperationCanceledException)
+        {
+            AbortOnDevice(xfer);
+            _log.Info($"Cover xfer {xfer} aborted at chunk {baseIdx}/{chunks}");
+            return CoverSendResult.Aborted;
+        }
+        finally
+        {
+            lock (_ackLock)
+            {
+                if (_activeXfer == xfer) _activeXfer = 0;
+            }
+        }
+    }
+
+    private void AbortOnDevice(int xfer)
+    {
+        _serial.ClearBulk(xfer);
+        _serial.SendLine($"NP COV ABORT {xfer}");
+    }
+
+    private void OnAck(int xfer, int cumulative, uint sack)
+    {
+        lock (_ackLock)
+        {
+            if (xfer != _activeXfer) return;
+            _ackCum = cumulative;
+            _ackSack = sack;
+            _ackSeen = true;
+        }
+        _ackSignal.Release();
+    }
+
+    private void OnNak(int xfer, string reason)
+    {
+        lock (_ackLock)
+        {
+            if (xfer != _activeXfer) return;
+            _nakReason = reason;
+        }
+        _ackSignal.Release();
+    }
+
+    private void OnCacheReply(string key, bool hit)
+    {
+        TaskCompletionSource<bool>? reply;
+        lock (_ackLock)
+        {
+            if (!string.Equals(key, _cacheKey, StringComparison.OrdinalIgnoreCase)) return;
+            reply = _cacheReply;
+        }
+        reply?.TrySetResult(hit);
+    }
+
+    private static string BuildChunkLine(int xfer, int idx, byte[] payload)
+    {
+        int start = idx * ChunkBytes;
+        int count = Math.Min(ChunkBytes, payload.Length - start);
+        ushort crc = 0xFFFF;
+        for (int i = 0; i < count; i++)
+        {
+            crc = Crc16Ccitt(crc, payload[start + i]);
+        }
+        var sb = new StringBuilder(32 + count * 2);
+        sb.Append("NP COV CHK ").Append(xfer).Append(' ').Append(idx).Append(' ').Append(crc.ToString("X4")).Append(' ');
+        sb.Append(Convert.ToHexString(payload, start, count));
+        return sb.ToString();
+    }
+
+    private static ushort Crc16Ccitt(ushort crc, byte value)
+    {
+        crc ^= (ushort)(value << 8);
+        for (int b = 0; b < 8; b++)
+        {
+            crc = (crc & 0x8000) != 0 ? (ushort)((crc << 1) ^ 0x1021) : (ushort)(crc << 1);
+        }
+        return crc;
+    }
+}
@@ -0,0 +1,146 @@
+using System;
+using System.Collections.Generic;
+using System.Threading;
+using NAudio.CoreAudioApi;
+using NAudio.CoreAudioApi.Interfaces;
+
+namespace SongLedPc;
+
+/// <summary>
+/// 设备端音频设备列表的稳定编号与版本号（DEVLIST）
+/// 全量列表：TAG BEGIN ver / TAG ITEM id name / TAG END，编号从 0 重新分配（与 STATE 中的位置一致）
+/// 之后的变化：TAG ADD ver id name / TAG DEL ver id / TAG REN ver id name，每行版本号加一
+/// 已分配的编号在下一次全量列表之前不会复用，设备发现版本不连续时重新请求 LIST
+/// </summary>
+internal sealed class EndpointList
+{
+    private readonly List<(int Id, string EndpointId, string Name)> _items = new();
+    private int _nextId;
+
+    public EndpointList(string tag)
+    {
+        Tag = tag;
+    }
+
+    public string Tag { get; }
+
+    /// <summary>
+    /// 0 表示尚未向设备发送过列表
+    /// </summary>
+    public ushort Version { get; private set; }
+
+    /// <summary>
+    /// 最近一次发给设备的 CUR 编号
+    /// </summary>
+    public int CurrentId { get; set; } = -1;
+
+    public IReadOnlyList<(int Id, string EndpointId, string Name)> Items => _items;
+
+    public void Reset(IReadOnlyList<MMDevice> devices, Func<string, string> nameOf)
+    {
+        _items.Clear();
+        foreach (var d in devices) _items.Add((_items.Count, d.ID, nameOf(d.FriendlyName)));
+        _nextId = _items.Count;
+        CurrentId = -1;
+        NextVersion();
+    }
+
+    public int IdFor(string endpointId)
+    {
+        int idx = _items.FindIndex(i => i.EndpointId == endpointId);
+        return idx >= 0 ? _items[idx].Id : -1;
+    }
+
+    public string? EndpointFor(int id)
+    {
+        int idx = _items.FindIndex(i => i.Id == id);
+        return idx >= 0 ? _items[idx].EndpointId : null;
+    }
+
+    /// <summary>
+    /// 与当前枚举结果比较，返回需要发送的增量行（已带 TAG 与版本号）
+    /// </summary>
+    public List<string> Diff(IReadOnlyList<MMDevice> devices, Func<string, string> nameOf)
+    {
+        var lines = new List<string>();
+        var present = new Dictionary<string, string>();
+        foreach (var d in devices) present[d.ID] = nameOf(d.FriendlyName);
+
+        for (int i = _items.Count - 1; i >= 0; i--)
+        {
+            var item = _items[i];
+            if (!present.TryGetValue(item.EndpointId, out string? name))
+            {
+                _items.RemoveAt(i);
+                lines.Add($"{Tag} DEL {NextVersion()} {item.Id}");
+            }
+            else if (name != item.Name)
+            {
+                _items[i] = (item.Id, item.EndpointId, name);
+                lines.Add($"{Tag} REN {NextVersion()} {item.Id} {name}");
+            }
+        }
+        foreach (var d in devices)
+        {
+            if (IdFor(d.ID) >= 0) continue;
+            int id = _nextId++;
+            string name = present[d.ID];
+            _items.Add((id, d.ID, name));
+            lines.Add($"{Tag} ADD {NextVersion()} {id} {name}");
+        }
+        return lines;
+    }
+
+    private ushort NextVersion()
+    {
+        Version = (ushort)(Version + 1);
+        if (Version == 0) Version = 1;  // 0 is "unversioned" on the device
+        return Version;
+    }
+}
+
+/// <summary>
+/// 监听 Windows 音频端点的增删、改名与默认设备切换，合并抖动后回调一次
+/// </summary>
+internal sealed class EndpointWatcher : IMMNotificationClient, IDisposable
+{
+    private const int SettleMs = 300;
+
+    private readonly MMDeviceEnumerator _enumerator;
+    private readonly Timer _timer;
+
+    public EndpointWatcher(MMDeviceEnumerator enumerator, Action changed)
+    {
+        _enumerator = enumerator;
+        _timer = new Timer(_ => changed(), null, Timeout.Infinite, Timeout.Infinite);
+        _enumerator.RegisterEndpointNotificationCallback(this);
+    }
+
+    private void Touch() => _timer.Change(SettleMs, Timeout.Infinite);
+
+    public void OnDeviceStateChanged(string deviceId, DeviceState newState) => Touch();
+
+    public void OnDeviceAdded(string pwstrDeviceId) => Touch();
+
+    public void OnDeviceRemoved(string deviceId) => Touch();
+
+    public void OnDefaultDeviceChanged(DataFlow flow, Role role, string defaultDeviceId)
+    {
+        if (role == Role.Multimedia) Touch();
+    }
+
+    public void OnPropertyValueChanged(string pwstrDeviceId, PropertyKey key)
+    {
+        if (key.formatId == PropertyKeys.PKEY_Device_FriendlyName.formatId &&
+            key.propertyId == PropertyKeys.PKEY_Device_FriendlyName.propertyId)
+        {
+            Touch();
+        }
+    }
+
+    public void Dispose()
+    {
+        _enumerator.UnregisterEndpointNotificationCallback(this);
+        _timer.Dispose();
+    }
+}
@@ -0,0 +1,97 @@
+using System;
+using System.Diagnostics;
+
+namespace SongLedPc;
+
+/// <summary>
+/// 链路时钟同步（NTP 式）：估计设备时钟相对 PC 的偏移与往返时延
+/// PC -> ESP32: TIME REQ t1（写出时打戳）/ TIME SET offset rtt
+/// ESP32 -> PC: TIME RSP t1 t2 t3（设备收到 / 应答时的毫秒时钟）
+/// 握手后（CAPS 含 TIME）连发一组，此后每个 APP LIVE 采样一次；取最近窗口内时延最小的样本
+/// 带时间戳的 NP PROG 由设备按 offset 换算后补偿在途时间
+/// </summary>
+internal sealed class LinkClock
+{
+    public const string RequestLine = "TIME REQ";
+    private const int BurstSamples = 4;
+    private const int Window = 8;
+    private const int MaxRttMs = 5000;
+    private const int ReportIntervalMs = 30000;
+
+    private readonly SerialWorker _serial;
+    private readonly Logger _log;
+    private readonly object _lock = new();
+    private readonly (uint Offset, int Rtt)[] _samples = new (uint, int)[Window];
+    private int _sampleCount;
+    private int _sampleNext;
+    private long _lastReport;
+
+    public LinkClock(SerialWorker serial, Logger log)
+    {
+        _serial = serial;
+        _log = log;
+        _serial.CapsReceived += OnCaps;
+        _serial.LinkAlive += Request;
+        _serial.TimeReplyReceived += OnReply;
+    }
+
+    /// <summary>
+    /// PC 端单调毫秒时钟（32 位回绕），NP PROG 等带时间戳的行使用
+    /// </summary>
+    public static uint NowMs() => (uint)(Stopwatch.GetTimestamp() * 1000 / Stopwatch.Frequency);
+
+    public void Reset()
+    {
+        lock (_lock)
+        {
+            _sampleCount = 0;
+            _sampleNext = 0;
+        }
+    }
+
+    private void OnCaps()
+    {
+        Reset();
+        if (!_serial.HasCap("TIME")) return;
+        for (int i = 0; i < BurstSamples; i++) Request();
+    }
+
+    private void Request()
+    {
+        // The writer thread appends t1 right before the line hits the wire.
+        if (_serial.HasCap("TIME")) _serial.SendLine(RequestLine);
+    }
+
+    private void OnReply(uint t1, uint t2, uint t3)
+    {
+        uint t4 = NowMs();
+        int rtt = (int)(t4 - t1) - (int)(t3 - t2);
+        if (rtt < 0 || rtt > MaxRttMs) return;
+        // offset = ((t2 - t1) + (t3 - t4)) / 2, kept modular because the epochs are unrelated.
+        uint toDevice = t2 - t1;
+        uint offset = toDevice + (uint)((int)((t3 - t4) - toDevice) / 2);
+
+        (uint Offset, int Rtt) best;
+        int count;
+        lock (_lock)
+        {
+            _samples[_sampleNext] = (offset, rtt);
+            _sampleNext = (_sampleNext + 1) % Window;
+            if (_sampleCount < Window) _sampleCount++;
+            count = _sampleCount;
+            best = _samples[0];
+            for (int i = 1; i < _sampleCount; i++)
+            {
+                if (_samples[i].Rtt < best.Rtt) best = _samples[i];
+            }
+        }
+        _serial.SendLine($"TIME SET {best.Offset} {best.Rtt}");
+
+        long now = Environment.TickCount64;
+        if (count == BurstSamples || now - _lastReport >= ReportIntervalMs)
+        {
+            _lastReport = now;
+            _log.Info($"Clock sync {_serial.ConnectionLabel}: rtt={best.Rtt} ms, err=±{best.Rtt / 2.0:F1} ms (last rtt {rtt} ms, {count} samples)");
+        }
+    }
+}
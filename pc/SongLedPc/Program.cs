@@ -107,6 +107,7 @@ internal sealed class TrayAppContext : ApplicationContext
         _smtc = new SmtcBridge(_log, _serial);
         _configManager = new DeviceConfigManager(_serial, _log);
         _serial.HelloReceived += () => _smtc.ResendNowPlaying();
+        _serial.NowPlayingMeta = _smtc.CurrentMeta;
         _appState = AppState.Load();
         _manualPort = _appState.LastPort;
         _manualBleDeviceId = _appState.LastBleDeviceId;
@@ -853,10 +854,27 @@ internal static class DeviceLocator
     }
 }
 
+internal enum LinkPriority
+{
+    Control,
+    Bulk
+}
+
 internal sealed class SerialWorker
 {
     private const int BaudRate = 115200;
     private readonly object _sendLock = new();
+    // Two-class TX scheduler: control lines always go first, bulk lines are
+    // written one at a time so control never waits behind more than one chunk.
+    private readonly object _queueLock = new();
+    private readonly Queue<(string Text, long QueuedTicks)> _controlQueue = new();
+    // Owner 0 = 无主行（PONG/LRC/DIAG 等）；封面传输用 xfer id 标记自己的行
+    private readonly Queue<(string Text, int Owner)> _bulkQueue = new();
+    private readonly AutoResetEvent _txSignal = new(false);
+    private readonly Thread _writer;
+    private int _burstBulkLines;
+    private int _burstControlLines;
+    private double _burstWorstControlWaitMs;
     private readonly MMDeviceEnumerator _enumerator = new();
     private readonly Logger _log;
     private SerialPort? _port;
@@ -864,8 +882,14 @@ internal sealed class SerialWorker
     private volatile bool _running;
     private List<MMDevice> _renderDevices = new();
     private List<MMDevice> _captureDevices = new();
+    // Stable ids/versions for the device menus; guarded so list and delta lines keep their order.
+    private readonly object _deviceListLock = new();
+    private readonly EndpointList _speakerList = new("SPK");
+    private readonly EndpointList _micList = new("MIC");
+    private readonly EndpointWatcher _endpointWatcher;
     private bool _helloNotified;
     private DateTime _lastHelloAck = DateTime.MinValue;
+    private volatile string[] _deviceCaps = Array.Empty<string>();
     private TaskCompletionSource<string>? _cfgResponseWaiter;
     private readonly BleLinkClient _ble;
 
@@ -880,11 +904,47 @@ internal sealed class SerialWorker
         ? (_port?.PortName ?? "USB")
         : (IsBleOpen ? $"BLE:{_ble.ConnectedName}" : "Disconnected");
     public event Action? HelloReceived;
+    public event Action<int, int, uint>? CoverAckReceived;
+    public event Action<int, string>? CoverNakReceived;
+    public event Action<string, bool>? CoverCacheReply;
+    public event Action<int>? LyricTimelineAcked;
+    public event Action? CapsReceived;
+    public event Action? LinkAlive;
+    public event Action<uint, uint, uint>? TimeReplyReceived;
+    public LinkClock Clock { get; }
+    /// <summary>
+    /// 当前播放的标题/艺术家，用于 STATE 快照
+    /// </summary>
+    public Func<(string Title, string Artist)>? NowPlayingMeta { get; set; }
+    private const int StateLineMaxBytes = 1000;  // device line buffer is 1 KB
+    private const int ReplayMaxLines = 128;
+    // Session resumption: state lines carry "@seq " once SESSION is announced,
+    // and the last ReplayMaxLines of them are kept to replay after a drop.
+    private readonly uint _sessionId = (uint)Random.Shared.Next(1, int.MaxValue);
+    private uint _sessionSeq;
+    private bool _sessionActive;
+    private readonly Queue<(uint Seq, string Text)> _replay = new();
+    public event Action? SessionResumed;
+    private const int StateNameMaxChars = 48;
+
+    /// <summary>
+    /// 桥接端能力，在每个 HELLO / HELLO OK 之前发送（VOLSEQ：VOL SET 可带序号并回显）
+    /// </summary>
+    private const string BridgeCaps = "CAPS VOLSEQ";
+
+    /// <summary>
+    /// 设备在 HELLO 后通过 CAPS 行声明的可选协议特性（如 CLK）
+    /// </summary>
+    public bool HasCap(string cap) => Array.Exists(_deviceCaps, c => string.Equals(c, cap, StringComparison.OrdinalIgnoreCase));
 
     public SerialWorker(Logger log)
     {
         _log = log;
         _ble = new BleLinkClient(_log, HandleLine);
+        Clock = new LinkClock(this, _log);
+        _endpointWatcher = new EndpointWatcher(_enumerator, SyncDeviceLists);
+        _writer = new Thread(WriteLoop) { IsBackground = true, Name = "SongLedTx" };
+        _writer.Start();
     }
 
     public void Open(string portName)
@@ -893,6 +953,7 @@ internal sealed class SerialWorker
         Close();
         _helloNotified = false;
         _lastHelloAck = DateTime.MinValue;
+        _deviceCaps = Array.Empty<string>();
         _port = new SerialPort(portName, BaudRate)
         {
             NewLine = "\n",
@@ -917,6 +978,7 @@ internal sealed class SerialWorker
         _running = true;
         _reader = new Thread(ReadLoop) { IsBackground = true };
         _reader.Start();
+        SendLine(BridgeCaps);
         SendLine("HELLO");
         _log.Info($"已连接 {portName}");
     }
@@ -928,8 +990,10 @@ internal sealed class SerialWorker
         Close();
         _helloNotified = false;
         _lastHelloAck = DateTime.MinValue;
+        _deviceCaps = Array.Empty<string>();
         bool ok = await _ble.ConnectAsync(nameHint, deviceId);
         if (!ok) return false;
+        SendLine(BridgeCaps);
         SendLine("HELLO");
         _log.Info($"BLE connected: {_ble.ConnectedName}");
         return true;
@@ -943,6 +1007,11 @@ internal sealed class SerialWorker
     public void Close(bool fast = false)
     {
         _running = false;
+        lock (_queueLock)
+        {
+            _controlQueue.Clear();
+            _bulkQueue.Clear();
+        }
         try
         {
             _port?.Close();
@@ -1023,8 +1092,15 @@ internal sealed class SerialWorker
             line.StartsWith("APP ", StringComparison.OrdinalIgnoreCase))
         {
             _log.Info($"ESP32调试: {line}");
+            if (line == "APP LIVE") LinkAlive?.Invoke();
             return;
         }
+        if (line.StartsWith("HELLO RESUME ", StringComparison.OrdinalIgnoreCase))
+        {
+            if (TryResume(line)) return;
+            SendLine("RESUME FAIL");
+            _lastHelloAck = DateTime.MinValue;  // answer as a fresh HELLO right away
+        }
         if (line.StartsWith("HELLO", StringComparison.OrdinalIgnoreCase))
         {
             _log.Info("??HELLO???????");
@@ -1032,7 +1108,9 @@ internal sealed class SerialWorker
             if (now - _lastHelloAck > TimeSpan.FromMilliseconds(500))
             {
                 _lastHelloAck = now;
+                SendLine(BridgeCaps);
                 SendLine("HELLO OK");
+                if (HasCap("RESUME")) StartSession();
                 SendVolumeState();
             }
             if (!_helloNotified)
@@ -1043,6 +1121,76 @@ internal sealed class SerialWorker
             // ?????????????ESP32????
             return;
         }
+        if (line.StartsWith("CAPS", StringComparison.OrdinalIgnoreCase))
+        {
+            _deviceCaps = line.Split(' ', StringSplitOptions.RemoveEmptyEntries)[1..];
+            _log.Info($"ESP32能力: {string.Join(',', _deviceCaps)}");
+            CapsReceived?.Invoke();
+            return;
+        }
+        if (line.StartsWith("PING ", StringComparison.Ordinal))
+        {
+            // Device link probe: echo at bulk priority so it never delays control lines.
+            SendBulkLine("PONG " + line.Substring(5));
+            return;
+        }
+        if (line.StartsWith("TIME RSP ", StringComparison.OrdinalIgnoreCase))
+        {
+            var parts = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+            if (parts.Length >= 5 &&
+                uint.TryParse(parts[2], out uint t1) &&
+                uint.TryParse(parts[3], out uint t2) &&
+                uint.TryParse(parts[4], out uint t3))
+            {
+                TimeReplyReceived?.Invoke(t1, t2, t3);
+            }
+            return;
+        }
+        if (line.StartsWith("COV ACK ", StringComparison.OrdinalIgnoreCase))
+        {
+            var parts = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+            if (parts.Length >= 5 &&
+                int.TryParse(parts[2], out int xfer) &&
+                int.TryParse(parts[3], out int cum) &&
+                uint.TryParse(parts[4], System.Globalization.NumberStyles.HexNumber, null, out uint sack))
+            {
+                CoverAckReceived?.Invoke(xfer, cum, sack);
+            }
+            return;
+        }
+        if (line.StartsWith("COV HIT ", StringComparison.OrdinalIgnoreCase) ||
+            line.StartsWith("COV MISS ", StringComparison.OrdinalIgnoreCase))
+        {
+            var parts = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+            if (parts.Length >= 3)
+            {
+                CoverCacheReply?.Invoke(parts[2], parts[1].Equals("HIT", StringComparison.OrdinalIgnoreCase));
+            }
+            return;
+        }
+        if (line.StartsWith("LRC OK ", StringComparison.OrdinalIgnoreCase))
+        {
+            var parts = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+            if (parts.Length >= 3 && int.TryParse(parts[2], out int count))
+            {
+                LyricTimelineAcked?.Invoke(count);
+            }
+            return;
+        }
+        if (line.StartsWith("COV NAK ", StringComparison.OrdinalIgnoreCase))
+        {
+            var parts = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+            if (parts.Length >= 3 && int.TryParse(parts[2], out int xfer))
+            {
+                CoverNakReceived?.Invoke(xfer, parts.Length >= 4 ? parts[3] : string.Empty);
+            }
+            return;
+        }
+        if (line.Equals("STATE GET", StringComparison.OrdinalIgnoreCase))
+        {
+            SendStateSnapshot();
+            return;
+        }
         if (line.Equals("VOL GET", StringComparison.OrdinalIgnoreCase))
         {
             SendVolumeState();
@@ -1050,10 +1198,12 @@ internal sealed class SerialWorker
         }
         if (line.StartsWith("VOL SET", StringComparison.OrdinalIgnoreCase))
         {
-            int value = ParseInt(line, 7);
+            // VOL SET <v> [seq]：回显带上序号，设备据此丢弃过期应答
+            var parts = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+            int value = parts.Length > 2 && int.TryParse(parts[2], out int v) ? v : 0;
             value = Math.Clamp(value, 0, 100);
             SetVolume(value);
-            SendVolumeState();
+            SendVolumeState(parts.Length > 3 && uint.TryParse(parts[3], out uint seq) ? seq : null);
             return;
         }
         if (line.Equals("MUTE", StringComparison.OrdinalIgnoreCase))
@@ -1125,7 +1275,195 @@ internal sealed class SerialWorker
         return 0;
     }
 
-    public void SendLine(string text)
+    public void SendLine(string text) => SendLine(text, LinkPriority.Control);
+
+    public void SendBulkLine(string text) => SendBulkLine(text, 0);
+
+    public void SendBulkLine(string text, int owner)
+    {
+        lock (_queueLock)
+        {
+            _bulkQueue.Enqueue((text, owner));
+        }
+        _txSignal.Set();
+    }
+
+    /// <summary>
+    /// 丢弃某个封面传输尚未发出的 bulk 行，其余 bulk 行（LRC、PONG 等）保持原顺序
+    /// </summary>
+    public void ClearBulk(int owner)
+    {
+        lock (_queueLock)
+        {
+            int count = _bulkQueue.Count;
+            for (int i = 0; i < count; i++)
+            {
+                var item = _bulkQueue.Dequeue();
+                if (item.Owner != owner) _bulkQueue.Enqueue(item);
+            }
+        }
+    }
+
+    public void SendLine(string text, LinkPriority priority)
+    {
+        lock (_queueLock)
+        {
+            if (priority == LinkPriority.Bulk)
+            {
+                _bulkQueue.Enqueue((text, 0));
+            }
+            else
+            {
+                if (_sessionActive && IsSequenced(text))
+                {
+                    text = $"@{++_sessionSeq} {text}";
+                    _replay.Enqueue((_sessionSeq, text));
+                    if (_replay.Count > ReplayMaxLines) _replay.Dequeue();
+                }
+                _controlQueue.Enqueue((text, Stopwatch.GetTimestamp()));
+            }
+        }
+        _txSignal.Set();
+    }
+
+    /// <summary>
+    /// 改变设备状态、需要断线重放的控制行（NP PROG 不在其中：恢复后立即重发最新进度）
+    /// </summary>
+    private static bool IsSequenced(string text)
+    {
+        return text.StartsWith("VOL ", StringComparison.Ordinal) ||
+               text.StartsWith("MUTE ", StringComparison.Ordinal) ||
+               text.StartsWith("SPK ", StringComparison.Ordinal) ||
+               text.StartsWith("MIC ", StringComparison.Ordinal) ||
+               text.StartsWith("NP META", StringComparison.Ordinal) ||
+               text.StartsWith("NP CLR", StringComparison.Ordinal) ||
+               text.StartsWith("LRC CUR", StringComparison.Ordinal) ||
+               text.StartsWith("LRC NXT", StringComparison.Ordinal) ||
+               text.StartsWith("LRC CLR", StringComparison.Ordinal) ||
+               text.StartsWith("STATE ", StringComparison.Ordinal);
+    }
+
+    /// <summary>
+    /// 同一键只有最后一条有意义（音量、当前设备、元数据、当前歌词）；列表条目全部保留
+    /// </summary>
+    private static string? ReplayKey(string text)
+    {
+        int body = text.IndexOf(' ') + 1;
+        string line = text[body..];
+        if (line.StartsWith("VOL ", StringComparison.Ordinal)) return "VOL";
+        if (line.StartsWith("MUTE ", StringComparison.Ordinal)) return "MUTE";
+        foreach (var key in new[] { "SPK CUR", "MIC CUR", "NP META", "LRC CUR", "LRC NXT", "STATE" })
+        {
+            if (line.StartsWith(key, StringComparison.Ordinal)) return key;
+        }
+        return null;
+    }
+
+    private void StartSession()
+    {
+        lock (_queueLock)
+        {
+            _sessionActive = true;
+            _replay.Clear();
+            _controlQueue.Enqueue(($"SESSION {_sessionId:X8} {_sessionSeq}", Stopwatch.GetTimestamp()));
+        }
+        _txSignal.Set();
+    }
+
+    /// <summary>
+    /// HELLO RESUME id lastSeq：同一会话且重放缓冲覆盖缺口时只补发缺失的行
+    /// </summary>
+    private bool TryResume(string line)
+    {
+        var parts = line.Split(' ', StringSplitOptions.RemoveEmptyEntries);
+        if (parts.Length < 4 ||
+            !uint.TryParse(parts[2], System.Globalization.NumberStyles.HexNumber, null, out uint id) ||
+            !uint.TryParse(parts[3], out uint lastSeq))
+        {
+            return false;
+        }
+        var sw = Stopwatch.StartNew();
+        var missed = new List<string>();
+        uint target;
+        lock (_queueLock)
+        {
+            target = _sessionSeq;
+            uint oldest = _replay.Count > 0 ? _replay.Peek().Seq : _sessionSeq + 1;
+            if (!_sessionActive || id != _sessionId || lastSeq > _sessionSeq || lastSeq + 1 < oldest)
+            {
+                _log.Info($"Session resume refused: id={parts[2]} seq={lastSeq} (ours {_sessionId:X8} seq={_sessionSeq}, buffer from {oldest})");
+                return false;
+            }
+            var latest = new HashSet<string>();
+            foreach (var (seq, text) in _replay.Reverse())
+            {
+                if (seq <= lastSeq) break;
+                string? key = ReplayKey(text);
+                if (key != null && !latest.Add(key)) continue;  // superseded later on
+                missed.Add(text);
+            }
+            missed.Reverse();
+            _controlQueue.Enqueue(($"RESUME OK {missed.Count} {target}", Stopwatch.GetTimestamp()));
+            foreach (var text in missed) _controlQueue.Enqueue((text, Stopwatch.GetTimestamp()));
+        }
+        _txSignal.Set();
+        _helloNotified = true;
+        int bytes = missed.Sum(t => Encoding.UTF8.GetByteCount(t) + 1);
+        string? full = BuildStateSnapshot(commit: false);
+        int fullBytes = full == null ? 0 : Encoding.UTF8.GetByteCount(full) + 1;
+        _log.Info($"Session resumed at seq {lastSeq}->{target}: {missed.Count} lines, {bytes} B replayed in {sw.ElapsedMilliseconds} ms (STATE resync would be {fullBytes} B + now-playing)");
+        SessionResumed?.Invoke();
+        return true;
+    }
+
+    private void WriteLoop()
+    {
+        while (true)
+        {
+            _txSignal.WaitOne();
+            while (TryDequeue(out string text))
+            {
+                if (text == LinkClock.RequestLine) text = $"{text} {LinkClock.NowMs()}";
+                WriteNow(text);
+            }
+        }
+    }
+
+    private bool TryDequeue(out string text)
+    {
+        lock (_queueLock)
+        {
+            if (_controlQueue.Count > 0)
+            {
+                var item = _controlQueue.Dequeue();
+                if (_burstBulkLines > 0)
+                {
+                    double waitMs = (Stopwatch.GetTimestamp() - item.QueuedTicks) * 1000.0 / Stopwatch.Frequency;
+                    _burstControlLines++;
+                    if (waitMs > _burstWorstControlWaitMs) _burstWorstControlWaitMs = waitMs;
+                }
+                text = item.Text;
+                return true;
+            }
+            if (_bulkQueue.Count > 0)
+            {
+                _burstBulkLines++;
+                text = _bulkQueue.Dequeue().Text;
+                return true;
+            }
+            if (_burstBulkLines > 0)
+            {
+                _log.Info($"Link bulk burst: {_burstBulkLines} lines, {_burstControlLines} control, worst control wait {_burstWorstControlWaitMs:F1} ms");
+                _burstBulkLines = 0;
+                _burstControlLines = 0;
+                _burstWorstControlWaitMs = 0;
+            }
+            text = string.Empty;
+            return false;
+        }
+    }
+
+    private void WriteNow(string text)
     {
         lock (_sendLock)
         {
@@ -1144,7 +1482,15 @@ internal sealed class SerialWorker
 
             if (IsBleOpen)
             {
-                _ = _ble.SendLineAsync(text);
+                try
+                {
+                    // Wait so BLE writes leave in scheduler order.
+                    _ble.SendLineAsync(text).Wait(1000);
+                }
+                catch (Exception ex)
+                {
+                    _log.Info($"BLE send failed: {ex.Message}");
+                }
             }
         }
     }
@@ -1211,7 +1557,7 @@ internal sealed class SerialWorker
         }
     }
 
-    private void SendVolumeState()
+    private void SendVolumeState(uint? seq = null)
     {
         try
         {
@@ -1219,7 +1565,7 @@ internal sealed class SerialWorker
             if (dev == null) return;
             int vol = (int)Math.Round(dev.AudioEndpointVolume.MasterVolumeLevelScalar * 100.0);
             int mute = dev.AudioEndpointVolume.Mute ? 1 : 0;
-            SendLine($"VOL {vol}");
+            SendLine(seq.HasValue ? $"VOL {vol} {seq.Value}" : $"VOL {vol}");
             SendLine($"MUTE {mute}");
         }
         catch (Exception ex)
@@ -1228,6 +1574,100 @@ internal sealed class SerialWorker
         }
     }
 
+    /// <summary>
+    /// 连接后一次性同步：音量、静音、输出/输入设备列表及当前项、正在播放信息
+    /// STATE vol mute spkCur spkN micCur micN\tspk...\tmic...[\ttitle\tartist]
+    /// 超出设备行缓冲时退回旧的分步消息
+    /// </summary>
+    private void SendStateSnapshot()
+    {
+        var sw = Stopwatch.StartNew();
+        string? state = BuildStateSnapshot();
+        if (state == null) return;
+        int bytes = Encoding.UTF8.GetByteCount(state);
+        if (bytes > StateLineMaxBytes)
+        {
+            _log.Info($"STATE snapshot too large ({bytes} B), sending piecemeal");
+            SendVolumeState();
+            SendSpeakerList();
+            SendMicrophoneList();
+            return;
+        }
+        SendLine(state);
+        _log.Info($"STATE snapshot: {bytes} B, {_renderDevices.Count} spk, {_captureDevices.Count} mic, built in {sw.ElapsedMilliseconds} ms");
+    }
+
+    /// <summary>
+    /// STATE vol mute spkCur spkN micCur micN\tspk...\tmic...[\ttitle\tartist]
+    /// commit=false 只用于估算大小：不刷新设备缓存，也不重新编号端点列表、不改版本号
+    /// </summary>
+    private string? BuildStateSnapshot(bool commit = true)
+    {
+        try
+        {
+            var dev = GetDefaultDevice();
+            int vol = dev == null ? 0 : (int)Math.Round(dev.AudioEndpointVolume.MasterVolumeLevelScalar * 100.0);
+            int mute = dev != null && dev.AudioEndpointVolume.Mute ? 1 : 0;
+            var capture = GetDefaultCaptureDevice();
+            int spkCur, micCur;
+            ushort spkVer, micVer;
+            List<MMDevice> render, captures;
+            lock (_deviceListLock)
+            {
+                if (commit)
+                {
+                    RefreshRenderDevices();
+                    RefreshCaptureDevices();
+                    _speakerList.Reset(_renderDevices, Sanitize);
+                    _micList.Reset(_captureDevices, Sanitize);
+                    spkCur = dev == null ? -1 : _speakerList.IdFor(dev.ID);
+                    micCur = capture == null ? -1 : _micList.IdFor(capture.ID);
+                    _speakerList.CurrentId = spkCur;
+                    _micList.CurrentId = micCur;
+                    spkVer = _speakerList.Version;
+                    micVer = _micList.Version;
+                    render = _renderDevices;
+                    captures = _captureDevices;
+                }
+                else
+                {
+                    // 设备仍按现有编号解析 SPK SET / MIC SET，这里不能动列表
+                    render = _enumerator.EnumerateAudioEndPoints(DataFlow.Render, DeviceState.Active).ToList();
+                    captures = _enumerator.EnumerateAudioEndPoints(DataFlow.Capture, DeviceState.Active).ToList();
+                    string? spkId = dev?.ID;
+                    string? micId = capture?.ID;
+                    spkCur = render.FindIndex(d => d.ID == spkId);
+                    micCur = captures.FindIndex(d => d.ID == micId);
+                    spkVer = _speakerList.Version;
+                    micVer = _micList.Version;
+                }
+            }
+
+            var sb = new StringBuilder();
+            sb.Append($"STATE {vol} {mute} {spkCur} {render.Count} {micCur} {captures.Count}");
+            if (HasCap("DEVLIST")) sb.Append($" {spkVer} {micVer}");
+            foreach (var d in render) sb.Append('\t').Append(StateName(d.FriendlyName));
+            foreach (var d in captures) sb.Append('\t').Append(StateName(d.FriendlyName));
+            var meta = NowPlayingMeta?.Invoke();
+            if (meta is { } m && (m.Title.Length > 0 || m.Artist.Length > 0))
+            {
+                sb.Append('\t').Append(m.Title).Append('\t').Append(m.Artist);
+            }
+            return sb.ToString();
+        }
+        catch (Exception ex)
+        {
+            _log.Info($"STATE snapshot failed: {ex.Message}");
+            return null;
+        }
+    }
+
+    private static string StateName(string name)
+    {
+        string clean = Sanitize(name).Replace("\t", " ");
+        return clean.Length > StateNameMaxChars ? clean[..StateNameMaxChars] : clean;
+    }
+
     private void SetVolume(int value)
     {
         try
@@ -1271,18 +1711,21 @@ internal sealed class SerialWorker
         try
         {
             _log.Info("开始发送设备列表");
-            RefreshRenderDevices();
-            _log.Info($"枚举到 {_renderDevices.Count} 个设备");
-            SendLine("SPK BEGIN");
-            for (int i = 0; i < _renderDevices.Count; i++)
+            lock (_deviceListLock)
             {
-                string name = Sanitize(_renderDevices[i].FriendlyName);
-                _log.Info($"发送设备 {i}: {name}");
-                SendLine($"SPK ITEM {i} {name}");
+                RefreshRenderDevices();
+                _log.Info($"枚举到 {_renderDevices.Count} 个设备");
+                _speakerList.Reset(_renderDevices, Sanitize);
+                SendLine(HasCap("DEVLIST") ? $"SPK BEGIN {_speakerList.Version}" : "SPK BEGIN");
+                foreach (var item in _speakerList.Items)
+                {
+                    _log.Info($"发送设备 {item.Id}: {item.Name}");
+                    SendLine($"SPK ITEM {item.Id} {item.Name}");
+                }
+                SendLine("SPK END");
+                _log.Info("设备列表发送完成");
+                SendCurrentSpeaker();
             }
-            SendLine("SPK END");
-            _log.Info("设备列表发送完成");
-            SendCurrentSpeaker();
         }
         catch (Exception ex)
         {
@@ -1295,21 +1738,22 @@ internal sealed class SerialWorker
     {
         var dev = GetDefaultDevice();
         if (dev == null) return;
-        // 使用已缓存的设备列表，避免重复枚举
-        if (_renderDevices.Count == 0) RefreshRenderDevices();
-        int index = _renderDevices.FindIndex(d => d.ID == dev.ID);
-        if (index >= 0)
+        // 使用已编号的设备列表，避免重复枚举
+        lock (_deviceListLock)
         {
-            SendLine($"SPK CUR {index}");
+            int id = _speakerList.IdFor(dev.ID);
+            if (id >= 0)
+            {
+                _speakerList.CurrentId = id;
+                SendLine($"SPK CUR {id}");
+            }
         }
     }
 
     private void SetDefaultSpeaker(int index)
     {
-        // 使用已缓存的设备列表
-        if (_renderDevices.Count == 0) RefreshRenderDevices();
-        if (index < 0 || index >= _renderDevices.Count) return;
-        string id = _renderDevices[index].ID;
+        string? id = EndpointForId(_speakerList, index, RefreshRenderDevices, () => _renderDevices);
+        if (id == null) return;
         try
         {
             var policy = new PolicyConfigClient() as IPolicyConfig;
@@ -1328,16 +1772,19 @@ internal sealed class SerialWorker
         try
         {
             _log.Info("寮€濮嬪彂閫侀害鍏嬮鍒楄〃");
-            RefreshCaptureDevices();
-            _log.Info($"鏋氫妇鍒?{_captureDevices.Count} 涓害鍏嬮");
-            SendLine("MIC BEGIN");
-            for (int i = 0; i < _captureDevices.Count; i++)
+            lock (_deviceListLock)
             {
-                string name = Sanitize(_captureDevices[i].FriendlyName);
-                SendLine($"MIC ITEM {i} {name}");
+                RefreshCaptureDevices();
+                _log.Info($"鏋氫妇鍒?{_captureDevices.Count} 涓害鍏嬮");
+                _micList.Reset(_captureDevices, Sanitize);
+                SendLine(HasCap("DEVLIST") ? $"MIC BEGIN {_micList.Version}" : "MIC BEGIN");
+                foreach (var item in _micList.Items)
+                {
+                    SendLine($"MIC ITEM {item.Id} {item.Name}");
+                }
+                SendLine("MIC END");
+                SendCurrentMicrophone();
             }
-            SendLine("MIC END");
-            SendCurrentMicrophone();
         }
         catch (Exception ex)
         {
@@ -1349,19 +1796,21 @@ internal sealed class SerialWorker
     {
         var dev = GetDefaultCaptureDevice();
         if (dev == null) return;
-        if (_captureDevices.Count == 0) RefreshCaptureDevices();
-        int index = _captureDevices.FindIndex(d => d.ID == dev.ID);
-        if (index >= 0)
+        lock (_deviceListLock)
         {
-            SendLine($"MIC CUR {index}");
+            int id = _micList.IdFor(dev.ID);
+            if (id >= 0)
+            {
+                _micList.CurrentId = id;
+                SendLine($"MIC CUR {id}");
+            }
         }
     }
 
     private void SetDefaultMicrophone(int index)
     {
-        if (_captureDevices.Count == 0) RefreshCaptureDevices();
-        if (index < 0 || index >= _captureDevices.Count) return;
-        string id = _captureDevices[index].ID;
+        string? id = EndpointForId(_micList, index, RefreshCaptureDevices, () => _captureDevices);
+        if (id == null) return;
         try
         {
             var policy = new PolicyConfigClient() as IPolicyConfig;
@@ -1375,6 +1824,75 @@ internal sealed class SerialWorker
         }
     }
 
+    /// <summary>
+    /// 设备回传的编号换成端点 ID；本进程还没发过列表时（如 PC 端重启）按旧的序号规则编号
+    /// </summary>
+    private string? EndpointForId(EndpointList list, int id, Action refresh, Func<List<MMDevice>> devices)
+    {
+        lock (_deviceListLock)
+        {
+            if (list.Version == 0)
+            {
+                refresh();
+                list.Reset(devices(), Sanitize);
+            }
+            return list.EndpointFor(id);
+        }
+    }
+
+    /// <summary>
+    /// 端点变化（插拔、改名、默认设备切换）后把差异推给设备：
+    /// 支持 DEVLIST 的设备收到 ADD/DEL/REN/CUR 增量，旧固件仍然整表重发
+    /// </summary>
+    private void SyncDeviceLists()
+    {
+        if (!IsConnected) return;
+        try
+        {
+            lock (_deviceListLock)
+            {
+                SyncDeviceList(_speakerList, DataFlow.Render, RefreshRenderDevices, () => _renderDevices, SendSpeakerList);
+                SyncDeviceList(_micList, DataFlow.Capture, RefreshCaptureDevices, () => _captureDevices, SendMicrophoneList);
+            }
+        }
+        catch (Exception ex)
+        {
+            _log.Info($"Device list sync failed: {ex.Message}");
+        }
+    }
+
+    private void SyncDeviceList(EndpointList list, DataFlow flow, Action refresh, Func<List<MMDevice>> devices, Action sendFull)
+    {
+        if (list.Version == 0) return;  // the device has not asked for this list yet
+        if (!HasCap("DEVLIST"))
+        {
+            sendFull();
+            return;
+        }
+        refresh();
+        var lines = list.Diff(devices(), Sanitize);
+        foreach (var line in lines) SendLine(line);
+
+        MMDevice? current = null;
+        try
+        {
+            current = _enumerator.GetDefaultAudioEndpoint(flow, Role.Multimedia);
+        }
+        catch
+        {
+        }
+        int id = current == null ? -1 : list.IdFor(current.ID);
+        if (id >= 0 && id != list.CurrentId)
+        {
+            list.CurrentId = id;
+            SendLine($"{list.Tag} CUR {id}");
+        }
+        if (lines.Count > 0)
+        {
+            _log.Info($"{list.Tag} delta v{list.Version}: {lines.Count} line(s) for {list.Items.Count} devices instead of a full list");
+        }
+    }
+
     private static string Sanitize(string text)
     {
         return text.Replace("\r", " ").Replace("\n", " ").Trim();
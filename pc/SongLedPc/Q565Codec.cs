@@ -0,0 +1,131 @@
+using System;
+using System.Collections.Generic;
+
+namespace SongLedPc;
+
+/// <summary>
+/// Q565：QOI 风格的 RGB565 无损编码（与固件 src/cover_codec.cpp 对应）
+/// 00iiiiii INDEX / 01rrggbb DIFF / 10gggggg rrrrbbbb LUMA / 11rrrrrr RUN(1..62) / FE hi lo RGB
+/// </summary>
+internal static class Q565Codec
+{
+    private const byte OpIndex = 0x00;
+    private const byte OpDiff = 0x40;
+    private const byte OpLuma = 0x80;
+    private const byte OpRun = 0xC0;
+    private const byte OpRgb = 0xFE;
+    private const int MaxRun = 62;
+
+    public static byte[] Encode(ushort[] pixels)
+    {
+        var output = new List<byte>(pixels.Length);
+        var index = new ushort[64];
+        ushort prev = 0;
+        int run = 0;
+
+        for (int i = 0; i < pixels.Length; i++)
+        {
+            ushort px = pixels[i];
+            if (px == prev)
+            {
+                run++;
+                if (run == MaxRun || i == pixels.Length - 1)
+                {
+                    output.Add((byte)(OpRun | (run - 1)));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0)
+            {
+                output.Add((byte)(OpRun | (run - 1)));
+                run = 0;
+            }
+
+            int hash = Hash(px);
+            if (index[hash] == px)
+            {
+                output.Add((byte)(OpIndex | hash));
+            }
+            else
+            {
+                index[hash] = px;
+                int dr = Wrap(((px >> 11) & 0x1F) - ((prev >> 11) & 0x1F), 32);
+                int dg = Wrap(((px >> 5) & 0x3F) - ((prev >> 5) & 0x3F), 64);
+                int db = Wrap((px & 0x1F) - (prev & 0x1F), 32);
+                int drdg = dr - dg;
+                int dbdg = db - dg;
+                if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+                {
+                    output.Add((byte)(OpDiff | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+                }
+                else if (drdg >= -8 && drdg <= 7 && dbdg >= -8 && dbdg <= 7)
+                {
+                    output.Add((byte)(OpLuma | (dg + 32)));
+                    output.Add((byte)(((drdg + 8) << 4) | (dbdg + 8)));
+                }
+                else
+                {
+                    output.Add(OpRgb);
+                    output.Add((byte)(px >> 8));
+                    output.Add((byte)(px & 0xFF));
+                }
+            }
+            prev = px;
+        }
+        return output.ToArray();
+    }
+
+    /// <summary>
+    /// 原始 RGB565 大端字节流（RAW 格式）
+    /// </summary>
+    public static byte[] Raw(ushort[] pixels)
+    {
+        var bytes = new byte[pixels.Length * 2];
+        for (int i = 0; i < pixels.Length; i++)
+        {
+            bytes[i * 2] = (byte)(pixels[i] >> 8);
+            bytes[i * 2 + 1] = (byte)(pixels[i] & 0xFF);
+        }
+        return bytes;
+    }
+
+    /// <summary>
+    /// Adam7 交错顺序：7 遍由粗到细，设备端收到第一遍即可显示预览
+    /// </summary>
+    public static ushort[] Adam7Order(ushort[] pixels, int width, int height)
+    {
+        var ordered = new ushort[pixels.Length];
+        int di = 0;
+        foreach (var (x0, y0, dx, dy) in Adam7Passes)
+        {
+            for (int y = y0; y < height; y += dy)
+            {
+                for (int x = x0; x < width; x += dx)
+                {
+                    ordered[di++] = pixels[y * width + x];
+                }
+            }
+        }
+        return ordered;
+    }
+
+    private static readonly (int X0, int Y0, int Dx, int Dy)[] Adam7Passes =
+    {
+        (0, 0, 8, 8), (4, 0, 8, 8), (0, 4, 4, 8), (2, 0, 4, 4), (0, 2, 2, 4), (1, 0, 2, 2), (0, 1, 1, 2)
+    };
+
+    private static int Hash(ushort px)
+    {
+        int r = (px >> 11) & 0x1F;
+        int g = (px >> 5) & 0x3F;
+        int b = px & 0x1F;
+        return (r * 3 + g * 5 + b * 7) & 63;
+    }
+
+    private static int Wrap(int delta, int range)
+    {
+        int half = range / 2;
+        return ((delta + half) & (range - 1)) - half;
+    }
+}
@@ -26,19 +26,35 @@ internal sealed class SmtcBridge : IDisposable
     private List<LyricEntry> _lyrics = new();
     private long _lastPositionMs = -1;
     private int _lastLyricIndex = -2;
+    // The device acked the uploaded timeline and switches lines itself.
+    private volatile bool _deviceLyrics;
     private DateTime _lastSessionLog = DateTime.MinValue;
     private DateTime _lastProgSent = DateTime.MinValue;
     private DateTime _lastMetaSent = DateTime.MinValue;
     private string _lastMetaKey = string.Empty;
     private long _lastProgPos = -1;
     private long _lastProgDur = -1;
+    private bool _lastProgPlaying;
+    private double _lastProgRate = 1.0;
+    // Playback state from SMTC; the device clock (CAPS CLK) extrapolates with it.
+    private volatile bool _playing;
+    private double _playbackRate = 1.0;
+    private const int ClockSeekThresholdMs = 750;
+    private const int ClockHeartbeatMs = 5000;
+    private const int PositionStaleMaxMs = 30000;
     private readonly SemaphoreSlim _coverLock = new(1, 1);
-    private int _coverSending;
+    private readonly CoverTransfer _coverTransfer;
+    private CancellationTokenSource? _coverCts;
     private CancellationTokenSource? _lyricCts;
     private bool _disposed;
     private string _lastTitle = string.Empty;
     private string _lastArtist = string.Empty;
-    private ushort[]? _lastCover;
+    private const int CoverSize = 40;
+    private const float JpegQuality = 0.85f;
+    private CoverFrame? _lastCover;
+    private bool _jpegCovers = true;
+    private bool _interlacedCovers = true;
+    private bool _coverCacheQueries = true;
     private readonly System.Threading.Timer _timelineTimer;
     private int _pollingTimeline;
     private DateTime _lastTimelineWarn = DateTime.MinValue;
@@ -47,6 +63,9 @@ internal sealed class SmtcBridge : IDisposable
     {
         _log = log;
         _serial = serial;
+        _coverTransfer = new CoverTransfer(serial, log);
+        _serial.LyricTimelineAcked += OnLyricTimelineAcked;
+        _serial.SessionResumed += OnSessionResumed;
         _http = new HttpClient
         {
             Timeout = TimeSpan.FromSeconds(6)
@@ -262,6 +281,7 @@ internal sealed class SmtcBridge : IDisposable
                 _log.Info($"SMTC track: {title} - {artist} ({ncmId ?? "no-id"})");
                 _lastTitle = title;
                 _lastArtist = artist;
+                AbortCover();
                 ResetLyrics();
                 _currentNcmId = null;
                 if (props.Thumbnail != null)
@@ -319,6 +339,16 @@ internal sealed class SmtcBridge : IDisposable
                 _serial.SendLine("LRC CLR");
                 _serial.SendLine("NP CLR");
             }
+            bool playing = info.PlaybackStatus == GlobalSystemMediaTransportControlsSessionPlaybackStatus.Playing;
+            double rate = info.PlaybackRate is double r && r > 0 ? r : 1.0;
+            bool changed = playing != _playing || rate != _playbackRate;
+            _playing = playing;
+            _playbackRate = rate;
+            if (changed && _serial.HasCap("CLK"))
+            {
+                // Pause/resume must reach the device clock now, not at the next poll.
+                return UpdateTimelineAsync(session);
+            }
         }
         catch (Exception ex)
         {
@@ -336,6 +366,16 @@ internal sealed class SmtcBridge : IDisposable
             var endMs = (long)Math.Max(0, timeline.EndTime.TotalMilliseconds);
             var maxSeekMs = (long)Math.Max(0, timeline.MaxSeekTime.TotalMilliseconds);
             var durMs = Math.Max(endMs, maxSeekMs);
+            if (_playing)
+            {
+                // Many players refresh Position only every few seconds; advance it to now.
+                double staleMs = (DateTimeOffset.Now - timeline.LastUpdatedTime).TotalMilliseconds;
+                if (staleMs > 0 && staleMs < PositionStaleMaxMs)
+                {
+                    posMs += (long)(staleMs * _playbackRate);
+                    if (durMs > 0) posMs = Math.Min(posMs, durMs);
+                }
+            }
             if (durMs <= 0 && DateTime.UtcNow - _lastTimelineWarn > TimeSpan.FromSeconds(10))
             {
                 _lastTimelineWarn = DateTime.UtcNow;
@@ -343,10 +383,8 @@ internal sealed class SmtcBridge : IDisposable
             }
             _lastPositionMs = posMs;
             UpdateLyricByPosition(posMs);
-            if (Volatile.Read(ref _coverSending) == 0)
-            {
-                MaybeSendProgress(posMs, durMs);
-            }
+            // Progress is a control line; the link scheduler keeps it ahead of cover chunks.
+            MaybeSendProgress(posMs, durMs);
         }
         catch (Exception ex)
         {
@@ -362,6 +400,7 @@ internal sealed class SmtcBridge : IDisposable
             _lyrics = new List<LyricEntry>();
             _lastLyricIndex = -2;
         }
+        _deviceLyrics = false;
         _serial.SendLine("LRC CLR");
         _serial.SendLine("NP CLR");
         _lastCover = null;
@@ -406,6 +445,7 @@ internal sealed class SmtcBridge : IDisposable
                 _lastLyricIndex = -2;
             }
             _log.Info($"Lyric loaded: {entries.Count} lines");
+            UploadLyricTimeline(entries);
             UpdateLyricByPosition(_lastPositionMs);
         }
         catch (OperationCanceledException)
@@ -436,6 +476,11 @@ internal sealed class SmtcBridge : IDisposable
 
     private void MaybeSendProgress(long posMs, long durMs)
     {
+        if (durMs > 0 && _serial.HasCap("CLK"))
+        {
+            MaybeSendClockProgress(posMs, durMs);
+            return;
+        }
         if (durMs <= 0)
         {
             if (Math.Abs(posMs - _lastProgPos) < 200 &&
@@ -458,6 +503,7 @@ internal sealed class SmtcBridge : IDisposable
 
         _lastProgPos = posMs;
         _lastProgDur = durMs;
+        _lastProgRate = 0;  // the first clock-format update after CAPS CLK must go out
         _lastProgSent = DateTime.UtcNow;
         if (DateTime.UtcNow.Second % 5 == 0)
         {
@@ -466,6 +512,39 @@ internal sealed class SmtcBridge : IDisposable
         _serial.SendLine($"NP PROG {posMs} {durMs}");
     }
 
+    /// <summary>
+    /// 设备自行推算进度：仅在播放/暂停、倍速、时长变化、跳转（偏离预测）或 5 秒心跳时发送
+    /// NP PROG pos dur P|S ratePct [sampledMs]（设备支持 TIME 时附带采样时刻，设备据此补偿在途时间）
+    /// </summary>
+    private void MaybeSendClockProgress(long posMs, long durMs)
+    {
+        var now = DateTime.UtcNow;
+        bool playing = _playing;
+        double rate = _playbackRate;
+        double sinceMs = (now - _lastProgSent).TotalMilliseconds;
+        long predicted = _lastProgPlaying ? _lastProgPos + (long)(sinceMs * _lastProgRate) : _lastProgPos;
+        bool seeked = Math.Abs(posMs - predicted) > ClockSeekThresholdMs;
+        if (!seeked && playing == _lastProgPlaying && rate == _lastProgRate && durMs == _lastProgDur &&
+            sinceMs < ClockHeartbeatMs)
+        {
+            return;
+        }
+
+        _lastProgPos = posMs;
+        _lastProgDur = durMs;
+        _lastProgPlaying = playing;
+        _lastProgRate = rate;
+        _lastProgSent = now;
+        int ratePct = (int)Math.Round(rate * 100);
+        if (seeked)
+        {
+            _log.Info($"Send NP PROG (seek): pos={posMs} predicted={predicted} dur={durMs}");
+        }
+        string line = $"NP PROG {posMs} {durMs} {(playing ? 'P' : 'S')} {ratePct}";
+        if (_serial.HasCap("TIME")) line += $" {LinkClock.NowMs()}";
+        _serial.SendLine(line);
+    }
+
     private static string SanitizeField(string text)
     {
         if (string.IsNullOrEmpty(text)) return string.Empty;
@@ -479,48 +558,178 @@ internal sealed class SmtcBridge : IDisposable
             _log.Info("SMTC cover skipped: thumbnail null");
             return;
         }
-        if (!await _coverLock.WaitAsync(0)) return;
-        Interlocked.Exchange(ref _coverSending, 1);
+        var cts = BeginCoverSend();
+        try
+        {
+            await _coverLock.WaitAsync(cts.Token);
+        }
+        catch (OperationCanceledException)
+        {
+            return;
+        }
         try
         {
-            var pixels = await DecodeCoverAsync(props.Thumbnail);
-            if (pixels == null) return;
-            _lastCover = pixels;
+            var frame = await DecodeCoverAsync(props.Thumbnail);
+            if (frame == null) return;
+            cts.Token.ThrowIfCancellationRequested();
+            _lastCover = frame;
             _log.Info("Send NP COV begin");
+            await DeliverCoverAsync(frame, cts.Token);
+        }
+        catch (OperationCanceledException)
+        {
+            _log.Info("Cover send aborted");
+        }
+        catch (Exception ex)
+        {
+            _log.Info($"Cover send failed: {ex.Message}");
+        }
+        finally
+        {
+            _coverLock.Release();
+        }
+    }
 
-            _serial.SendLine("NP COV BEGIN 40 40");
-            const int chunk = 100;
-            var sb = new StringBuilder(chunk * 4);
-            int count = 0;
-            foreach (var px in pixels)
+    private async Task ResendCoverAsync(CoverFrame frame)
+    {
+        var cts = BeginCoverSend();
+        try
+        {
+            await _coverLock.WaitAsync(cts.Token);
+        }
+        catch (OperationCanceledException)
+        {
+            return;
+        }
+        try
+        {
+            await DeliverCoverAsync(frame, cts.Token);
+        }
+        catch (Exception ex)
+        {
+            _log.Info($"Cover resend failed: {ex.Message}");
+        }
+        finally
+        {
+            _coverLock.Release();
+        }
+    }
+
+    private async Task DeliverCoverAsync(CoverFrame frame, CancellationToken ct)
+    {
+        if (_coverCacheQueries)
+        {
+            bool? cached = await _coverTransfer.QueryCacheAsync(frame.Key, ct);
+            if (cached == true)
             {
-                sb.Append(px.ToString("X4"));
-                count++;
-                if (count >= chunk)
-                {
-                    _serial.SendLine($"NP COV DATA {sb}");
-                    sb.Clear();
-                    count = 0;
-                }
+                _log.Info($"Cover cache hit {frame.Key}, nothing to send");
+                return;
             }
-            if (sb.Length > 0)
+            if (cached == null)
             {
-                _serial.SendLine($"NP COV DATA {sb}");
+                // Firmware without a cover cache: stop asking for this connection.
+                _coverCacheQueries = false;
             }
-            _serial.SendLine("NP COV END");
-            _log.Info($"Send NP COV end count={pixels.Length}");
         }
-        catch (Exception ex)
+
+        var lossless = CoverPayload.Lossless(frame.Pixels, CoverSize, CoverSize, interlaced: false);
+        var interlaced = CoverPayload.Lossless(frame.Pixels, CoverSize, CoverSize, interlaced: true);
+        // Interlaced shows a preview after the first chunk; JPEG (baseline only) must
+        // save at least half the bytes to be worth waiting for the whole file.
+        var candidates = new List<CoverPayload>();
+        if (_jpegCovers && frame.Jpeg != null && frame.Jpeg.Length * 2 < interlaced.Bytes.Length)
         {
-            _log.Info($"Cover send failed: {ex.Message}");
+            candidates.Add(new CoverPayload("JPG", CoverSize, CoverSize, frame.Jpeg));
         }
-        finally
+        if (_interlacedCovers) candidates.Add(interlaced);
+        candidates.Add(lossless);
+        _log.Info($"Cover encode: RAW {frame.Pixels.Length * 2} B (hex {frame.Pixels.Length * 4}), " +
+                  $"{lossless.Format} {lossless.Bytes.Length} B, {interlaced.Format} {interlaced.Bytes.Length} B, " +
+                  $"JPG {frame.Jpeg?.Length ?? 0} B -> {candidates[0].Format}");
+
+        var result = CoverSendResult.Rejected;
+        foreach (var payload in candidates)
         {
-            Interlocked.Exchange(ref _coverSending, 0);
-            _coverLock.Release();
+            result = await _coverTransfer.SendAsync(payload, ct);
+            if (result != CoverSendResult.Rejected) break;
+            // Firmware without this format: skip it for the rest of the connection.
+            if (payload.Format == "JPG") _jpegCovers = false;
+            else if (payload == interlaced) _interlacedCovers = false;
         }
+        if (result == CoverSendResult.Unsupported)
+        {
+            // Older firmware without windowed transfer: fall back to plain streaming.
+            _log.Info("Cover windowed transfer not acked, using legacy NP COV DATA");
+            SendCoverLines(frame.Pixels);
+        }
+        _log.Info($"Send NP COV {result} count={frame.Pixels.Length}");
+    }
+
+    // A newer cover (or a track change) supersedes whatever is in flight.
+    private CancellationTokenSource BeginCoverSend()
+    {
+        var cts = new CancellationTokenSource();
+        Interlocked.Exchange(ref _coverCts, cts)?.Cancel();
+        return cts;
+    }
+
+    private void AbortCover()
+    {
+        Interlocked.Exchange(ref _coverCts, null)?.Cancel();
     }
 
+    // Cover lines are bulk traffic: one 40px row per line keeps each chunk short
+    // enough that a queued VOL/PROG line waits at most ~15 ms at 115200 baud.
+    private void SendCoverLines(ushort[] pixels)
+    {
+        const int chunk = 40;
+        _serial.SendBulkLine("NP COV BEGIN 40 40");
+        var sb = new StringBuilder(chunk * 4);
+        int count = 0;
+        foreach (var px in pixels)
+        {
+            sb.Append(px.ToString("X4"));
+            count++;
+            if (count >= chunk)
+            {
+                _serial.SendBulkLine($"NP COV DATA {sb}");
+                sb.Clear();
+                count = 0;
+            }
+        }
+        if (sb.Length > 0)
+        {
+            _serial.SendBulkLine($"NP COV DATA {sb}");
+        }
+        _serial.SendBulkLine("NP COV END");
+    }
+
+    /// <summary>
+    /// 断线恢复后：状态行已由串口层重放，这里只补进度、封面（先查设备缓存）和未确认的歌词时间轴
+    /// </summary>
+    private void OnSessionResumed()
+    {
+        _lastProgSent = DateTime.MinValue;  // the next timeline poll re-anchors the device clock
+        if (_lastCover != null)
+        {
+            _ = ResendCoverAsync(_lastCover);
+        }
+        List<LyricEntry> lyrics;
+        lock (_lyricLock)
+        {
+            lyrics = _lyrics;
+        }
+        if (!_deviceLyrics && lyrics.Count > 0)
+        {
+            UploadLyricTimeline(lyrics);
+        }
+    }
+
+    /// <summary>
+    /// 当前标题/艺术家（已清理换行与制表符），供 STATE 快照使用
+    /// </summary>
+    public (string Title, string Artist) CurrentMeta() => (SanitizeField(_lastTitle), SanitizeField(_lastArtist));
+
     public void ResendNowPlaying()
     {
         bool hasMeta = !(string.IsNullOrWhiteSpace(_lastTitle) && string.IsNullOrWhiteSpace(_lastArtist));
@@ -530,33 +739,27 @@ internal sealed class SmtcBridge : IDisposable
         }
         if (_lastProgDur > 0 && _lastProgPos >= 0)
         {
+            _lastProgSent = DateTime.MinValue;  // a fresh device clock needs an anchor now
             MaybeSendProgress(_lastProgPos, _lastProgDur);
         }
 
+        _jpegCovers = true;
+        _interlacedCovers = true;
+        _coverCacheQueries = true;
         if (_lastCover != null)
         {
-            Interlocked.Exchange(ref _coverSending, 1);
-            _serial.SendLine("NP COV BEGIN 40 40");
-            const int chunk = 100;
-            var sb = new StringBuilder(chunk * 4);
-            int count = 0;
-            foreach (var px in _lastCover)
-            {
-                sb.Append(px.ToString("X4"));
-                count++;
-                if (count >= chunk)
-                {
-                    _serial.SendLine($"NP COV DATA {sb}");
-                    sb.Clear();
-                    count = 0;
-                }
-            }
-            if (sb.Length > 0)
-            {
-                _serial.SendLine($"NP COV DATA {sb}");
-            }
-            _serial.SendLine("NP COV END");
-            Interlocked.Exchange(ref _coverSending, 0);
+            _ = ResendCoverAsync(_lastCover);
+        }
+        List<LyricEntry> lyrics;
+        lock (_lyricLock)
+        {
+            lyrics = _lyrics;
+        }
+        if (lyrics.Count > 0)
+        {
+            // The device may have rebooted and lost its timeline.
+            _lastLyricIndex = -2;
+            UploadLyricTimeline(lyrics);
         }
         bool needRefresh = !hasMeta || _lastCover == null || _lastProgDur <= 0;
         if (needRefresh && _session != null)
@@ -565,14 +768,14 @@ internal sealed class SmtcBridge : IDisposable
         }
     }
 
-    private static async Task<ushort[]?> DecodeCoverAsync(IRandomAccessStreamReference thumbnail)
+    private static async Task<CoverFrame?> DecodeCoverAsync(IRandomAccessStreamReference thumbnail)
     {
         using IRandomAccessStream stream = await thumbnail.OpenReadAsync();
         BitmapDecoder decoder = await BitmapDecoder.CreateAsync(stream);
         var transform = new BitmapTransform
         {
-            ScaledWidth = 40,
-            ScaledHeight = 40,
+            ScaledWidth = CoverSize,
+            ScaledHeight = CoverSize,
             InterpolationMode = BitmapInterpolationMode.NearestNeighbor
         };
         PixelDataProvider data = await decoder.GetPixelDataAsync(
@@ -582,9 +785,9 @@ internal sealed class SmtcBridge : IDisposable
             ExifOrientationMode.IgnoreExifOrientation,
             ColorManagementMode.DoNotColorManage);
         byte[] bytes = data.DetachPixelData();
-        if (bytes.Length < 40 * 40 * 4) return null;
+        if (bytes.Length < CoverSize * CoverSize * 4) return null;
 
-        var result = new ushort[40 * 40];
+        var result = new ushort[CoverSize * CoverSize];
         int di = 0;
         for (int i = 0; i < bytes.Length; i += 4)
         {
@@ -596,11 +799,76 @@ internal sealed class SmtcBridge : IDisposable
             result[di++] = rgb565;
             if (di >= result.Length) break;
         }
-        return result;
+        byte[]? jpeg = null;
+        try
+        {
+            jpeg = await EncodeJpegAsync(bytes, CoverSize, CoverSize);
+        }
+        catch (Exception)
+        {
+            // Lossless payload still works without the JPEG encoder.
+        }
+        return new CoverFrame(result, jpeg, CoverTransfer.ContentKey(result));
+    }
+
+    // Baseline JPEG (WIC never writes progressive), small enough for the device's ROM decoder.
+    private static async Task<byte[]> EncodeJpegAsync(byte[] bgra, int width, int height)
+    {
+        using var stream = new InMemoryRandomAccessStream();
+        var options = new BitmapPropertySet
+        {
+            { "ImageQuality", new BitmapTypedValue(JpegQuality, Windows.Foundation.PropertyType.Single) }
+        };
+        BitmapEncoder encoder = await BitmapEncoder.CreateAsync(BitmapEncoder.JpegEncoderId, stream, options);
+        encoder.SetPixelData(BitmapPixelFormat.Bgra8, BitmapAlphaMode.Ignore,
+            (uint)width, (uint)height, 96, 96, bgra);
+        await encoder.FlushAsync();
+
+        var jpeg = new byte[stream.Size];
+        using var reader = new DataReader(stream.GetInputStreamAt(0));
+        await reader.LoadAsync((uint)stream.Size);
+        reader.ReadBytes(jpeg);
+        return jpeg;
+    }
+
+    // One bulk burst per track; until LRC OK arrives (older firmware never sends
+    // it) lines keep being pushed with LRC CUR/NXT.
+    private void UploadLyricTimeline(List<LyricEntry> entries)
+    {
+        _deviceLyrics = false;
+        int bytes = 0;
+        void Send(string line)
+        {
+            bytes += Encoding.UTF8.GetByteCount(line) + 1;
+            _serial.SendBulkLine(line);
+        }
+
+        Send($"LRC BEGIN {entries.Count}");
+        foreach (var entry in entries)
+        {
+            Send($"LRC L {entry.TimeMs} {SanitizeField(entry.Text)}");
+        }
+        Send($"LRC END {entries.Count}");
+        _log.Info($"Lyric timeline upload: {entries.Count} lines, {bytes} B");
+    }
+
+    private void OnLyricTimelineAcked(int count)
+    {
+        int expected;
+        lock (_lyricLock)
+        {
+            expected = _lyrics.Count;
+        }
+        if (count <= 0 || expected == 0) return;
+        _deviceLyrics = true;
+        _log.Info(count < expected
+            ? $"Lyric timeline on device: {count}/{expected} lines (truncated)"
+            : $"Lyric timeline on device: {count} lines");
     }
 
     private void UpdateLyricByPosition(long positionMs)
     {
+        if (_deviceLyrics) return;
         List<LyricEntry> list;
         lock (_lyricLock)
         {
@@ -695,12 +963,16 @@ internal sealed class SmtcBridge : IDisposable
 
     private sealed record LyricEntry(long TimeMs, string Text);
 
+    // Decoded cover pixels, an optional JPEG of the same frame, and its cache key.
+    private sealed record CoverFrame(ushort[] Pixels, byte[]? Jpeg, string Key);
+
     public void Dispose()
     {
         if (_disposed) return;
         _disposed = true;
         StopTimelineTimer();
         _timelineTimer.Dispose();
+        AbortCover();
         DetachSession();
         if (_manager != null)
         {
@@ -14,13 +14,16 @@
 #define SPDRP_PORTNAME (0x0000000F)
 #endif
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -38,6 +41,10 @@ namespace {
 constexpr UINT WM_TRAY = WM_APP + 1;
 constexpr UINT TIMER_CONNECT = 1;
 constexpr UINT WM_SERIAL = WM_APP + 2;
+constexpr UINT TIMER_PING = 2;
+constexpr UINT kDefaultPingMs = 2000;
+constexpr size_t kStateLineMaxBytes = 1000;  // device line buffer is 1 KB
+constexpr char kBridgeCaps[] = "CAPS VOLSEQ";  // sent before every HELLO / HELLO OK
 
 constexpr wchar_t kAppName[] = L"SongLedPcCpp";
 constexpr wchar_t kRunKey[] = L"Software\\Microsoft\\Windows\\CurrentVersion\\Run";
@@ -178,6 +185,58 @@ void SetAutoStartEnabled(bool enable) {
   RegCloseKey(key);
 }
 
+// Control lines (VOL/MUTE/HELLO OK) always leave before bulk lines (device
+// lists). Bulk is written one line at a time, so control waits behind at most
+// one bulk chunk. Producers keep bulk lines short; the device parses whole lines.
+enum class LinkPriority { Control, Bulk };
+
+struct LinkStats {
+  uint32_t bulkLines = 0;
+  uint32_t controlDuringBulk = 0;
+  double worstControlWaitMs = 0.0;
+};
+
+// PING <seq> <t> / PONG <seq> <t> round trips. Fixed coarse buckets (same as
+// the firmware); percentiles report the bucket's upper bound.
+class RttHistogram {
+public:
+  void Add(uint32_t ms) {
+    size_t b = 0;
+    while (b < kBounds.size() && ms > kBounds[b]) b++;
+    counts_[b]++;
+    samples_++;
+    if (ms > max_) max_ = ms;
+  }
+
+  uint32_t Percentile(uint32_t pct) const {
+    if (samples_ == 0) return 0;
+    uint32_t rank = (samples_ * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (size_t b = 0; b < kBounds.size(); ++b) {
+      seen += counts_[b];
+      if (seen >= rank) return (std::min)(static_cast<uint32_t>(kBounds[b]), max_);
+    }
+    return max_;
+  }
+
+  // "n=.. p50=.. p95=.. p99=.. max=.."; the wire format of DIAG RTT rows.
+  std::string Summary() const {
+    char buf[80];
+    std::snprintf(buf, sizeof(buf), "n=%u p50=%u p95=%u p99=%u max=%u", samples_, Percentile(50),
+                  Percentile(95), Percentile(99), max_);
+    return buf;
+  }
+
+  void Reset() { *this = RttHistogram(); }
+
+private:
+  static constexpr std::array<uint16_t, 19> kBounds = {2,  4,  6,   8,   10,  15,  20,  30,   40,  50,
+                                                       75, 100, 150, 200, 300, 500, 750, 1000, 2000};
+  std::array<uint32_t, kBounds.size() + 1> counts_ = {};
+  uint32_t samples_ = 0;
+  uint32_t max_ = 0;
+};
+
 class SerialPort {
 public:
   using LineHandler = void(*)(const std::string &line, void *ctx);
@@ -240,12 +299,23 @@ public:
     ctx_ = ctx;
     running_ = true;
     reader_ = std::thread([this]() { ReadLoop(); });
+    writer_ = std::thread([this]() { WriteLoop(); });
     return true;
   }
 
   void Close() {
-    running_ = false;
+    {
+      std::lock_guard<std::mutex> lock(queueMutex_);
+      running_ = false;
+    }
+    queueCv_.notify_all();
     if (reader_.joinable()) reader_.join();
+    if (writer_.joinable()) writer_.join();
+    {
+      std::lock_guard<std::mutex> lock(queueMutex_);
+      controlQueue_.clear();
+      bulkQueue_.clear();
+    }
     if (handle_ != INVALID_HANDLE_VALUE) {
       CloseHandle(handle_);
       handle_ = INVALID_HANDLE_VALUE;
@@ -255,7 +325,65 @@ public:
   bool IsOpen() const { return handle_ != INVALID_HANDLE_VALUE; }
   DWORD LastError() const { return lastError_; }
 
-  void WriteLine(const std::string &line) {
+  void WriteLine(const std::string &line, LinkPriority priority = LinkPriority::Control) {
+    if (handle_ == INVALID_HANDLE_VALUE) return;
+    {
+      std::lock_guard<std::mutex> lock(queueMutex_);
+      if (priority == LinkPriority::Bulk) {
+        bulkQueue_.push_back(line);
+      } else {
+        controlQueue_.push_back({line, std::chrono::steady_clock::now()});
+      }
+    }
+    queueCv_.notify_one();
+  }
+
+  LinkStats LastBulkStats() {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    return lastStats_;
+  }
+
+private:
+  struct PendingControl {
+    std::string line;
+    std::chrono::steady_clock::time_point queued;
+  };
+
+  void WriteLoop() {
+    while (true) {
+      std::string line;
+      {
+        std::unique_lock<std::mutex> lock(queueMutex_);
+        queueCv_.wait(lock, [this]() {
+          return !running_ || !controlQueue_.empty() || !bulkQueue_.empty();
+        });
+        if (!running_) return;
+        if (!controlQueue_.empty()) {
+          PendingControl item = std::move(controlQueue_.front());
+          controlQueue_.pop_front();
+          if (burst_.bulkLines > 0) {
+            double waitMs = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - item.queued).count();
+            burst_.controlDuringBulk++;
+            if (waitMs > burst_.worstControlWaitMs) burst_.worstControlWaitMs = waitMs;
+          }
+          line = std::move(item.line);
+        } else {
+          burst_.bulkLines++;
+          line = std::move(bulkQueue_.front());
+          bulkQueue_.pop_front();
+        }
+      }
+      WriteRaw(line);
+      std::lock_guard<std::mutex> lock(queueMutex_);
+      if (bulkQueue_.empty() && controlQueue_.empty() && burst_.bulkLines > 0) {
+        lastStats_ = burst_;
+        burst_ = {};
+      }
+    }
+  }
+
+  void WriteRaw(const std::string &line) {
     std::lock_guard<std::mutex> lock(writeMutex_);
     if (handle_ == INVALID_HANDLE_VALUE) return;
     std::string out = line + "\n";
@@ -263,7 +391,6 @@ public:
     WriteFile(handle_, out.data(), static_cast<DWORD>(out.size()), &written, nullptr);
   }
 
-private:
   void ReadLoop() {
     std::string buf;
     char temp[128];
@@ -286,8 +413,15 @@ private:
 
   HANDLE handle_ = INVALID_HANDLE_VALUE;
   std::thread reader_;
+  std::thread writer_;
   std::atomic<bool> running_{false};
   std::mutex writeMutex_;
+  std::mutex queueMutex_;
+  std::condition_variable queueCv_;
+  std::deque<PendingControl> controlQueue_;
+  std::deque<std::string> bulkQueue_;
+  LinkStats burst_;
+  LinkStats lastStats_;
   LineHandler handler_ = nullptr;
   void *ctx_ = nullptr;
   DWORD lastError_ = 0;
@@ -458,7 +592,7 @@ class App {
 public:
   App() = default;
 
-  bool Init(HINSTANCE inst, const std::wstring &port, const std::wstring &vidPid, bool autoStart) {
+  bool Init(HINSTANCE inst, const std::wstring &port, const std::wstring &vidPid, bool autoStart, UINT pingMs) {
     inst_ = inst;
     portArg_ = port;
     vidPid_ = vidPid;
@@ -476,6 +610,8 @@ public:
     trayMenu_ = CreatePopupMenu();
     AppendMenuW(trayMenu_, MF_STRING | MF_GRAYED, 1, L"Status: Disconnected");
     AppendMenuW(trayMenu_, MF_STRING | MF_GRAYED, 2, L"Port: -");
+    AppendMenuW(trayMenu_, MF_STRING | MF_GRAYED, 6, L"RTT PC: -");
+    AppendMenuW(trayMenu_, MF_STRING | MF_GRAYED, 7, L"RTT Device: -");
     AppendMenuW(trayMenu_, MF_SEPARATOR, 0, nullptr);
     AppendMenuW(trayMenu_, MF_STRING, 3, L"AutoStart: Off");
     AppendMenuW(trayMenu_, MF_STRING, 4, L"Reconnect");
@@ -493,6 +629,7 @@ public:
     Shell_NotifyIconW(NIM_ADD, &nid);
 
     SetTimer(hwnd_, TIMER_CONNECT, 3000, nullptr);
+    if (pingMs > 0) SetTimer(hwnd_, TIMER_PING, pingMs, nullptr);
 
     if (autoStart) {
       SetAutoStartEnabled(true);
@@ -557,6 +694,8 @@ private:
       case WM_TIMER:
         if (wparam == TIMER_CONNECT) {
           StartConnect(false);
+        } else if (wparam == TIMER_PING) {
+          SendProbe();
         }
         return 0;
       case WM_SERIAL:
@@ -593,6 +732,10 @@ private:
 
   void UpdateMenu() {
     std::wstring status = serial_.IsOpen() ? L"Status: Connected" : L"Status: Waiting";
+    LinkStats link = serial_.LastBulkStats();
+    if (serial_.IsOpen() && link.controlDuringBulk > 0) {
+      status += L" (ctl wait max " + std::to_wstring(static_cast<int>(std::lround(link.worstControlWaitMs))) + L" ms)";
+    }
     if (!serial_.IsOpen() && !lastOpenErrorText_.empty()) {
       status += L" (";
       status += lastOpenErrorText_;
@@ -601,8 +744,14 @@ private:
     std::wstring port = L"Port: ";
     port += currentPort_.empty() ? L"-" : currentPort_;
     std::wstring autostart = IsAutoStartEnabled() ? L"AutoStart: On" : L"AutoStart: Off";
+    std::wstring rttPc = L"RTT PC: " + Utf8ToWide(rttUsb_.Summary());
+    std::wstring rttDevice = L"RTT Device: " + (deviceRtt_.empty() ? std::wstring(L"-") : Utf8ToWide(deviceRtt_));
     ModifyMenuW(trayMenu_, 1, MF_BYCOMMAND | MF_STRING | MF_GRAYED, 1, status.c_str());
     ModifyMenuW(trayMenu_, 2, MF_BYCOMMAND | MF_STRING | MF_GRAYED, 2, port.c_str());
+    ModifyMenuW(trayMenu_, 6, MF_BYCOMMAND | MF_STRING | MF_GRAYED, 6, rttPc.c_str());
+    ModifyMenuW(trayMenu_, 7, MF_BYCOMMAND | MF_STRING | MF_GRAYED, 7, rttDevice.c_str());
+    // Refresh the device row for the next time the menu opens.
+    if (serial_.IsOpen()) serial_.WriteLine("DIAG RTT", LinkPriority::Bulk);
     ModifyMenuW(trayMenu_, 3, MF_BYCOMMAND | MF_STRING, 3, autostart.c_str());
   }
 
@@ -631,6 +780,7 @@ private:
     ctx->app = this;
     if (serial_.Open(port, &App::HandleSerialStatic, ctx)) {
       currentPort_ = port;
+      serial_.WriteLine(kBridgeCaps);
       serial_.WriteLine("HELLO");
       lastOpenErrorCode_ = 0;
       lastOpenErrorText_.clear();
@@ -715,19 +865,53 @@ private:
 
   void HandleSerial(const std::string &line) {
     if (line.rfind("HELLO", 0) == 0) {
+      if (line == "HELLO") {  // a fresh device session; old round trips no longer apply
+        rttUsb_.Reset();
+        deviceRtt_.clear();
+      }
+      serial_.WriteLine(kBridgeCaps);
       serial_.WriteLine("HELLO OK");
       SendVolumeState();
       SendSpeakerList();
       return;
     }
+    if (line.rfind("PING ", 0) == 0) {
+      // Probes travel as bulk both ways so they never delay control lines.
+      serial_.WriteLine("PONG " + line.substr(5), LinkPriority::Bulk);
+      return;
+    }
+    if (line.rfind("PONG ", 0) == 0) {
+      unsigned seq = 0;
+      unsigned long sentMs = 0;
+      if (std::sscanf(line.c_str() + 5, "%u %lu", &seq, &sentMs) == 2) {
+        uint32_t rtt = NowMs() - static_cast<uint32_t>(sentMs);
+        if (rtt < 60000) rttUsb_.Add(rtt);
+      }
+      return;
+    }
+    if (line == "DIAG RTT") {
+      serial_.WriteLine("DIAG RTT usb " + rttUsb_.Summary(), LinkPriority::Bulk);
+      return;
+    }
+    if (line.rfind("DIAG RTT usb ", 0) == 0) {
+      deviceRtt_ = line.substr(13);  // this bridge only speaks USB
+      return;
+    }
+    if (line == "STATE GET") {
+      SendStateSnapshot();
+      return;
+    }
     if (line == "VOL GET") {
       SendVolumeState();
       return;
     }
     if (line.rfind("VOL SET", 0) == 0) {
-      int value = std::atoi(line.substr(7).c_str());
+      // VOL SET <v> [seq]; the echo carries seq so the device can drop stale replies.
+      int value = 0;
+      unsigned seq = 0;
+      int fields = std::sscanf(line.c_str() + 7, "%d %u", &value, &seq);
       audio_.SetVolume(value);
-      SendVolumeState();
+      SendVolumeState(fields >= 2 ? std::to_string(seq) : std::string());
       return;
     }
     if (line == "MUTE") {
@@ -747,22 +931,59 @@ private:
     }
   }
 
-  void SendVolumeState() {
+  static uint32_t NowMs() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+  }
+
+  void SendProbe() {
+    if (!serial_.IsOpen()) return;
+    serial_.WriteLine("PING " + std::to_string(++pingSeq_) + " " + std::to_string(NowMs()), LinkPriority::Bulk);
+  }
+
+  void SendVolumeState(const std::string& seq = std::string()) {
     int vol = audio_.GetVolume();
     int mute = audio_.GetMute() ? 1 : 0;
-    serial_.WriteLine("VOL " + std::to_string(vol));
+    serial_.WriteLine("VOL " + std::to_string(vol) + (seq.empty() ? "" : " " + seq));
     serial_.WriteLine("MUTE " + std::to_string(mute));
   }
 
+  // One-line resync after connect; this bridge has no capture list or media info.
+  // STATE vol mute spkCur spkN micCur micN\tspk...
+  void SendStateSnapshot() {
+    audio_.RefreshDevices();
+    const auto &devs = audio_.Devices();
+    std::wstring currentId = audio_.GetCurrentDeviceId();
+    int current = -1;
+    for (size_t i = 0; i < devs.size(); ++i) {
+      if (devs[i].id == currentId) current = static_cast<int>(i);
+    }
+    std::string line = "STATE " + std::to_string(audio_.GetVolume()) + " " + (audio_.GetMute() ? "1" : "0") + " " +
+                       std::to_string(current) + " " + std::to_string(devs.size()) + " -1 0";
+    for (const auto &dev : devs) {
+      std::string name = WideToUtf8(dev.name);
+      for (char &c : name) {
+        if (c == '\t') c = ' ';
+      }
+      line += "\t" + name;
+    }
+    if (line.size() > kStateLineMaxBytes) {
+      SendVolumeState();
+      SendSpeakerList();
+      return;
+    }
+    serial_.WriteLine(line);
+  }
+
   void SendSpeakerList() {
     audio_.RefreshDevices();
-    serial_.WriteLine("SPK BEGIN");
+    serial_.WriteLine("SPK BEGIN", LinkPriority::Bulk);
     const auto &devs = audio_.Devices();
     for (size_t i = 0; i < devs.size(); ++i) {
       std::string name = WideToUtf8(devs[i].name);
-      serial_.WriteLine("SPK ITEM " + std::to_string(i) + " " + name);
+      serial_.WriteLine("SPK ITEM " + std::to_string(i) + " " + name, LinkPriority::Bulk);
     }
-    serial_.WriteLine("SPK END");
+    serial_.WriteLine("SPK END", LinkPriority::Bulk);
     SendCurrentSpeaker();
   }
 
@@ -810,6 +1031,10 @@ private:
   std::mutex serialQueueMutex_;
   std::queue<std::string> serialQueue_;
 
+  RttHistogram rttUsb_;
+  std::string deviceRtt_;  // device-side summary for USB, from its DIAG RTT reply
+  uint32_t pingSeq_ = 0;
+
   SerialPort serial_;
   SerialContext serialCtx_;
   AudioManager audio_;
@@ -819,6 +1044,7 @@ struct Args {
   std::wstring port;
   std::wstring vidPid;
   bool autoStart = false;
+  UINT pingMs = kDefaultPingMs;  // --ping-ms N, 0 disables probing
 };
 
 Args ParseArgs() {
@@ -841,6 +1067,8 @@ Args ParseArgs() {
         if (!args.vidPid.empty()) args.vidPid += L"&";
         args.vidPid += L"PID_" + pid;
       }
+    } else if (cur == L"--ping-ms" && i + 1 < argc) {
+      args.pingMs = static_cast<UINT>(std::wcstoul(argv[++i], nullptr, 10));
     } else if (cur == L"--autostart" && i + 1 < argc) {
       std::wstring val = argv[++i];
       if (val == L"on") args.autoStart = true;
@@ -861,7 +1089,7 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int) {
 
   Args args = ParseArgs();
   App app;
-  if (!app.Init(hInstance, args.port, args.vidPid, args.autoStart)) {
+  if (!app.Init(hInstance, args.port, args.vidPid, args.autoStart, args.pingMs)) {
     return 1;
   }
   app.Run();
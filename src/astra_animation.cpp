@@ -1,12 +1,18 @@
+#include <algorithm>
 #include "astra/ui/item/item.h"
 
 namespace astra {
 float g_anim_dt = 1.0f / 60.0f;
 uint32_t g_anim_last_ms = 0;
 float g_anim_speed_scale = 1.0f;
+float g_anim_alpha[ANIM_SPEED_MAX + 1];
+uint16_t g_anim_active = 0;
 
 void Animation::tick() {
   uint32_t now = HAL::millis();
+  bool wasIdle = g_anim_active == 0;
+  g_anim_active = 0;
+  std::fill(g_anim_alpha, g_anim_alpha + ANIM_SPEED_MAX + 1, -1.0f);
   if (g_anim_last_ms == 0) {
     g_anim_last_ms = now;
     g_anim_dt = 1.0f / 60.0f;
@@ -16,7 +22,10 @@ void Animation::tick() {
   g_anim_last_ms = now;
   float dt = static_cast<float>(dt_ms) / 1000.0f;
   if (dt < 0.001f) dt = 0.001f;
-  if (dt > 0.05f) dt = 0.05f;
+  // move() is exact for any step, so slow frames no longer slow the UI down.
+  // A long gap means the UI was idle or not being drawn; the first step after
+  // it starts fresh instead of jumping.
+  if (dt > 0.25f || (wasIdle && dt > 1.0f / 60.0f)) dt = 1.0f / 60.0f;
   g_anim_dt = dt;
 }
 }  // namespace astra
@@ -0,0 +1,211 @@
+#include "cover_cache.h"
+
+#include <cstring>
+
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+
+namespace {
+
+constexpr const char *TAG = "COVCACHE";
+constexpr const char *PARTITION_LABEL = "covers";
+constexpr uint32_t FLASH_MAGIC = 0x56434C53;  // "SLCV"
+constexpr size_t FLASH_SLOT_BYTES = 4096;     // one erase sector per cover
+constexpr int FLASH_SLOTS_MAX = 128;
+constexpr int PENDING_MAX = COVER_CACHE_RAM_SLOTS;  // writes wait for the UI to go still
+
+// Written after the pixels, so a torn write never yields a valid slot.
+struct FlashHeader {
+  uint32_t magic;
+  uint32_t seq;
+  uint64_t key;
+  uint32_t bytes;
+  uint32_t crc;
+};
+
+struct RamEntry {
+  uint64_t key;
+  uint32_t lastUse;
+  bool valid;
+};
+
+size_t coverBytes = 0;
+uint8_t *ramPool = nullptr;
+RamEntry ramEntries[COVER_CACHE_RAM_SLOTS] = {};
+uint32_t useClock = 0;
+
+const esp_partition_t *flashPart = nullptr;
+int flashSlots = 0;
+uint64_t flashKeys[FLASH_SLOTS_MAX];
+uint32_t flashSeq[FLASH_SLOTS_MAX];  // 0 = empty slot
+uint32_t flashNextSeq = 1;
+
+uint64_t pendingKeys[PENDING_MAX];
+int pendingCount = 0;
+
+uint32_t hitCount = 0;
+uint32_t missCount = 0;
+
+uint8_t *ramPixels(int slot) { return ramPool + static_cast<size_t>(slot) * coverBytes; }
+
+int ramFind(uint64_t key) {
+  for (int i = 0; i < COVER_CACHE_RAM_SLOTS; ++i) {
+    if (ramEntries[i].valid && ramEntries[i].key == key) return i;
+  }
+  return -1;
+}
+
+// Claims the empty or least recently used slot for `key`.
+int ramClaim(uint64_t key) {
+  int victim = 0;
+  for (int i = 0; i < COVER_CACHE_RAM_SLOTS; ++i) {
+    if (!ramEntries[i].valid) {
+      victim = i;
+      break;
+    }
+    if (ramEntries[i].lastUse < ramEntries[victim].lastUse) victim = i;
+  }
+  ramEntries[victim] = {key, ++useClock, true};
+  return victim;
+}
+
+int flashFind(uint64_t key) {
+  for (int i = 0; i < flashSlots; ++i) {
+    if (flashSeq[i] != 0 && flashKeys[i] == key) return i;
+  }
+  return -1;
+}
+
+bool flashRead(int slot, uint8_t *out) {
+  FlashHeader header;
+  size_t base = static_cast<size_t>(slot) * FLASH_SLOT_BYTES;
+  if (esp_partition_read(flashPart, base, &header, sizeof(header)) != ESP_OK) return false;
+  if (header.magic != FLASH_MAGIC || header.bytes != coverBytes) return false;
+  if (esp_partition_read(flashPart, base + sizeof(header), out, coverBytes) != ESP_OK) return false;
+  return esp_rom_crc32_le(0, out, static_cast<uint32_t>(coverBytes)) == header.crc;
+}
+
+void flashWrite(uint64_t key, const uint8_t *pixels) {
+  int slot = 0;
+  for (int i = 0; i < flashSlots; ++i) {
+    if (flashSeq[i] == 0) {
+      slot = i;
+      break;
+    }
+    if (flashSeq[i] < flashSeq[slot]) slot = i;  // oldest write goes first
+  }
+  size_t base = static_cast<size_t>(slot) * FLASH_SLOT_BYTES;
+  flashSeq[slot] = 0;
+  FlashHeader header = {FLASH_MAGIC, flashNextSeq, key, static_cast<uint32_t>(coverBytes),
+                        esp_rom_crc32_le(0, pixels, static_cast<uint32_t>(coverBytes))};
+  if (esp_partition_erase_range(flashPart, base, FLASH_SLOT_BYTES) != ESP_OK ||
+      esp_partition_write(flashPart, base + sizeof(header), pixels, coverBytes) != ESP_OK ||
+      esp_partition_write(flashPart, base, &header, sizeof(header)) != ESP_OK) {
+    ESP_LOGW(TAG, "flash write failed at slot %d", slot);
+    return;
+  }
+  flashKeys[slot] = key;
+  flashSeq[slot] = flashNextSeq++;
+}
+
+void flashScan() {
+  flashPart = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, PARTITION_LABEL);
+  if (!flashPart || coverBytes + sizeof(FlashHeader) > FLASH_SLOT_BYTES) {
+    flashPart = nullptr;
+    return;
+  }
+  flashSlots = static_cast<int>(flashPart->size / FLASH_SLOT_BYTES);
+  if (flashSlots > FLASH_SLOTS_MAX) flashSlots = FLASH_SLOTS_MAX;
+  for (int i = 0; i < flashSlots; ++i) {
+    FlashHeader header;
+    flashSeq[i] = 0;
+    if (esp_partition_read(flashPart, static_cast<size_t>(i) * FLASH_SLOT_BYTES, &header, sizeof(header)) != ESP_OK) {
+      continue;
+    }
+    if (header.magic != FLASH_MAGIC || header.bytes != coverBytes || header.seq == 0) continue;
+    flashKeys[i] = header.key;
+    flashSeq[i] = header.seq;
+    if (header.seq >= flashNextSeq) flashNextSeq = header.seq + 1;
+  }
+}
+
+}  // namespace
+
+void cover_cache_init(size_t pixelBytes) {
+  coverBytes = pixelBytes;
+  size_t poolBytes = coverBytes * COVER_CACHE_RAM_SLOTS;
+  ramPool = static_cast<uint8_t *>(heap_caps_malloc(poolBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+  if (!ramPool) ramPool = static_cast<uint8_t *>(heap_caps_malloc(poolBytes, MALLOC_CAP_8BIT));
+  if (!ramPool) ESP_LOGW(TAG, "no memory for %u byte pool, RAM cache off", static_cast<unsigned>(poolBytes));
+  flashScan();
+  CoverCacheStats s = cover_cache_stats();
+  ESP_LOGI(TAG, "ram=%d slots, flash=%d/%d slots", ramPool ? COVER_CACHE_RAM_SLOTS : 0, s.flashEntries,
+           s.flashSlots);
+}
+
+bool cover_cache_lookup(uint64_t key, uint16_t *out) {
+  int slot = ramPool ? ramFind(key) : -1;
+  if (slot < 0 && flashPart) {
+    int flashSlot = flashFind(key);
+    if (flashSlot >= 0 && !ramPool) {
+      // No RAM tier: the flash copy goes straight to the caller.
+      if (flashRead(flashSlot, reinterpret_cast<uint8_t *>(out))) {
+        hitCount++;
+        return true;
+      }
+      flashSeq[flashSlot] = 0;
+    } else if (flashSlot >= 0) {
+      slot = ramClaim(key);
+      if (!flashRead(flashSlot, ramPixels(slot))) {
+        ramEntries[slot].valid = false;
+        flashSeq[flashSlot] = 0;
+        slot = -1;
+      }
+    }
+  }
+  if (slot < 0) {
+    missCount++;
+    return false;
+  }
+  ramEntries[slot].lastUse = ++useClock;
+  memcpy(out, ramPixels(slot), coverBytes);
+  hitCount++;
+  return true;
+}
+
+void cover_cache_store(uint64_t key, const uint16_t *pixels) {
+  if (!ramPool) return;
+  int slot = ramFind(key);
+  if (slot < 0) slot = ramClaim(key);
+  ramEntries[slot].lastUse = ++useClock;
+  memcpy(ramPixels(slot), pixels, coverBytes);
+  if (flashPart && flashFind(key) < 0 && pendingCount < PENDING_MAX) {
+    pendingKeys[pendingCount++] = key;
+  }
+}
+
+void cover_cache_service() {
+  if (pendingCount == 0) return;
+  uint64_t key = pendingKeys[0];
+  pendingCount--;
+  memmove(pendingKeys, pendingKeys + 1, sizeof(pendingKeys[0]) * pendingCount);
+  int slot = ramFind(key);
+  if (slot < 0 || flashFind(key) >= 0) return;  // evicted meanwhile, or already persisted
+  flashWrite(key, ramPixels(slot));
+}
+
+CoverCacheStats cover_cache_stats() {
+  CoverCacheStats s = {};
+  s.hits = hitCount;
+  s.misses = missCount;
+  for (const RamEntry &e : ramEntries) {
+    if (e.valid) s.ramEntries++;
+  }
+  for (int i = 0; i < flashSlots; ++i) {
+    if (flashSeq[i] != 0) s.flashEntries++;
+  }
+  s.flashSlots = flashSlots;
+  return s;
+}
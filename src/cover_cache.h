@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Decoded covers keyed by a 64-bit content hash the PC computes over the
+// source pixels (FNV-1a). A RAM LRU (PSRAM when available) answers
+// NP COV HAS instantly; if a "covers" data partition exists, entries are also
+// written to one 4 KB sector each so they survive a reboot. Flash writes are
+// deferred to cover_cache_service() so neither a transfer nor a frame waits
+// on an erase.
+constexpr int COVER_CACHE_RAM_SLOTS = 24;
+
+struct CoverCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  int ramEntries;
+  int flashEntries;
+  int flashSlots;  // 0 when no partition is present
+};
+
+// `pixelBytes` is the fixed size of one cover; call once at boot.
+void cover_cache_init(size_t pixelBytes);
+
+// Copies the cover into `out` and returns true on a RAM or flash hit.
+bool cover_cache_lookup(uint64_t key, uint16_t *out);
+
+void cover_cache_store(uint64_t key, const uint16_t *pixels);
+
+// Performs at most one pending flash write. A sector erase plus write blocks
+// for tens of ms, so call it only while the screen is still.
+void cover_cache_service();
+
+CoverCacheStats cover_cache_stats();
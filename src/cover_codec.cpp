@@ -0,0 +1,177 @@
+#include "cover_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+inline uint8_t q565Hash(uint16_t px) {
+  int r = (px >> 11) & 0x1F;
+  int g = (px >> 5) & 0x3F;
+  int b = px & 0x1F;
+  return static_cast<uint8_t>((r * 3 + g * 5 + b * 7) & 63);
+}
+
+inline uint16_t q565Pack(int r, int g, int b) {
+  return static_cast<uint16_t>(((r & 0x1F) << 11) | ((g & 0x3F) << 5) | (b & 0x1F));
+}
+
+// Adam7 passes: origin, step, and the preview cell each pixel fills.
+struct Adam7Pass {
+  uint8_t x0, y0, dx, dy, cellW, cellH;
+};
+constexpr Adam7Pass ADAM7[7] = {
+    {0, 0, 8, 8, 8, 8}, {4, 0, 8, 8, 4, 8}, {0, 4, 4, 8, 4, 4}, {2, 0, 4, 4, 2, 4},
+    {0, 2, 2, 4, 2, 2}, {1, 0, 2, 2, 1, 2}, {0, 1, 1, 2, 1, 1},
+};
+
+// Moves to the first pass (from `pass` on) that has pixels in this image.
+void adam7Seek(CoverStreamDecoder *dec, uint8_t pass) {
+  while (pass < 7 && (ADAM7[pass].x0 >= dec->width || ADAM7[pass].y0 >= dec->height)) pass++;
+  dec->pass = pass;
+  if (pass < 7) {
+    dec->x = ADAM7[pass].x0;
+    dec->y = ADAM7[pass].y0;
+  }
+}
+
+void emitInterlaced(CoverStreamDecoder *dec, uint16_t value) {
+  const Adam7Pass &p = ADAM7[dec->pass];
+  int x1 = std::min(dec->x + p.cellW, dec->width);
+  int y1 = std::min(dec->y + p.cellH, dec->height);
+  for (int y = dec->y; y < y1; ++y) {
+    uint16_t *row = dec->out + y * dec->width;
+    for (int x = dec->x; x < x1; ++x) row[x] = value;
+  }
+  dec->x += p.dx;
+  if (dec->x >= dec->width) {
+    dec->x = p.x0;
+    dec->y += p.dy;
+    if (dec->y >= dec->height) adam7Seek(dec, static_cast<uint8_t>(dec->pass + 1));
+  }
+}
+
+inline void emit(CoverStreamDecoder *dec, uint16_t px) {
+  uint16_t value = dec->swapBytes ? static_cast<uint16_t>((px >> 8) | (px << 8)) : px;
+  dec->pos++;
+  if (dec->interlaced) {
+    emitInterlaced(dec, value);
+  } else {
+    dec->out[dec->pos - 1] = value;
+  }
+}
+
+// Number of bytes (tag included) the op starting with `tag` occupies.
+inline uint8_t q565OpLength(uint8_t tag) {
+  if (tag == Q565_OP_RGB) return 3;
+  if ((tag & Q565_MASK) == Q565_OP_LUMA) return 2;
+  return 1;
+}
+
+bool decodeOp(CoverStreamDecoder *dec, const uint8_t *op) {
+  uint8_t tag = op[0];
+  uint16_t prev = dec->prev;
+  int pr = (prev >> 11) & 0x1F;
+  int pg = (prev >> 5) & 0x3F;
+  int pb = prev & 0x1F;
+
+  if (tag == Q565_OP_RGB) {
+    dec->prev = static_cast<uint16_t>((op[1] << 8) | op[2]);
+  } else if (tag == 0xFF) {
+    return false;  // reserved
+  } else {
+    switch (tag & Q565_MASK) {
+      case Q565_OP_INDEX:
+        dec->prev = dec->index[tag & 0x3F];
+        break;
+      case Q565_OP_DIFF:
+        dec->prev = q565Pack(pr + ((tag >> 4) & 0x03) - 2,
+                             pg + ((tag >> 2) & 0x03) - 2,
+                             pb + (tag & 0x03) - 2);
+        break;
+      case Q565_OP_LUMA: {
+        int dg = (tag & 0x3F) - 32;
+        int drdg = ((op[1] >> 4) & 0x0F) - 8;
+        int dbdg = (op[1] & 0x0F) - 8;
+        dec->prev = q565Pack(pr + dg + drdg, pg + dg, pb + dg + dbdg);
+        break;
+      }
+      case Q565_OP_RUN:
+      default: {
+        int run = (tag & 0x3F) + 1;
+        if (dec->pos + run > dec->total) return false;
+        for (int i = 0; i < run; ++i) emit(dec, prev);
+        return true;
+      }
+    }
+  }
+
+  if (dec->pos >= dec->total) return false;
+  dec->index[q565Hash(dec->prev)] = dec->prev;
+  emit(dec, dec->prev);
+  return true;
+}
+
+}  // namespace
+
+void cover_decoder_begin(CoverStreamDecoder *dec, CoverFormat format, uint16_t *out, int pixels,
+                         bool swapBytes) {
+  memset(dec, 0, sizeof(*dec));
+  dec->format = format;
+  dec->swapBytes = swapBytes;
+  dec->out = out;
+  dec->total = pixels;
+}
+
+void cover_decoder_interlace(CoverStreamDecoder *dec, int width, int height) {
+  dec->interlaced = true;
+  dec->width = width;
+  dec->height = height;
+  dec->total = width * height;
+  adam7Seek(dec, 0);
+}
+
+bool cover_decoder_feed(CoverStreamDecoder *dec, const uint8_t *data, size_t len) {
+  if (dec->failed) return false;
+  size_t i = 0;
+
+  if (dec->format == COVER_FMT_RAW565) {
+    while (i < len) {
+      dec->pending[dec->pendingLen++] = data[i++];
+      if (dec->pendingLen < 2) continue;
+      dec->pendingLen = 0;
+      if (dec->pos >= dec->total) {
+        dec->failed = true;
+        return false;
+      }
+      emit(dec, static_cast<uint16_t>((dec->pending[0] << 8) | dec->pending[1]));
+    }
+    return true;
+  }
+
+  // Finish an op split across the previous feed.
+  if (dec->pendingLen > 0) {
+    uint8_t need = q565OpLength(dec->pending[0]);
+    while (dec->pendingLen < need && i < len) dec->pending[dec->pendingLen++] = data[i++];
+    if (dec->pendingLen < need) return true;
+    dec->pendingLen = 0;
+    if (!decodeOp(dec, dec->pending)) {
+      dec->failed = true;
+      return false;
+    }
+  }
+
+  while (i < len) {
+    uint8_t need = q565OpLength(data[i]);
+    if (i + need > len) {
+      while (i < len) dec->pending[dec->pendingLen++] = data[i++];
+      break;
+    }
+    if (!decodeOp(dec, data + i)) {
+      dec->failed = true;
+      return false;
+    }
+    i += need;
+  }
+  return true;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Cover payload formats carried by NP COV BEGIN.
+enum CoverFormat : uint8_t {
+  COVER_FMT_RAW565 = 0,  // big-endian RGB565, 2 bytes per pixel
+  COVER_FMT_Q565 = 1,    // QOI-style run/index/diff stream tuned for RGB565
+  COVER_FMT_JPEG = 2,    // baseline JPEG, decoded once the whole file is staged
+};
+
+// Q565 opcodes (one tag byte, MSB first):
+//   00iiiiii                INDEX  64-entry hash table of recent colors
+//   01rrggbb                DIFF   dr/dg/db in -2..1 (5/6/5-bit wraparound)
+//   10gggggg rrrrbbbb       LUMA   dg in -32..31, dr-dg / db-dg in -8..7
+//   11rrrrrr (0..61)        RUN    repeat previous color 1..62 times
+//   11111110 hi lo          RGB    literal RGB565
+constexpr uint8_t Q565_OP_INDEX = 0x00;
+constexpr uint8_t Q565_OP_DIFF = 0x40;
+constexpr uint8_t Q565_OP_LUMA = 0x80;
+constexpr uint8_t Q565_OP_RUN = 0xC0;
+constexpr uint8_t Q565_OP_RGB = 0xFE;
+constexpr uint8_t Q565_MASK = 0xC0;
+
+// Incremental decoder: bytes can be fed in arbitrary slices (an op may span
+// two feeds) and pixels land directly in the caller's buffer.
+//
+// Interlaced streams carry the pixels in Adam7 pass order. Each pixel of a
+// coarse pass also fills the cell it stands for (8x8 down to 1x2), so after
+// the first pass (1/64 of the pixels) the buffer already holds a blocky
+// preview that later passes refine in place.
+struct CoverStreamDecoder {
+  CoverFormat format;
+  bool swapBytes;     // store low byte first (panel order)
+  bool failed;
+  bool interlaced;
+  uint16_t *out;
+  int total;
+  int pos;
+  int width;
+  int height;
+  uint8_t pass;       // interlaced: current Adam7 pass (0..6)
+  int x;
+  int y;
+  uint16_t prev;
+  uint8_t pending[3];
+  uint8_t pendingLen;
+  uint16_t index[64];
+};
+
+void cover_decoder_begin(CoverStreamDecoder *dec, CoverFormat format, uint16_t *out, int pixels,
+                         bool swapBytes);
+
+// Switches a freshly begun decoder to Adam7 order for a width x height image.
+void cover_decoder_interlace(CoverStreamDecoder *dec, int width, int height);
+
+// True once the buffer shows the whole image, at least at first-pass detail.
+inline bool cover_decoder_preview_ready(const CoverStreamDecoder *dec) {
+  return dec->interlaced ? (dec->pass > 0 || dec->pos >= dec->total) : dec->pos >= dec->total;
+}
+
+// Returns false once the stream is malformed or overruns the output.
+bool cover_decoder_feed(CoverStreamDecoder *dec, const uint8_t *data, size_t len);
+
+inline bool cover_decoder_done(const CoverStreamDecoder *dec) {
+  return !dec->failed && dec->pos >= dec->total;
+}
+
+// Baseline JPEG decode through the TJpgDec copy in the ESP32-S3 ROM. The
+// decoder emits one MCU at a time; each block is point-sampled straight into
+// the outW x outH box (after TJpgDec's own 1/2..1/8 pre-scale), so the only
+// scratch memory is the fixed work pool below.
+constexpr size_t COVER_JPEG_WORK_BYTES = 3100;
+
+struct CoverJpegInfo {
+  int srcW;
+  int srcH;
+  int scale;   // TJpgDec scale exponent used (0..3)
+  int result;  // JRESULT, 0 = ok
+};
+
+bool cover_decode_jpeg(const uint8_t *data, size_t len, uint16_t *out, int outW, int outH,
+                       bool swapBytes, CoverJpegInfo *info);
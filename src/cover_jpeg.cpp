@@ -0,0 +1,85 @@
+#include "cover_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "rom/tjpgd.h"
+
+namespace {
+
+struct JpegSink {
+  const uint8_t *data;
+  size_t len;
+  size_t pos;
+  uint16_t *out;
+  int outW;
+  int outH;
+  int scaledW;
+  int scaledH;
+  bool swapBytes;
+};
+
+alignas(4) uint8_t jpegWork[COVER_JPEG_WORK_BYTES];
+
+inline int ceilDiv(int a, int b) { return (a + b - 1) / b; }
+
+UINT jpegInput(JDEC *jd, BYTE *buf, UINT nbyte) {
+  auto *sink = static_cast<JpegSink *>(jd->device);
+  size_t left = sink->len - sink->pos;
+  if (nbyte > left) nbyte = static_cast<UINT>(left);
+  if (buf) memcpy(buf, sink->data + sink->pos, nbyte);  // buf == nullptr means skip
+  sink->pos += nbyte;
+  return nbyte;
+}
+
+// Writes every output pixel whose sample point falls inside this MCU block.
+UINT jpegOutput(JDEC *jd, void *bitmap, JRECT *rect) {
+  auto *sink = static_cast<JpegSink *>(jd->device);
+  const BYTE *rgb = static_cast<const BYTE *>(bitmap);
+  int blockW = rect->right - rect->left + 1;
+  int tx0 = ceilDiv(rect->left * sink->outW, sink->scaledW);
+  int tx1 = std::min(ceilDiv((rect->right + 1) * sink->outW, sink->scaledW), sink->outW);
+  int ty0 = ceilDiv(rect->top * sink->outH, sink->scaledH);
+  int ty1 = std::min(ceilDiv((rect->bottom + 1) * sink->outH, sink->scaledH), sink->outH);
+  for (int ty = ty0; ty < ty1; ++ty) {
+    int sy = ty * sink->scaledH / sink->outH - rect->top;
+    for (int tx = tx0; tx < tx1; ++tx) {
+      int sx = tx * sink->scaledW / sink->outW - rect->left;
+      const BYTE *p = rgb + (sy * blockW + sx) * 3;
+      uint16_t px = static_cast<uint16_t>(((p[0] & 0xF8) << 8) | ((p[1] & 0xFC) << 3) | (p[2] >> 3));
+      sink->out[ty * sink->outW + tx] = sink->swapBytes ? static_cast<uint16_t>((px >> 8) | (px << 8)) : px;
+    }
+  }
+  return 1;
+}
+
+}  // namespace
+
+bool cover_decode_jpeg(const uint8_t *data, size_t len, uint16_t *out, int outW, int outH,
+                       bool swapBytes, CoverJpegInfo *info) {
+  JpegSink sink = {data, len, 0, out, outW, outH, 0, 0, swapBytes};
+  JDEC jd;
+  JRESULT res = jd_prepare(&jd, jpegInput, jpegWork, sizeof(jpegWork), &sink);
+  if (info) {
+    memset(info, 0, sizeof(*info));
+    info->result = static_cast<int>(res);
+  }
+  if (res != JDR_OK) return false;
+
+  // Largest pre-scale that still covers the output box.
+  uint8_t scale = 0;
+  while (scale < 3 && (jd.width >> (scale + 1)) >= outW && (jd.height >> (scale + 1)) >= outH) {
+    scale++;
+  }
+  sink.scaledW = std::max(jd.width >> scale, 1);
+  sink.scaledH = std::max(jd.height >> scale, 1);
+  if (info) {
+    info->srcW = jd.width;
+    info->srcH = jd.height;
+    info->scale = scale;
+  }
+
+  res = jd_decomp(&jd, jpegOutput, scale);
+  if (info) info->result = static_cast<int>(res);
+  return res == JDR_OK;
+}
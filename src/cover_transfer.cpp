@@ -0,0 +1,107 @@
+#include "cover_transfer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+uint16_t cover_crc16(const uint8_t *data, size_t len, uint16_t crc) {
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= static_cast<uint16_t>(data[i]) << 8;
+    for (int b = 0; b < 8; ++b) {
+      crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021) : static_cast<uint16_t>(crc << 1);
+    }
+  }
+  return crc;
+}
+
+int cover_hex_nibble(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
+  if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
+  return -1;
+}
+
+bool cover_xfer_begin(CoverTransfer *x, uint16_t id, CoverFormat format, int chunkBytes, int totalBytes,
+                      uint8_t *wire, uint16_t *out, int pixels, bool swapBytes) {
+  if (id == 0 || chunkBytes <= 0 || chunkBytes > COVER_XFER_CHUNK_MAX || totalBytes <= 0 ||
+      totalBytes > COVER_XFER_WIRE_MAX || (totalBytes + chunkBytes - 1) / chunkBytes > COVER_XFER_MAX_CHUNKS) {
+    return false;
+  }
+  *x = {};
+  x->id = id;
+  x->format = format;
+  x->wire = wire;
+  x->chunkBytes = chunkBytes;
+  x->chunkCount = (totalBytes + chunkBytes - 1) / chunkBytes;
+  x->totalBytes = totalBytes;
+  x->ackPending = true;  // ack 0 tells the PC windowed mode is supported
+  cover_decoder_begin(&x->decoder, format, out, pixels, swapBytes);
+  return true;
+}
+
+CoverChunkResult cover_xfer_chunk(CoverTransfer *x, const char *args) {
+  unsigned xfer = 0;
+  int idx = -1;
+  unsigned crc = 0;
+  int consumed = 0;
+  if (sscanf(args, "%u %d %x %n", &xfer, &idx, &crc, &consumed) < 3 || consumed == 0) return COVER_CHUNK_STALE;
+  // Chunks from an aborted or superseded transfer are dropped silently.
+  if (x->id == 0 || xfer != x->id) return COVER_CHUNK_STALE;
+  if (idx < 0 || idx >= x->chunkCount) return COVER_CHUNK_STALE;
+  x->ackPending = true;
+  if (x->seen[idx]) return COVER_CHUNK_DUP;
+
+  const char *hex = args + consumed;
+  int offset = idx * x->chunkBytes;
+  int bytes = std::min(x->chunkBytes, x->totalBytes - offset);
+  if (bytes <= 0 || static_cast<int>(strlen(hex)) < bytes * 2) {
+    x->crcErrors++;
+    return COVER_CHUNK_BAD;
+  }
+  uint8_t chunk[COVER_XFER_CHUNK_MAX];
+  for (int i = 0; i < bytes; ++i) {
+    int hi = cover_hex_nibble(hex[i * 2]);
+    int lo = cover_hex_nibble(hex[i * 2 + 1]);
+    if (hi < 0 || lo < 0) {
+      x->crcErrors++;
+      return COVER_CHUNK_BAD;
+    }
+    chunk[i] = static_cast<uint8_t>((hi << 4) | lo);
+  }
+  if (cover_crc16(chunk, static_cast<size_t>(bytes), 0xFFFF) != static_cast<uint16_t>(crc)) {
+    x->crcErrors++;
+    return COVER_CHUNK_BAD;
+  }
+  memcpy(&x->wire[offset], chunk, static_cast<size_t>(bytes));
+  x->seen[idx] = true;
+  x->received++;
+  while (x->cumulative < x->chunkCount && x->seen[x->cumulative]) x->cumulative++;
+
+  // Feed the newly contiguous prefix to the decoder. TJpgDec pulls the whole
+  // file at the end, so JPEG only tracks progress.
+  int contiguous = std::min(x->cumulative * x->chunkBytes, x->totalBytes);
+  if (x->format != COVER_FMT_JPEG && contiguous > x->fedBytes &&
+      !cover_decoder_feed(&x->decoder, &x->wire[x->fedBytes], static_cast<size_t>(contiguous - x->fedBytes))) {
+    return COVER_CHUNK_CORRUPT;
+  }
+  x->fedBytes = contiguous;
+  return x->cumulative >= x->chunkCount ? COVER_CHUNK_COMPLETE : COVER_CHUNK_STORED;
+}
+
+uint32_t cover_xfer_sack(const CoverTransfer *x) {
+  uint32_t sack = 0;
+  for (int b = 0; b < 32; ++b) {
+    int idx = x->cumulative + 1 + b;
+    if (idx >= x->chunkCount) break;
+    if (x->seen[idx]) sack |= (1u << b);
+  }
+  return sack;
+}
+
+bool cover_xfer_ack_line(CoverTransfer *x, char *out, size_t len) {
+  if (!x->ackPending || x->id == 0) return false;
+  x->ackPending = false;
+  snprintf(out, len, "COV ACK %u %d %08X", static_cast<unsigned>(x->id), x->cumulative,
+           static_cast<unsigned>(cover_xfer_sack(x)));
+  return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cover_codec.h"
+
+// Receiving side of the windowed cover transfer: PC sends indexed, CRC-checked
+// chunks of the encoded cover byte stream (NP COV CHK <xfer> <idx> <crc> <hex>)
+// and the device answers with a cumulative ack plus a 32-chunk selective-ack
+// mask (COV ACK <xfer> <cum> <sack>; bit b stands for chunk cum+1+b). Chunks
+// are staged by index in the caller's wire buffer and fed to the streaming
+// decoder in order, so pixels land in the output as the window advances.
+// JPEG payloads are only staged; the caller decodes them once complete.
+constexpr int COVER_XFER_MAX_CHUNKS = 64;
+constexpr int COVER_XFER_CHUNK_MAX = 128;
+constexpr int COVER_XFER_WIRE_MAX = COVER_XFER_MAX_CHUNKS * COVER_XFER_CHUNK_MAX;
+
+struct CoverTransfer {
+  uint16_t id;          // 0 = legacy NP COV DATA streaming
+  CoverFormat format;
+  uint8_t *wire;        // COVER_XFER_WIRE_MAX bytes, owned by the caller
+  int chunkBytes;
+  int chunkCount;
+  int totalBytes;
+  int fedBytes;
+  int received;
+  int cumulative;
+  bool ackPending;
+  uint32_t crcErrors;
+  uint64_t beginUs;
+  uint32_t previewUs;   // time to the first displayable (interlaced) preview
+  bool seen[COVER_XFER_MAX_CHUNKS];
+  CoverStreamDecoder decoder;
+};
+
+enum CoverChunkResult : uint8_t {
+  COVER_CHUNK_STALE,     // other transfer or index out of range
+  COVER_CHUNK_DUP,       // already staged; only re-acks
+  COVER_CHUNK_BAD,       // truncated, bad hex or CRC mismatch (counted)
+  COVER_CHUNK_STORED,    // staged, contiguous prefix fed to the decoder
+  COVER_CHUNK_CORRUPT,   // decoder rejected the stream
+  COVER_CHUNK_COMPLETE,  // last missing chunk staged
+};
+
+// CRC-16/CCITT (poly 0x1021), the per-chunk check the PC computes from 0xFFFF.
+uint16_t cover_crc16(const uint8_t *data, size_t len, uint16_t crc);
+
+int cover_hex_nibble(char c);
+
+// Fails (leaving `x` untouched) when the payload does not fit the window.
+bool cover_xfer_begin(CoverTransfer *x, uint16_t id, CoverFormat format, int chunkBytes, int totalBytes,
+                      uint8_t *wire, uint16_t *out, int pixels, bool swapBytes);
+
+// `args` is the text after "NP COV CHK ".
+CoverChunkResult cover_xfer_chunk(CoverTransfer *x, const char *args);
+
+// Selective-ack mask for the chunks past the cumulative point.
+uint32_t cover_xfer_sack(const CoverTransfer *x);
+
+// Writes "COV ACK ..." and clears ackPending; false when no ack is due.
+bool cover_xfer_ack_line(CoverTransfer *x, char *out, size_t len);
@@ -0,0 +1,162 @@
+#include "device_menu.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+#include "astra/config/config.h"
+
+using astra::Menu;
+
+namespace {
+
+void setRowTitle(DeviceRow *row, const SpeakerEntry &entry, int currentId) {
+  // assign() keeps the row's buffer, so a retitle only allocates when a name grows.
+  row->title.assign(entry.id == currentId ? "* " : "");
+  row->title.append(entry.name);
+}
+
+// Parks a row at slot `index`. `fresh` rows appear in place; kept rows slide
+// from where they were.
+void placeRow(Menu *menu, Menu *item, size_t index, bool fresh) {
+  const astra::config &cfg = astra::getUIConfig();
+  item->parent = menu;
+  item->position.x = item->position.xTrg = cfg.listTextMargin;
+  item->position.yTrg = static_cast<float>(index) * cfg.listLineHeight;
+  if (fresh) item->position.y = item->position.yTrg;
+}
+
+DeviceRow *findRow(const DeviceRowPool *pool, const DeviceMenu &ui, int id, size_t *index) {
+  auto &rows = ui.menu->childMenu;
+  for (size_t i = 0; i < rows.size(); ++i) {
+    if (device_row_id(pool, rows[i], ui.menu) == id) {
+      if (index) *index = i;
+      return static_cast<DeviceRow *>(rows[i]);
+    }
+  }
+  return nullptr;
+}
+
+void releaseRow(DeviceRowPool *pool, DeviceRow *row) {
+  row->id = -1;
+  row->parent = nullptr;
+  pool->free[pool->freeCount++] = row;
+}
+
+}  // namespace
+
+void device_rows_init(DeviceRowPool *pool, void *storage) {
+  pool->rows = static_cast<DeviceRow *>(storage);
+  for (size_t i = 0; i < DEVICE_ROW_POOL; ++i) new (&pool->rows[i]) DeviceRow();
+  for (size_t i = 0; i < DEVICE_ROW_POOL; ++i) pool->free[i] = &pool->rows[DEVICE_ROW_POOL - 1 - i];
+  pool->freeCount = DEVICE_ROW_POOL;
+}
+
+int device_row_id(const DeviceRowPool *pool, const Menu *item, const Menu *menu) {
+  auto addr = reinterpret_cast<uintptr_t>(item);
+  auto first = reinterpret_cast<uintptr_t>(pool->rows);
+  if (!pool->rows || addr < first || addr >= first + DEVICE_ROW_POOL_BYTES) return -1;
+  auto *row = static_cast<const DeviceRow *>(item);
+  return row->parent == menu ? row->id : -1;
+}
+
+bool device_menu_sync(DeviceRowPool *pool, const DeviceMenu &ui, const std::vector<SpeakerEntry> &entries,
+                      int currentId, bool loading) {
+  auto &rows = ui.menu->childMenu;
+  Menu *selected = ui.menu->selectIndex < rows.size() ? rows[ui.menu->selectIndex] : nullptr;
+
+  DeviceRow **previous = pool->scratch;
+  size_t previousCount = 0;
+  for (Menu *item : rows) {
+    if (device_row_id(pool, item, ui.menu) >= 0) previous[previousCount++] = static_cast<DeviceRow *>(item);
+  }
+
+  rows.clear();  // keeps capacity
+  ui.menu->childWidget.clear();
+  auto place = [&](Menu *item, bool fresh) {
+    placeRow(ui.menu, item, rows.size(), fresh);
+    rows.push_back(item);
+  };
+  bool complete = true;
+  place(ui.refreshItem, false);
+  if (loading) {
+    place(ui.loadingItem, selected != ui.loadingItem);
+  } else if (entries.empty()) {
+    place(ui.emptyItem, selected != ui.emptyItem);
+  } else {
+    for (size_t i = 0; i < entries.size(); ++i) {
+      const SpeakerEntry &entry = entries[i];
+      // Same slot first: plain updates keep the order, so the scan rarely runs.
+      size_t found = previousCount;
+      if (i < previousCount && previous[i] && previous[i]->id == entry.id) {
+        found = i;
+      } else {
+        for (size_t j = 0; j < previousCount; ++j) {
+          if (previous[j] && previous[j]->id == entry.id) {
+            found = j;
+            break;
+          }
+        }
+      }
+      DeviceRow *row = nullptr;
+      if (found < previousCount) {
+        row = previous[found];
+        previous[found] = nullptr;
+      } else if (pool->freeCount > 0) {
+        row = pool->free[--pool->freeCount];
+        row->id = entry.id;
+      } else {
+        complete = false;
+        break;
+      }
+      setRowTitle(row, entry, currentId);
+      place(row, found == previousCount);
+    }
+  }
+  for (size_t j = 0; j < previousCount; ++j) {
+    if (previous[j]) releaseRow(pool, previous[j]);
+  }
+
+  auto kept = std::find(rows.begin(), rows.end(), selected);
+  if (kept != rows.end()) {
+    ui.menu->selectIndex = static_cast<uint16_t>(kept - rows.begin());
+  } else if (ui.menu->selectIndex >= rows.size()) {
+    ui.menu->selectIndex = static_cast<uint16_t>(rows.size() - 1);
+  }
+  return complete;
+}
+
+bool device_menu_add(DeviceRowPool *pool, const DeviceMenu &ui, const SpeakerEntry &entry, int currentId) {
+  auto &rows = ui.menu->childMenu;
+  // The first entry replaces the "No devices" row.
+  if (pool->freeCount == 0 || std::find(rows.begin(), rows.end(), ui.emptyItem) != rows.end()) return false;
+  DeviceRow *row = pool->free[--pool->freeCount];
+  row->id = entry.id;
+  setRowTitle(row, entry, currentId);
+  placeRow(ui.menu, row, rows.size(), true);
+  rows.push_back(row);
+  return true;
+}
+
+bool device_menu_remove(DeviceRowPool *pool, const DeviceMenu &ui, int id) {
+  auto &rows = ui.menu->childMenu;
+  size_t index = 0;
+  DeviceRow *row = findRow(pool, ui, id, &index);
+  if (!row) return false;
+  size_t deviceRows = 0;
+  for (Menu *item : rows) {
+    if (device_row_id(pool, item, ui.menu) >= 0) deviceRows++;
+  }
+  if (deviceRows == 1) return false;  // the last one gives way to "No devices"
+  rows.erase(rows.begin() + static_cast<std::ptrdiff_t>(index));
+  releaseRow(pool, row);
+  for (size_t i = index; i < rows.size(); ++i) placeRow(ui.menu, rows[i], i, false);
+  // Selection stays on the same entry, or moves to the row taking its place.
+  if (ui.menu->selectIndex > index || ui.menu->selectIndex >= rows.size()) ui.menu->selectIndex--;
+  return true;
+}
+
+void device_menu_retitle(const DeviceRowPool *pool, const DeviceMenu &ui, const SpeakerEntry &entry,
+                         int currentId) {
+  if (DeviceRow *row = findRow(pool, ui, entry.id, nullptr)) setRowTitle(row, entry, currentId);
+}
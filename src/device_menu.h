@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "astra/ui/item/menu/menu.h"
+
+// Speaker/microphone menus built from the PC endpoint lists. Rows come from
+// one fixed pool shared by both lists and go back to it when a device
+// disappears, so list updates never touch the heap (a retitle only allocates
+// when a name outgrows its row's buffer). A row carries its endpoint id, which
+// makes menu -> id a range check.
+struct SpeakerEntry {
+  int id;
+  std::string name;
+};
+
+struct DeviceRow : public astra::List {
+  DeviceRow() {
+    // List rows never draw the tile picture; drop the 2 x 120 B default.
+    pic.clear();
+    pic.shrink_to_fit();
+    picDefault.clear();
+    picDefault.shrink_to_fit();
+  }
+  int id = -1;
+};
+
+constexpr size_t DEVICE_ROW_POOL = 256;  // shared by both lists
+constexpr size_t DEVICE_ROW_POOL_BYTES = DEVICE_ROW_POOL * sizeof(DeviceRow);
+
+struct DeviceRowPool {
+  DeviceRow *rows;
+  DeviceRow *free[DEVICE_ROW_POOL];
+  size_t freeCount;
+  DeviceRow *scratch[DEVICE_ROW_POOL];  // rows being matched during a sync
+};
+
+// Constructs the rows in `storage` (DEVICE_ROW_POOL_BYTES, aligned for
+// DeviceRow). The rows live for the whole run and are never destroyed.
+void device_rows_init(DeviceRowPool *pool, void *storage);
+
+// The fixed rows of one list menu around the pooled device rows.
+struct DeviceMenu {
+  astra::Menu *menu;
+  astra::Menu *refreshItem;
+  astra::Menu *loadingItem;
+  astra::Menu *emptyItem;
+};
+
+// Endpoint id of a pooled row under `menu`, or -1 for anything else.
+int device_row_id(const DeviceRowPool *pool, const astra::Menu *item, const astra::Menu *menu);
+
+// Brings the menu in line with `entries`: rows whose id is still listed are
+// kept (and slide to their new slot), others return to the pool, new ids take
+// a pooled row. Selection follows the selected row. Returns false when the
+// pool ran out and the list was cut short.
+bool device_menu_sync(DeviceRowPool *pool, const DeviceMenu &ui, const std::vector<SpeakerEntry> &entries,
+                      int currentId, bool loading);
+
+// Single-row edits for list deltas, applied after the caller updated its
+// entries. add/remove return false when the change needs a full sync
+// (first or last entry, pool exhausted, row not shown).
+bool device_menu_add(DeviceRowPool *pool, const DeviceMenu &ui, const SpeakerEntry &entry, int currentId);
+bool device_menu_remove(DeviceRowPool *pool, const DeviceMenu &ui, int id);
+void device_menu_retitle(const DeviceRowPool *pool, const DeviceMenu &ui, const SpeakerEntry &entry,
+                         int currentId);
@@ -22,6 +22,13 @@
 #include "u8x8.h"
 #include "hal/lcd_types.h"
 
+// Exported by u8g2_font.c but not declared in u8g2.h; shaped text keeps the
+// glyph data pointer so drawing skips the per-character font search.
+extern "C" {
+const uint8_t *u8g2_font_get_glyph_data(u8g2_t *u8g2, uint16_t encoding);
+int8_t u8g2_font_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data);
+}
+
 namespace {
 // Base config: 320x240 ST7789 (landscape).
 constexpr int SCREEN_W = 320;
@@ -44,6 +51,13 @@ constexpr bool TFT_INVERT = false;
 constexpr bool TFT_SWAP_XY = true;
 constexpr bool TFT_MIRROR_X = true;
 constexpr bool TFT_MIRROR_Y = false;
+// ST7789 GRAM is 240 columns by 320 gate lines; hardware scrolling runs along
+// the gate lines.
+constexpr int TFT_NATIVE_COLS = 240;
+constexpr int TFT_NATIVE_ROWS = 320;
+static_assert((TFT_SWAP_XY ? SCREEN_H : SCREEN_W) <= TFT_NATIVE_COLS &&
+                  (TFT_SWAP_XY ? SCREEN_W : SCREEN_H) <= TFT_NATIVE_ROWS,
+              "screen does not fit the panel GRAM");
 
 constexpr int SPI_HZ_MIN = 1000000;
 constexpr int SPI_HZ_MAX = 80000000;
@@ -178,6 +192,10 @@ HALAstraESP32::~HALAstraESP32() {
     free(framebuf);
     framebuf = nullptr;
   }
+  if (canvasSnapshotBuf) {
+    free(canvasSnapshotBuf);
+    canvasSnapshotBuf = nullptr;
+  }
 }
 
 void HALAstraESP32::init() {
@@ -367,6 +385,9 @@ bool HALAstraESP32::init_display() {
   esp_lcd_panel_invert_color(reinterpret_cast<esp_lcd_panel_handle_t>(panel), TFT_INVERT);
   esp_lcd_panel_swap_xy(reinterpret_cast<esp_lcd_panel_handle_t>(panel), TFT_SWAP_XY);
   esp_lcd_panel_mirror(reinterpret_cast<esp_lcd_panel_handle_t>(panel), TFT_MIRROR_X, TFT_MIRROR_Y);
+  panel_scroll_init(&panelScroll, {TFT_NATIVE_COLS, TFT_NATIVE_ROWS, TFT_GAP_X, TFT_GAP_Y, TFT_SWAP_XY,
+                                   TFT_MIRROR_X, TFT_MIRROR_Y});
+  sendScrollState();
   esp_lcd_panel_disp_on_off(reinterpret_cast<esp_lcd_panel_handle_t>(panel), true);
 
   return true;
@@ -794,8 +815,8 @@ void HALAstraESP32::clearBarOverlay() {
   barOverlay.enabled = false;
 }
 
-void HALAstraESP32::setStatusBar(const std::string &text, bool linkReady, bool alertBlink) {
-  statusBarText = text;
+void HALAstraESP32::setStatusBar(std::string_view text, bool linkReady, bool alertBlink) {
+  if (statusBarText != text) statusBarText.assign(text);
   statusBarLinkReady = linkReady;
   statusBarAlertBlink = alertBlink;
 }
@@ -909,40 +930,122 @@ unsigned char HALAstraESP32::_getBufferTileWidth() {
   return static_cast<unsigned char>(tile_width);
 }
 
+void HALAstraESP32::expandCanvasRow(int ly) {
+  static const uint8_t kNoFadeAnd[2] = {0xFF, 0xFF};
+  static const uint8_t kNoFadeOr[2] = {0x00, 0x00};
+  const int tile_y = ly >> 3;
+  const uint8_t mask = static_cast<uint8_t>(1u << (ly & 7));
+  const uint8_t *row_tiles = u8g2_buf + (tile_y * tile_width * 8);
+  // The status bar keeps its pixels while a page fades.
+  const uint8_t *rowAnd = ly < STATUS_BAR_H ? kNoFadeAnd : fadeAnd;
+  const uint8_t *rowOr = ly < STATUS_BAR_H ? kNoFadeOr : fadeOr;
+  int filled = 0;
+  for (int tile_x = 0; tile_x < tile_width; ++tile_x) {
+    const uint8_t *tile = row_tiles + tile_x * 8;
+    for (int col = 0; col < 8; ++col) {
+      const int lx = tile_x * 8 + col;
+      if (lx >= LOGICAL_W) break;
+      const int start = lx * UI_SCALE;
+      if (start >= SCREEN_W) break;
+      const int end = std::min(start + UI_SCALE, SCREEN_W);
+      const uint8_t bits = (tile[col] & rowAnd[col & 1]) | rowOr[col & 1];
+      uint16_t color = (bits & mask) ? fgColor : COLOR_BG;
+      for (int sx = start; sx < end; ++sx) {
+        linebuf[sx] = color;
+      }
+      filled = end;
+    }
+  }
+  for (int sx = filled; sx < SCREEN_W; ++sx) {
+    linebuf[sx] = COLOR_BG;
+  }
+}
+
+void HALAstraESP32::flushCanvasRows(int ly0, int ly1) {
+  // Once the panel is scrolled, rows go to the addresses that show up at
+  // their glass position (canvasScroll only scrolls along y).
+  const bool shifted = panel_scroll_shifted(&panelScroll);
+  auto rowAddress = [&](int y) { return shifted ? panel_scroll_address(&panelScroll, y) : y; };
+  if (displayConfig.use_framebuffer && framebuf) {
+    // framebuf holds the last frame sent, in panel address order, so only
+    // these rows change in it.
+    const int y0 = ly0 * UI_SCALE;
+    const int y1 = std::min(ly1 * UI_SCALE, SCREEN_H);
+    for (int ly = ly0; ly < ly1; ++ly) {
+      expandCanvasRow(ly);
+      const int base_y = ly * UI_SCALE;
+      const int y_end = std::min(base_y + UI_SCALE, SCREEN_H);
+      for (int y = base_y; y < y_end; ++y) {
+        uint16_t *row = framebuf + rowAddress(y) * SCREEN_W;
+        memcpy(row, linebuf, SCREEN_W * sizeof(uint16_t));
+        drawArcOverlayLine(y, row, SCREEN_W);
+        drawImageOverlayLine(y, row, SCREEN_W);
+        drawBarOverlayLine(y, row, SCREEN_W);
+      }
+    }
+    if (y1 <= y0) return;
+    // One band per run of consecutive addresses: a single band unless the
+    // rows wrap around the scroll area.
+    auto sendBand = [&](int a0, int a1) {
+      s_flush_busy = true;
+      esp_lcd_panel_draw_bitmap(reinterpret_cast<esp_lcd_panel_handle_t>(panel),
+                                0, a0, SCREEN_W, a1, framebuf + a0 * SCREEN_W);
+      while (s_flush_busy) {
+        vTaskDelay(pdMS_TO_TICKS(1));
+      }
+      flushedBytes += static_cast<uint32_t>((a1 - a0) * SCREEN_W * sizeof(uint16_t));
+    };
+    int bandStart = rowAddress(y0);
+    int bandEnd = bandStart + 1;
+    for (int y = y0 + 1; y < y1; ++y) {
+      const int a = rowAddress(y);
+      if (a != bandEnd) {
+        sendBand(bandStart, bandEnd);
+        bandStart = a;
+      }
+      bandEnd = a + 1;
+    }
+    sendBand(bandStart, bandEnd);
+  } else {
+    for (int ly = ly0; ly < ly1; ++ly) {
+      expandCanvasRow(ly);
+      const int base_y = ly * UI_SCALE;
+      const int y_end = std::min(base_y + UI_SCALE, SCREEN_H);
+      for (int y = base_y; y < y_end; ++y) {
+        drawArcOverlayLine(y, linebuf, SCREEN_W);
+        drawImageOverlayLine(y, linebuf, SCREEN_W);
+        drawBarOverlayLine(y, linebuf, SCREEN_W);
+        const int a = rowAddress(y);
+        s_flush_busy = true;
+        esp_lcd_panel_draw_bitmap(reinterpret_cast<esp_lcd_panel_handle_t>(panel),
+                                  0, a, SCREEN_W, a + 1, linebuf);
+        while (s_flush_busy) {
+          vTaskDelay(pdMS_TO_TICKS(1));
+        }
+        flushedBytes += SCREEN_W * sizeof(uint16_t);
+      }
+    }
+  }
+}
+
 void HALAstraESP32::_canvasUpdate() {
   if (!u8g2_buf || !linebuf || !panel) return;
 
-  const uint8_t *buf = u8g2_buf;
   if (displayMutex) xSemaphoreTake(displayMutex, portMAX_DELAY);
   drawStatusBar();
 
+  // A full frame rewrites all of GRAM, so a scrolled panel goes back to its
+  // origin and still takes the frame as one window.
+  if (panel_scroll_shifted(&panelScroll)) {
+    panel_scroll_rewind(&panelScroll);
+    sendScrollState();
+  }
   if (displayConfig.use_framebuffer && framebuf) {
     // Render to back buffer if double buffering is enabled
     uint16_t *render_target = (displayConfig.use_double_buffer && backbuf) ? backbuf : framebuf;
     
     for (int ly = 0; ly < LOGICAL_H; ++ly) {
-      const int tile_y = ly >> 3;
-      const uint8_t mask = static_cast<uint8_t>(1u << (ly & 7));
-      const uint8_t *row_tiles = buf + (tile_y * tile_width * 8);
-      int filled = 0;
-      for (int tile_x = 0; tile_x < tile_width; ++tile_x) {
-        const uint8_t *tile = row_tiles + tile_x * 8;
-        for (int col = 0; col < 8; ++col) {
-          const int lx = tile_x * 8 + col;
-          if (lx >= LOGICAL_W) break;
-          const int start = lx * UI_SCALE;
-          if (start >= SCREEN_W) break;
-          const int end = std::min(start + UI_SCALE, SCREEN_W);
-          uint16_t color = (tile[col] & mask) ? fgColor : COLOR_BG;
-          for (int sx = start; sx < end; ++sx) {
-            linebuf[sx] = color;
-          }
-          filled = end;
-        }
-      }
-      for (int sx = filled; sx < SCREEN_W; ++sx) {
-        linebuf[sx] = COLOR_BG;
-      }
+      expandCanvasRow(ly);
       const int base_y = ly * UI_SCALE;
       const int y_end = std::min(base_y + UI_SCALE, SCREEN_H);
       for (int y = base_y; y < y_end; ++y) {
@@ -975,61 +1078,115 @@ void HALAstraESP32::_canvasUpdate() {
     while (s_flush_busy) {
       vTaskDelay(pdMS_TO_TICKS(1));
     }
+    flushedBytes += SCREEN_W * SCREEN_H * sizeof(uint16_t);
   } else {
-    for (int ly = 0; ly < LOGICAL_H; ++ly) {
-      const int tile_y = ly >> 3;
-      const uint8_t mask = static_cast<uint8_t>(1u << (ly & 7));
-      const uint8_t *row_tiles = buf + (tile_y * tile_width * 8);
-      int filled = 0;
-      for (int tile_x = 0; tile_x < tile_width; ++tile_x) {
-        const uint8_t *tile = row_tiles + tile_x * 8;
-        for (int col = 0; col < 8; ++col) {
-          const int lx = tile_x * 8 + col;
-          if (lx >= LOGICAL_W) break;
-          const int start = lx * UI_SCALE;
-          if (start >= SCREEN_W) break;
-          const int end = std::min(start + UI_SCALE, SCREEN_W);
-          uint16_t color = (tile[col] & mask) ? fgColor : COLOR_BG;
-          for (int sx = start; sx < end; ++sx) {
-            linebuf[sx] = color;
-          }
-          filled = end;
-        }
-      }
-      for (int sx = filled; sx < SCREEN_W; ++sx) {
-        linebuf[sx] = COLOR_BG;
-      }
-      const int base_y = ly * UI_SCALE;
-      const int y_end = std::min(base_y + UI_SCALE, SCREEN_H);
-      for (int y = base_y; y < y_end; ++y) {
-        drawArcOverlayLine(y, linebuf, SCREEN_W);
-        drawImageOverlayLine(y, linebuf, SCREEN_W);
-        drawBarOverlayLine(y, linebuf, SCREEN_W);
-        s_flush_busy = true;
-        esp_lcd_panel_draw_bitmap(reinterpret_cast<esp_lcd_panel_handle_t>(panel),
-                                  0, y, SCREEN_W, y + 1, linebuf);
-        while (s_flush_busy) {
-          vTaskDelay(pdMS_TO_TICKS(1));
-        }
-      }
-    }
+    flushCanvasRows(0, LOGICAL_H);
   }
+  _setCanvasFade(0, false);
+  if (displayMutex) xSemaphoreGive(displayMutex);
+}
+
+void HALAstraESP32::sendScrollState() {
+  if (!panel_io) return;
+  uint8_t area[6];
+  uint8_t start[2];
+  panel_scroll_area_params(&panelScroll, area);
+  panel_scroll_start_params(&panelScroll, start);
+  auto io = reinterpret_cast<esp_lcd_panel_io_handle_t>(panel_io);
+  esp_lcd_panel_io_tx_param(io, PANEL_CMD_VSCRDEF, area, sizeof(area));
+  esp_lcd_panel_io_tx_param(io, PANEL_CMD_VSCSAD, start, sizeof(start));
+}
+
+bool HALAstraESP32::canvasScroll(int lo, int hi, int delta) {
+  if (!u8g2_buf || !linebuf || !panel) return false;
+  // Landscape panels (TFT_SWAP_XY, the shipped board) scroll along UI x,
+  // which nothing in the UI does.
+  if (!panel_scroll_axis_is_y(&panelScroll)) return false;
+  // Overlays are pinned to the glass; scrolling would drag them along.
+  if (arcOverlay.enabled || imageOverlay.enabled || barOverlay.enabled) return false;
+  // Canvas UI coordinates to screen rows.
+  const int areaLo = std::max(0, (lo + STATUS_BAR_H) * UI_SCALE);
+  const int areaHi = std::min(SCREEN_H, (hi + STATUS_BAR_H) * UI_SCALE);
+  if (areaHi - areaLo < 2) return false;
+
+  if (displayMutex) xSemaphoreTake(displayMutex, portMAX_DELAY);
+  drawStatusBar();
+  if (panelScroll.areaLo != areaLo || panelScroll.areaHi != areaHi) {
+    // A new area starts at its origin, so GRAM gets the whole frame again.
+    panel_scroll_set_area(&panelScroll, areaLo, areaHi);
+    sendScrollState();
+    flushCanvasRows(0, LOGICAL_H);
+  } else {
+    const int step = delta * UI_SCALE;
+    int e0, e1;
+    panel_scroll_by(&panelScroll, step, &e0, &e1);
+    if (step != 0) sendScrollState();
+    if (e1 > e0) flushCanvasRows(e0 / UI_SCALE, (e1 + UI_SCALE - 1) / UI_SCALE);
+    // Fixed on the glass; resent since its text changes.
+    flushCanvasRows(0, STATUS_BAR_H);
+  }
+  _setCanvasFade(0, false);
+  if (displayMutex) xSemaphoreGive(displayMutex);
+  return true;
+}
+
+void HALAstraESP32::_canvasUpdateRegion(float _y, float _h) {
+  if (!u8g2_buf || !linebuf || !panel) return;
+
+  if (displayMutex) xSemaphoreTake(displayMutex, portMAX_DELAY);
+  drawStatusBar();
+  // Canvas coordinates start below the status bar, which is always resent.
+  const int ly0 = std::max(STATUS_BAR_H, static_cast<int>(std::floor(_y)) + STATUS_BAR_H);
+  const int ly1 = std::min(LOGICAL_H, static_cast<int>(std::ceil(_y + _h)) + STATUS_BAR_H);
+  flushCanvasRows(0, STATUS_BAR_H);
+  if (ly1 > ly0) flushCanvasRows(ly0, ly1);
+  _setCanvasFade(0, false);
   if (displayMutex) xSemaphoreGive(displayMutex);
 }
 
+bool HALAstraESP32::_canvasSnapshot() {
+  if (!u8g2_buf) return false;
+  const size_t size = tile_width * tile_height * 8;
+  if (!canvasSnapshotBuf) canvasSnapshotBuf = static_cast<uint8_t *>(malloc(size));
+  if (!canvasSnapshotBuf) return false;
+  memcpy(canvasSnapshotBuf, u8g2_buf, size);
+  return true;
+}
+
+bool HALAstraESP32::_canvasRestore() {
+  if (!u8g2_buf || !canvasSnapshotBuf) return false;
+  memcpy(u8g2_buf, canvasSnapshotBuf, tile_width * tile_height * 8);
+  return true;
+}
+
+uint32_t HALAstraESP32::takeFlushedBytes() {
+  uint32_t bytes = flushedBytes;
+  flushedBytes = 0;
+  return bytes;
+}
+
 void HALAstraESP32::_canvasClear() {
   if (!u8g2_buf) return;
   memset(u8g2_buf, 0x00, tile_width * tile_height * 8);
 }
 
+void HALAstraESP32::_setCanvasFade(unsigned char _level, bool _toSet) {
+  if (_level > FADE_LEVELS) _level = FADE_LEVELS;
+  for (int i = 0; i < 2; ++i) {
+    fadeAnd[i] = _toSet ? 0xFF : FADE_MASK[_level][i];
+    fadeOr[i] = _toSet ? static_cast<uint8_t>(~FADE_MASK[_level][i]) : 0x00;
+  }
+}
+
 void HALAstraESP32::_setFont(const unsigned char *_font) {
   u8g2_SetFontMode(&u8g2, 1);
   u8g2_SetFontDirection(&u8g2, 0);
   u8g2_SetFont(&u8g2, _font);
 }
 
-unsigned char HALAstraESP32::_getFontWidth(std::string &_text) {
-  return u8g2_GetUTF8Width(&u8g2, _text.c_str());
+unsigned char HALAstraESP32::_getFontWidth(std::string_view _text) {
+  char buf[TEXT_MAX + 1];
+  return u8g2_GetUTF8Width(&u8g2, terminate(_text, buf));
 }
 
 unsigned char HALAstraESP32::_getFontHeight() {
@@ -1055,18 +1212,139 @@ void HALAstraESP32::_drawCircle(float _x, float _y, float _r) {
                   U8G2_DRAW_ALL);
 }
 
-void HALAstraESP32::_drawEnglish(float _x, float _y, const std::string &_text) {
+void HALAstraESP32::_drawEnglish(float _x, float _y, std::string_view _text) {
+  char buf[TEXT_MAX + 1];
   u8g2_DrawStr(&u8g2,
                static_cast<int16_t>(std::round(_x)),
                static_cast<int16_t>(std::round(_y)) + STATUS_BAR_H,
-               _text.c_str());
+               terminate(_text, buf));
 }
 
-void HALAstraESP32::_drawChinese(float _x, float _y, const std::string &_text) {
+void HALAstraESP32::_drawChinese(float _x, float _y, std::string_view _text) {
+  char buf[TEXT_MAX + 1];
   u8g2_DrawUTF8(&u8g2,
                 static_cast<int16_t>(std::round(_x)),
                 static_cast<int16_t>(std::round(_y)) + STATUS_BAR_H,
-                _text.c_str());
+                terminate(_text, buf));
+}
+
+void HALAstraESP32::_shapeText(std::string_view _text, ShapedText &_out) {
+  _out.count = 0;
+  _out.width = 0;
+  const uint8_t *fallback = u8g2_font_get_glyph_data(&u8g2, '?');
+  int width = 0;
+  int8_t lastDx = 0;
+  size_t i = 0;
+  while (i < _text.size() && _out.count < SHAPED_MAX) {
+    const uint8_t lead = static_cast<uint8_t>(_text[i]);
+    int extra = lead < 0x80 ? 0 : (lead >> 5) == 0x06 ? 1 : (lead >> 4) == 0x0E ? 2 : (lead >> 3) == 0x1E ? 3 : -1;
+    uint32_t cp = extra == 0 ? lead : extra == 1 ? (lead & 0x1F) : extra == 2 ? (lead & 0x0F) : (lead & 0x07);
+    size_t used = 1;
+    for (int k = 0; k < extra; ++k, ++used) {
+      if (i + used >= _text.size() || (static_cast<uint8_t>(_text[i + used]) & 0xC0) != 0x80) {
+        extra = -1;  // truncated sequence
+        break;
+      }
+      cp = (cp << 6) | (static_cast<uint8_t>(_text[i + used]) & 0x3F);
+    }
+    i += used;
+    if (extra >= 0 && cp < 0x20) continue;  // control characters draw nothing
+    uint16_t encoding = (extra < 0 || cp > 0xFFFF) ? '?' : static_cast<uint16_t>(cp);
+    const uint8_t *data = u8g2_font_get_glyph_data(&u8g2, encoding);
+    if (!data) {
+      data = fallback;
+      encoding = '?';
+    }
+    if (!data) continue;
+    lastDx = u8g2_GetGlyphWidth(&u8g2, encoding);
+    _out.glyphs[_out.count++] = {data, lastDx};
+    width += lastDx;
+  }
+  // Same as u8g2_GetUTF8Width: the last glyph counts its ink, not its advance.
+  if (_out.count > 0 && u8g2.font_decode.glyph_width != 0) {
+    width += u8g2.font_decode.glyph_width + u8g2.glyph_x_offset - lastDx;
+  }
+  _out.width = static_cast<int16_t>(width);
+}
+
+void HALAstraESP32::drawGlyphRun(int x, int baseline, const ShapedText &text, uint16_t first, uint16_t end) {
+  const u8g2_uint_t y = static_cast<u8g2_uint_t>(baseline + u8g2.font_calc_vref(&u8g2));
+  // Glyphs never reach far past their advance; this margin keeps overhangs.
+  constexpr int kInkMargin = 8;
+  for (uint16_t i = first; i < end; ++i) {
+    const Glyph &g = text.glyphs[i];
+    if (x >= LOGICAL_W + kInkMargin) break;
+    if (x + g.advance + kInkMargin > 0) {
+      u8g2.font_decode.target_x = static_cast<u8g2_uint_t>(x);
+      u8g2.font_decode.target_y = y;
+      u8g2_font_decode_glyph(&u8g2, static_cast<const uint8_t *>(g.handle));
+    }
+    x += g.advance;
+  }
+}
+
+void HALAstraESP32::_drawShaped(float _x, float _y, const ShapedText &_text) {
+  drawGlyphRun(static_cast<int>(std::round(_x)), static_cast<int>(std::round(_y)) + STATUS_BAR_H, _text, 0,
+               _text.count);
+}
+
+void HALAstraESP32::_renderStrip(uint8_t *_strip, float _x, const ShapedText &_text, uint16_t _first,
+                                 uint16_t _count) {
+  memset(_strip, 0, static_cast<size_t>(tile_width) * 8 * STRIP_TILE_ROWS);
+  // Point u8g2 at the strip for the duration of the draw.
+  uint8_t *canvas = u8g2.tile_buf_ptr;
+  const uint8_t canvasRows = u8g2.tile_buf_height;
+  const uint8_t color = u8g2.draw_color;
+  const u8g2_uint_t clipX0 = u8g2.clip_x0, clipY0 = u8g2.clip_y0, clipX1 = u8g2.clip_x1, clipY1 = u8g2.clip_y1;
+  u8g2.tile_buf_ptr = _strip;
+  u8g2.tile_buf_height = STRIP_TILE_ROWS;
+  u8g2_SetBufferCurrTileRow(&u8g2, 0);
+  u8g2_SetMaxClipWindow(&u8g2);
+  u8g2_SetDrawColor(&u8g2, 1);
+  const uint16_t end = static_cast<uint16_t>(std::min<int>(_text.count, _first + _count));
+  drawGlyphRun(static_cast<int>(std::round(_x)), u8g2.font_info.max_char_height + u8g2.font_info.y_offset, _text,
+               _first, end);
+  u8g2_SetDrawColor(&u8g2, color);
+  u8g2.tile_buf_ptr = canvas;
+  u8g2.tile_buf_height = canvasRows;
+  u8g2_SetBufferCurrTileRow(&u8g2, 0);
+  u8g2_SetClipWindow(&u8g2, clipX0, clipY0, clipX1, clipY1);
+}
+
+void HALAstraESP32::_drawStrip(const uint8_t *_strip, float _y, float _clipY0, float _clipY1, bool _invert) {
+  if (!u8g2_buf) return;
+  const int top = static_cast<int>(std::round(_y)) + STATUS_BAR_H;
+  const int y0 = std::max({top, static_cast<int>(std::round(_clipY0)) + STATUS_BAR_H, STATUS_BAR_H});
+  const int y1 = std::min({top + STRIP_TILE_ROWS * 8, static_cast<int>(std::round(_clipY1)) + STATUS_BAR_H,
+                           LOGICAL_H});
+  if (y1 <= y0) return;
+  const int rowBytes = tile_width * 8;
+  for (int t = 0; t < STRIP_TILE_ROWS; ++t) {
+    // Strip tile row t covers canvas rows [srcTop, srcTop + 8); keep the clipped part.
+    const int srcTop = top + t * 8;
+    const int lo = std::max(y0 - srcTop, 0);
+    const int hi = std::min(y1 - srcTop, 8);
+    if (hi <= lo) continue;
+    const uint8_t keep = static_cast<uint8_t>((0xFF << lo) & (0xFF >> (8 - hi)));
+    const int destRow = (srcTop + 8) / 8 - 1;  // floor(srcTop / 8) for srcTop >= -8
+    const int shift = srcTop - destRow * 8;
+    uint8_t *d0 = destRow >= 0 ? u8g2_buf + destRow * rowBytes : nullptr;
+    uint8_t *d1 = (shift && destRow + 1 < tile_height) ? u8g2_buf + (destRow + 1) * rowBytes : nullptr;
+    const uint8_t *src = _strip + t * rowBytes;
+    for (int x = 0; x < rowBytes; ++x) {
+      const uint8_t bits = src[x] & keep;
+      if (!bits) continue;
+      const uint8_t low = static_cast<uint8_t>(bits << shift);
+      const uint8_t high = shift ? static_cast<uint8_t>(bits >> (8 - shift)) : 0;
+      if (_invert) {
+        if (d0 && low) d0[x] ^= low;
+        if (d1 && high) d1[x] ^= high;
+      } else {
+        if (d0 && low) d0[x] |= low;
+        if (d1 && high) d1[x] |= high;
+      }
+    }
+  }
 }
 
 void HALAstraESP32::_setClipWindow(int _x0, int _y0, int _x1, int _y1) {
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include "hal/hal.h"
+#include "panel_scroll.h"
 #include "u8g2.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/portmacro.h"
@@ -64,15 +65,23 @@ public:
   unsigned char _getBufferTileHeight() override;
   unsigned char _getBufferTileWidth() override;
   void _canvasUpdate() override;
+  void _canvasUpdateRegion(float _y, float _h) override;
+  bool _canvasSnapshot() override;
+  bool _canvasRestore() override;
   void _canvasClear() override;
+  void _setCanvasFade(unsigned char _level, bool _toSet) override;
   void _setFont(const unsigned char *_font) override;
-  unsigned char _getFontWidth(std::string &_text) override;
+  unsigned char _getFontWidth(std::string_view _text) override;
   unsigned char _getFontHeight() override;
   void _setDrawType(unsigned char _type) override;
   void _drawPixel(float _x, float _y) override;
   void _drawCircle(float _x, float _y, float _r) override;
-  void _drawEnglish(float _x, float _y, const std::string &_text) override;
-  void _drawChinese(float _x, float _y, const std::string &_text) override;
+  void _drawEnglish(float _x, float _y, std::string_view _text) override;
+  void _drawChinese(float _x, float _y, std::string_view _text) override;
+  void _shapeText(std::string_view _text, ShapedText &_out) override;
+  void _drawShaped(float _x, float _y, const ShapedText &_text) override;
+  void _renderStrip(uint8_t *_strip, float _x, const ShapedText &_text, uint16_t _first, uint16_t _count) override;
+  void _drawStrip(const uint8_t *_strip, float _y, float _clipY0, float _clipY1, bool _invert) override;
   void _setClipWindow(int _x0, int _y0, int _x1, int _y1) override;
   void _clearClipWindow() override;
   void _drawVDottedLine(float _x, float _y, float _h) override;
@@ -104,11 +113,18 @@ public:
   void clearImageOverlay();
   void setBarOverlay(const BarOverlay &overlay);
   void clearBarOverlay();
-  void setStatusBar(const std::string &text, bool linkReady, bool alertBlink);
+  void setStatusBar(std::string_view text, bool linkReady, bool alertBlink);
   uint16_t getBackgroundColor() const;
   void setForegroundColor(uint16_t color);
   uint16_t getForegroundColor() const;
   int consumeQueuedEncoderSteps();
+  uint32_t takeFlushedBytes();  // Panel bytes sent since the last call.
+  // Hardware scroll of the canvas along UI y. Expects the canvas to hold the
+  // last flushed frame moved by delta within [lo, hi); only the exposed rows
+  // and the status bar are sent. Returns false when a full canvasUpdate() is
+  // needed, which is always on landscape panels (TFT_SWAP_XY, the shipped
+  // board): they scroll along x.
+  bool canvasScroll(int lo, int hi, int delta);
 
 private:
   bool init_display();
@@ -127,6 +143,10 @@ private:
   void drawImageOverlayFrame();
   void drawBarOverlayLine(int y, uint16_t *line, int width);
   void drawStatusBar();
+  void expandCanvasRow(int ly);
+  void flushCanvasRows(int ly0, int ly1);
+  void sendScrollState();
+  void drawGlyphRun(int x, int baseline, const ShapedText &text, uint16_t first, uint16_t end);
   uint16_t blend565(uint16_t bg, uint16_t fg, float alpha) const;
   float ditherAlpha(float alpha, int x, int y) const;
 
@@ -146,6 +166,9 @@ private:
 
   u8g2_t u8g2 {};
   uint8_t *u8g2_buf = nullptr;
+  uint8_t *canvasSnapshotBuf = nullptr;  // Modal backdrop, allocated on first use.
+  uint32_t flushedBytes = 0;
+  PanelScroll panelScroll {};
   uint16_t tile_width = 0;
   uint16_t tile_height = 0;
 
@@ -158,6 +181,9 @@ private:
   bool statusBarLinkReady = false;
   bool statusBarAlertBlink = false;
   uint16_t fgColor = 0;
+  // Page-fade masks for the next flush, indexed by canvas byte parity.
+  uint8_t fadeAnd[2] = {0xFF, 0xFF};
+  uint8_t fadeOr[2] = {0x00, 0x00};
 
   uint8_t encState = 0;
   volatile int16_t encDelta = 0;
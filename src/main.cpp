@@ -1,7 +1,10 @@
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <cstring>
+#include <new>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "freertos/FreeRTOS.h"
@@ -22,13 +25,61 @@
 #include "astra/ui/item/widget/widget.h"
 #include "astra/config/config.h"
 #include "ble_service.h"
+#include "cover_cache.h"
+#include "cover_codec.h"
+#include "cover_transfer.h"
+#include "device_menu.h"
 
 using namespace astra;
 
+// Heap allocations made by the UI task (BT and USB tasks allocate on their own
+// schedule). Counted so the perf overlay can show what a frame allocates.
+namespace {
+TaskHandle_t allocCountTask = nullptr;
+volatile uint32_t allocCount = 0;
+
+void *countedAlloc(size_t size) {
+  if (allocCountTask && xTaskGetCurrentTaskHandle() == allocCountTask) allocCount = allocCount + 1;
+  return malloc(size ? size : 1);
+}
+}  // namespace
+
+void *operator new(size_t size) {
+  void *p = countedAlloc(size);
+  if (!p) abort();
+  return p;
+}
+void *operator new[](size_t size) {
+  void *p = countedAlloc(size);
+  if (!p) abort();
+  return p;
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return countedAlloc(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
 namespace {
 constexpr bool SIMPLE_DISPLAY_ONLY = false;
 constexpr int UART_BAUD = 115200;
 constexpr const char *NVS_NAMESPACE = "songled";
+// Optional protocol features, announced ahead of every HELLO exchange.
+//   CLK     NP PROG carries P/S and rate; the device extrapolates position
+//   TIME    TIME REQ/RSP/SET clock sync; NP PROG may carry the PC sample time
+//   RESUME  SESSION / @seq lines / HELLO RESUME after a drop
+//   DEVLIST versioned SPK/MIC lists with ADD/DEL/REN deltas
+constexpr const char *DEVICE_CAPS = "CAPS CLK TIME RESUME DEVLIST";
+// The bridge announces its own features the same way, with a CAPS line ahead
+// of each HELLO / HELLO OK it sends. A bridge that sends no CAPS has none.
+//   VOLSEQ  VOL SET <v> <seq> is understood and echoed as VOL <v> <seq>
+struct BridgeCaps {
+  bool announced;  // CAPS seen since the last HELLO
+  bool volSeq;
+};
+BridgeCaps bridgeCapsPending = {};
+BridgeCaps bridgeCaps = {};
 
 // Version Information
 constexpr const char *FIRMWARE_VERSION = "v0.0.2";
@@ -107,10 +158,15 @@ List *menuTest = nullptr;
 List *menuMute = nullptr;
 List *menuSettings = nullptr;
 List *menuAbout = nullptr;
+List *menuLyrics = nullptr;
 List *menuBluetooth = nullptr;
 
 List *outputRefreshItem = nullptr;
 List *inputRefreshItem = nullptr;
+List *outputLoadingItem = nullptr;
+List *outputEmptyItem = nullptr;
+List *inputLoadingItem = nullptr;
+List *inputEmptyItem = nullptr;
 List *testIoItem = nullptr;
 List *testFpsItem = nullptr;
 List *testCpuItem = nullptr;
@@ -122,6 +178,7 @@ List *testDoubleBufferItem = nullptr;
 List *test4bitItem = nullptr;
 List *testUpItem = nullptr;
 List *testDownItem = nullptr;
+List *testAllocItem = nullptr;
 List *testLogItem = nullptr;
 List *uiSpeedItem = nullptr;
 List *selSpeedItem = nullptr;
@@ -143,6 +200,7 @@ CheckBox *fpsCheck = nullptr;
 CheckBox *cpuCheck = nullptr;
 CheckBox *upCheck = nullptr;
 CheckBox *downCheck = nullptr;
+CheckBox *allocCheck = nullptr;
 CheckBox *logCheck = nullptr;
 Slider *spiSlider = nullptr;
 CheckBox *dmaCheck = nullptr;
@@ -165,6 +223,8 @@ bool showFps = false;
 bool showCpu = false;
 bool showUp = false;
 bool showDown = false;
+bool showAlloc = false;
+uint32_t allocPerFrame = 0;  // most allocations in one frame over the last second
 bool mcuLogEnabled = false;
 uint8_t uiSpeedValue = 13;
 uint8_t uiSpeedPending = 13;
@@ -198,6 +258,9 @@ bool speakersRequested = false;
 bool microphonesLoading = false;
 int microphoneCurrentId = -1;
 bool microphonesRequested = false;
+// Version of the last full list or delta applied; 0 = unversioned bridge.
+uint16_t speakerListVersion = 0;
+uint16_t microphoneListVersion = 0;
 
 uint8_t spiMHz = 80;
 uint8_t spiPending = 80;
@@ -218,19 +281,262 @@ constexpr uint32_t LINK_READY_STALE_MS = 3500;
 
 uint32_t txBytes = 0;
 uint32_t rxBytes = 0;
+// Bumped for every handled line (USB or BLE task); a change forces a redraw
+// of an otherwise idle menu frame.
+volatile uint32_t rxLineCount = 0;
+// An idle menu (nothing animating, no now-playing or lyrics) is redrawn at
+// this rate only, so timer-driven title/status changes still show up.
+constexpr uint32_t IDLE_FRAME_MS = 100;
 int upBps = 0;
 int downBps = 0;
 
+// Link scheduling: control lines (VOL/MUTE/acks) are written immediately, bulk
+// lines (debug dumps, device lists) go through a small ring and are drained one
+// line per loop so a control message never waits behind more than one chunk.
+constexpr size_t LINK_BULK_QUEUE_SIZE = 8;
+constexpr size_t LINK_BULK_LINE_MAX = 192;
+constexpr size_t UART_RX_BUDGET_PER_LOOP = 2048;
+char linkBulkQueue[LINK_BULK_QUEUE_SIZE][LINK_BULK_LINE_MAX];
+uint8_t linkBulkHead = 0;
+uint8_t linkBulkCount = 0;
+uint32_t linkBulkDropped = 0;
+// bleDebugForward() runs on the BT task, so the ring is shared across tasks.
+portMUX_TYPE linkBulkMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Control round trip (VOL SET -> VOL) measured on device, split by whether a
+// cover transfer was in flight when the request went out.
+struct LinkLatencyStats {
+  uint64_t volSetSentUs;
+  bool volSetDuringCover;
+  uint32_t lastRttUs;
+  uint32_t worstRttUs;
+  uint32_t worstCoverRttUs;
+  uint32_t samples;
+  bool dirty;
+};
+LinkLatencyStats linkLatency = {};
+
+// While a popup sits over a still menu page, the page is kept as a canvas
+// snapshot and only the popup band is redrawn and flushed. The snapshot is
+// retaken now and then so menu text refreshed without serial traffic
+// (Bluetooth and lock state) still shows up.
+constexpr uint32_t BACKDROP_REFRESH_MS = 500;
+struct ModalDrawStats {
+  bool backdropValid;
+  uint32_t backdropMs;
+  uint32_t backdropLineCount;
+  // per heartbeat window, reported as APP MODAL
+  uint32_t fullFrames;
+  uint64_t fullUs;
+  uint32_t fullBytes;
+  uint32_t backdropFrames;
+  uint64_t backdropUs;
+  uint32_t backdropBytes;
+};
+ModalDrawStats modalDraw = {};
+
+// Encoder volume is latest-wins: detents only move volumeValue locally, and at
+// most one VOL SET <v> <seq> is on the wire (plain VOL SET <v> unless the
+// bridge announced VOLSEQ; older bridges parse the value to the end of the
+// line and would read "50 3" as 0). The bridge echoes VOL <v> <seq>;
+// an echo for an older seq is stale and dropped, an unsequenced VOL (OS-side
+// change) only applies while nothing local is outstanding. A spin ends once the
+// knob has been idle and the last value was acknowledged.
+constexpr uint32_t VOL_SET_RETRY_MS = 300;
+constexpr uint32_t VOL_SET_MIN_GAP_MS = 30;
+constexpr uint32_t VOL_SPIN_IDLE_MS = 800;
+struct VolumeSync {
+  bool dirty;          // local value not yet sent
+  bool inFlight;
+  uint16_t seq;
+  uint16_t inFlightSeq;
+  uint32_t sentMs;
+  uint64_t dirtyUs;    // first unsent detent, for knob -> OS latency
+  uint64_t inFlightDirtyUs;
+  uint32_t lastDetentMs;
+  // current spin
+  bool spinning;
+  uint32_t spinDetents;
+  uint32_t spinMessages;
+  uint32_t spinAcks;
+  uint32_t spinLatSumMs;
+  uint32_t spinLatMaxMs;
+  // last finished spin, reported as APP VOL
+  uint32_t lastDetents;
+  uint32_t lastMessages;
+  uint32_t lastLatAvgMs;
+  uint32_t lastLatMaxMs;
+  uint32_t stale;
+  bool dirtyReport;
+};
+VolumeSync volumeSync = {};
+
+// PC -> device clock mapping, NTP style. The PC sends TIME REQ t1, the device
+// answers TIME RSP t1 t2 t3 (its ms clock at receive/send), and the PC pushes
+// back the offset of its best (lowest delay) recent sample as TIME SET. A PC
+// timestamp ts then happened at device time ts + offset, give or take rtt/2.
+struct LinkClock {
+  bool valid;
+  uint32_t offsetMs;  // device ms - PC ms, modulo 2^32
+  uint32_t rttMs;
+  uint32_t syncs;
+  // Age of stamped NP PROG lines on arrival, i.e. what was compensated.
+  uint32_t progAgeSumMs;
+  uint32_t progAgeMaxMs;
+  uint32_t progStamped;
+  bool dirty;
+};
+constexpr uint32_t LINK_AGE_MAX_MS = 3000;  // older stamps mean a bad offset, not a slow link
+LinkClock linkClock = {};
+
+// Session resumption. After SESSION <id> <seq> the bridge prefixes its
+// state-changing control lines with "@<seq> ". When the link comes back the
+// device answers with HELLO RESUME <id> <lastSeq> instead of resyncing; the
+// bridge either replays what was missed (RESUME OK <lines> <targetSeq>) or
+// refuses (RESUME FAIL) and the device falls back to the STATE snapshot.
+struct LinkSession {
+  bool valid;
+  uint32_t id;
+  uint32_t lastSeq;
+  bool resuming;   // HELLO RESUME sent, waiting for the verdict
+  bool replaying;  // RESUME OK seen, missed lines still arriving
+  uint32_t targetSeq;
+  uint32_t startMs;
+  uint32_t replayLines;
+  uint32_t replayBytes;
+};
+LinkSession linkSession = {};
+
+// PING <seq> <t> / PONG <seq> <t> round trips, kept per transport. Probes
+// ride the bulk queue in both directions, so they never delay control lines;
+// the RTT therefore includes bulk queueing and a render-loop pass on each end.
+// Buckets are coarse and fixed, percentiles report the bucket's upper bound.
+constexpr uint16_t RTT_BUCKET_MS[] = {2, 4, 6, 8, 10, 15, 20, 30, 40, 50, 75, 100, 150, 200, 300, 500, 750, 1000, 2000};
+constexpr int RTT_BUCKETS = sizeof(RTT_BUCKET_MS) / sizeof(RTT_BUCKET_MS[0]) + 1;  // + overflow
+constexpr uint32_t LINK_PROBE_DEFAULT_MS = 2000;
+constexpr uint32_t LINK_PROBE_MIN_MS = 100;
+constexpr uint32_t LINK_PEER_QUERY_MS = 2000;
+constexpr int LINK_PROBE_SLOTS = 16;
+
+struct RttHistogram {
+  uint32_t counts[RTT_BUCKETS];
+  uint32_t samples;
+  uint32_t maxMs;
+};
+
+enum LinkTransport { LINK_USB = 0, LINK_BLE, LINK_TRANSPORTS };
+constexpr const char *LINK_TRANSPORT_NAMES[LINK_TRANSPORTS] = {"usb", "ble"};
+
+RttHistogram linkRtt[LINK_TRANSPORTS] = {};
+uint32_t linkProbeIntervalMs = LINK_PROBE_DEFAULT_MS;  // DIAG PING <ms>, 0 = off
+uint32_t linkProbeLastMs = 0;
+uint16_t linkProbeSeq = 0;
+uint8_t linkProbeRoute[LINK_PROBE_SLOTS];  // transport each in-flight seq left on
+uint32_t linkPeerQueryMs = 0;
+char linkPeerRtt[80] = "";  // bridge-side summary from its DIAG RTT reply
+
 // Lyrics data
 struct LyricLine {
   char text[128];
   bool active;
+  HAL::ShapedText shaped;  // decoded once per new text by the UI task, drawn every frame
+  bool shapeDirty;         // text changed since `shaped` was built
 };
 LyricLine currentLyric = {"", false};
 LyricLine nextLyric = {"", false};
 int lyricScrollOffset = 0;
 uint32_t lyricLastUpdateMs = 0;
 
+// Whole-track lyric timeline: the PC uploads it once per song
+// (LRC BEGIN <n> / LRC L <ms> <text> ... / LRC END <n>, answered by LRC OK <n>)
+// and the device switches currentLyric/nextLyric itself from the playback
+// position. Text lives in a fixed arena; the timeline is dropped on NP CLR,
+// LRC CLR and track change. LRC CUR/NXT pushes are ignored while it is loaded.
+constexpr int LYRIC_MAX_LINES = 256;
+constexpr int LYRIC_ARENA_BYTES = 8192;
+
+struct LyricCue {
+  int32_t ms;
+  uint16_t offset;
+  uint16_t len;
+};
+
+struct LyricTimeline {
+  bool loading;
+  bool ready;
+  bool truncated;
+  int count;
+  int arenaUsed;
+  int current;  // index of currentLyric, -1 before the first cue
+  LyricCue cues[LYRIC_MAX_LINES];
+  char arena[LYRIC_ARENA_BYTES];
+};
+
+LyricTimeline lyricTimeline = {};
+
+// Full-screen lyrics: the cues are wrapped into rows once per song (or per
+// live LRC CUR/NXT push). A row is rendered into a 1-bit strip the first time
+// it scrolls into view; after that a frame only blits strips at new offsets.
+constexpr int LYRIC_ROWS_MAX = 512;
+constexpr int LYRIC_STRIP_SLOTS = 24;  // enough for every row on screen plus the ones scrolling in
+constexpr int LYRIC_ROW_GAP = 4;
+constexpr int LYRIC_FULL_MARGIN = 8;
+
+struct LyricRow {
+  uint16_t cue;
+  uint16_t glyphStart;
+  uint16_t glyphCount;
+  int16_t width;
+};
+
+struct LyricStrip {
+  int row;
+  uint32_t generation; // layout the strip was rendered for; older ones are free
+  uint32_t used;
+};
+
+struct LyricLayout {
+  bool dirty;
+  bool snap;           // jump to the current line instead of scrolling there
+  uint32_t generation;
+  int cueCount;
+  int rowCount;
+  float scroll;        // layout y at the top of the view
+  uint32_t stripTick;
+  uint8_t *stripBuf;   // LYRIC_STRIP_SLOTS strips, allocated on first use
+  // Last flushed frame; a frame that only moves the rows can be sent as a
+  // hardware scroll.
+  bool frameValid;
+  uint32_t drawnGeneration;
+  int drawnCue;
+  int drawnScroll;
+  bool scrollOnly;
+  int scrollDelta;
+  LyricRow rows[LYRIC_ROWS_MAX];
+  uint16_t cueRow[LYRIC_MAX_LINES + 1];  // first row of each cue, cueRow[cueCount] == rowCount
+  LyricStrip strips[LYRIC_STRIP_SLOTS];
+};
+
+LyricLayout lyricLayout = {true, true};
+HAL::ShapedText lyricShapeScratch;
+// Live CUR/NXT text as of the last layout. The BT task may rewrite the lines
+// at any time, so layout and strips both read this copy.
+char lyricLiveText[2][sizeof(LyricLine::text)];
+
+// Line switch accuracy: how late a natural (non-seek) switch fired relative to
+// the estimated position, and how far the estimate had drifted whenever an
+// NP PROG corrected it.
+struct LyricAccuracy {
+  uint32_t switches;
+  uint32_t lateSumMs;
+  uint32_t lateMaxMs;
+  uint32_t corrections;
+  uint32_t posErrSumMs;
+  uint32_t posErrMaxMs;
+};
+
+LyricAccuracy lyricAccuracy = {};
+
 constexpr int NP_COVER_W = 40;
 constexpr int NP_COVER_H = 40;
 constexpr int NP_COVER_PIXELS = NP_COVER_W * NP_COVER_H;
@@ -239,7 +545,10 @@ struct NowPlaying {
   bool active;
   char title[64];
   char artist[64];
-  int32_t posMs;
+  HAL::ShapedText titleShaped;  // "Unknown" when the title is empty
+  HAL::ShapedText artistShaped;
+  bool shapeDirty;              // title/artist changed since they were shaped
+  int32_t posMs;  // last reported position; read estimatePositionMs() for display
   int32_t durMs;
   bool coverValid;
   bool coverReceiving;
@@ -252,15 +561,78 @@ struct NowPlaying {
 
 NowPlaying nowPlaying = {};
 
-struct SpeakerEntry {
-  int id;
-  std::string name;
+// handleLine also runs on the BT task (BLE RX), so it only stores lyric and
+// title text and marks it dirty; the UI task shapes it in shapePendingText()
+// before drawing. Shaping there would race u8g2's glyph decoder and rewrite
+// runs a frame is drawing. The mux covers the text copies and the flags.
+portMUX_TYPE textShapeMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Playback clock anchored by NP PROG <pos> <dur> [P|S [rate%]]. Between
+// updates the position runs on esp_timer, so the bridge only needs to report
+// seeks, play/pause and a slow heartbeat. Small disagreements are slewed out
+// at +/-10% speed (the bar never jumps or runs backwards); seeks, state and
+// rate changes snap. Without a P/S token the state is inferred from motion.
+constexpr double CLOCK_SNAP_MS = 1500.0;
+constexpr double CLOCK_SLEW_RATE = 0.1;
+constexpr uint64_t CLOCK_STALE_US = 15000000ULL;        // explicit state: heartbeat is ~5 s
+constexpr uint64_t CLOCK_STALE_INFERRED_US = 2000000ULL;  // legacy bridges send PROG twice a second
+constexpr uint32_t CLOCK_HEARTBEAT_GRACE_MS = 6000;       // NP auto-close never undercuts the heartbeat
+
+struct PlaybackClock {
+  bool valid;
+  bool playing;
+  bool explicitState;
+  double rate;
+  uint64_t anchorUs;
+  double anchorMs;
+  double slew;  // extra rate while slewing
+  uint64_t slewEndUs;
 };
 
+PlaybackClock playbackClock = {};
+
+// Windowed cover transfer (cover_transfer.h). JPEG covers are staged whole and
+// decoded MCU by MCU once the last chunk lands; their source size may exceed
+// the cover box and is sampled down on the fly. A BEGIN the device cannot take
+// is refused with COV NAK <xfer> <reason>.
+constexpr int NP_COVER_JPEG_SRC_MAX = 320;
+
+uint8_t coverWire[COVER_XFER_WIRE_MAX];
+CoverTransfer coverXfer = {};
+
+// The last chunk only queues the finish, so its ack goes out before the JPEG
+// decode and the coverBack -> coverFront commit run later in the same pass.
+struct CoverFinish {
+  bool pending;
+  uint16_t id;
+  CoverFormat format;
+  int totalBytes;
+};
+
+CoverFinish coverFinish = {};
+portMUX_TYPE coverFinishMux = portMUX_INITIALIZER_UNLOCKED;
+
+// handleLine() runs on the BT task for BLE and on the main loop for UART, so
+// NP COV lines are handed to the main loop through this ring: coverXfer,
+// coverWire and coverBack are then only touched there, in arrival order.
+constexpr size_t COVER_LINE_QUEUE_SIZE = 12;
+constexpr size_t COVER_LINE_MAX = 32 + 2 * COVER_XFER_CHUNK_MAX;
+char coverLineQueue[COVER_LINE_QUEUE_SIZE][COVER_LINE_MAX];
+uint8_t coverLineHead = 0;
+uint8_t coverLineCount = 0;
+portMUX_TYPE coverLineMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Content hash from the last NP COV HAS miss; the next cover that completes is
+// cached under it.
+uint64_t coverCacheKey = 0;
+bool coverCacheKeyValid = false;
+
 std::vector<SpeakerEntry> speakers;
-std::vector<std::pair<Menu *, int>> speakerMenuMap;
 std::vector<SpeakerEntry> microphones;
-std::vector<std::pair<Menu *, int>> microphoneMenuMap;
+
+// Device menu rows (device_menu.h); the pool is carved out of PSRAM when the
+// menus are built.
+DeviceRowPool deviceRows = {};
 
 enum AppMode {
   MODE_NORMAL = 0,
@@ -276,6 +648,7 @@ enum AppMode {
   MODE_CFG_CLOSE_ADJUST,
   MODE_TEST_PATTERN,
   MODE_ABOUT_INFO,
+  MODE_LYRICS_FULL,
 };
 
 AppMode appMode = MODE_NORMAL;
@@ -325,9 +698,12 @@ uint16_t hueToRgb565(uint8_t value);
 void applyFontColor();
 void renderTestPattern();
 void renderAboutInfo();
-void renderPopupBackground();
+void renderLyricsFull();
 void renderNowPlayingOverlay();
+void rebuildOutputMenu();
 void rebuildInputMenu();
+void setCurrentDevice(bool output, int id);
+void applyDeviceListDelta(bool output, const char *p);
 void clearNowPlayingState(bool clearLyrics);
 bool loadSettings();
 void saveSettings();
@@ -400,45 +776,48 @@ bool canUseControlFeatures() {
   return pickCommandMode() != COMM_AUTO;
 }
 
+// Titles only change with link state; skip the copy when nothing moved.
+void setMenuTitle(Menu *menu, const char *title) {
+  if (menu->title != title) menu->title.assign(title);
+}
+
 void updateBluetoothMenuItems() {
   if (!bleStatusItem || !bleRouteItem) return;
   bool usbReady = isUsbLinkReady();
   bool bleBasicReady = isBleBasicLinkReady();
   bool bleClientReady = isBleClientLinkReady();
 
-  std::string status;
+  const char *status;
   if (usbReady && bleClientReady) {
-    status = "Status: Wired + BLE Client";
+    status = "Wired + BLE Client";
   } else if (usbReady && bleBasicReady) {
-    status = "Status: Wired + BLE Basic";
+    status = "Wired + BLE Basic";
   } else if (usbReady) {
-    status = "Status: Wired";
+    status = "Wired";
   } else if (bleClientReady) {
-    status = "Status: BLE Client";
+    status = "BLE Client";
   } else if (bleBasicReady) {
-    status = "Status: BLE Basic";
+    status = "BLE Basic";
   } else {
-    status = "Status: Offline";
+    status = "Offline";
   }
   CommMode activeMode = pickCommandMode();
-  if (activeMode == COMM_AUTO) {
-    status += " -> N/A";
-  } else {
-    status += std::string(" -> ") + commModeLabel(activeMode);
-  }
-  bleStatusItem->title = status;
-  bleRouteItem->title = std::string("Prefer: ") + commModeLabel(commMode);
+  char title[64];
+  snprintf(title, sizeof(title), "Status: %s -> %s", status,
+           activeMode == COMM_AUTO ? "N/A" : commModeLabel(activeMode));
+  setMenuTitle(bleStatusItem, title);
+  snprintf(title, sizeof(title), "Prefer: %s", commModeLabel(commMode));
+  setMenuTitle(bleRouteItem, title);
   updateControlMenuAvailability();
 }
 
 void updateControlMenuAvailability() {
   if (!menuVolume || !menuOutput || !menuInput || !menuMute) return;
   bool enabled = canUseControlFeatures();
-  const char *suffix = enabled ? "" : " [LOCK]";
-  menuVolume->title = std::string("Volume") + suffix;
-  menuOutput->title = std::string("Output Device") + suffix;
-  menuInput->title = std::string("Microphone") + suffix;
-  menuMute->title = std::string("Mute") + suffix;
+  setMenuTitle(menuVolume, enabled ? "Volume" : "Volume [LOCK]");
+  setMenuTitle(menuOutput, enabled ? "Output Device" : "Output Device [LOCK]");
+  setMenuTitle(menuInput, enabled ? "Microphone" : "Microphone [LOCK]");
+  setMenuTitle(menuMute, enabled ? "Mute" : "Mute [LOCK]");
 }
 
 void sendLine(const char *line) {
@@ -454,14 +833,449 @@ void sendLine(const char *line) {
   txBytes += static_cast<uint32_t>(len + 1);
 }
 
+void sendBulkLine(const char *line) {
+  if (!line || line[0] == '\0') return;
+  taskENTER_CRITICAL(&linkBulkMux);
+  if (linkBulkCount >= LINK_BULK_QUEUE_SIZE) {
+    // Drop oldest; bulk traffic is diagnostic or re-requestable.
+    linkBulkHead = static_cast<uint8_t>((linkBulkHead + 1) % LINK_BULK_QUEUE_SIZE);
+    linkBulkCount--;
+    linkBulkDropped++;
+  }
+  uint8_t tail = static_cast<uint8_t>((linkBulkHead + linkBulkCount) % LINK_BULK_QUEUE_SIZE);
+  strncpy(linkBulkQueue[tail], line, LINK_BULK_LINE_MAX - 1);
+  linkBulkQueue[tail][LINK_BULK_LINE_MAX - 1] = '\0';
+  linkBulkCount++;
+  taskEXIT_CRITICAL(&linkBulkMux);
+}
+
+void pumpBulkLine() {
+  char line[LINK_BULK_LINE_MAX];
+  taskENTER_CRITICAL(&linkBulkMux);
+  if (linkBulkCount == 0) {
+    taskEXIT_CRITICAL(&linkBulkMux);
+    return;
+  }
+  memcpy(line, linkBulkQueue[linkBulkHead], sizeof(line));
+  linkBulkHead = static_cast<uint8_t>((linkBulkHead + 1) % LINK_BULK_QUEUE_SIZE);
+  linkBulkCount--;
+  taskEXIT_CRITICAL(&linkBulkMux);
+  sendLine(line);
+}
+
+void rttRecord(RttHistogram &h, uint32_t ms) {
+  int b = 0;
+  while (b < RTT_BUCKETS - 1 && ms > RTT_BUCKET_MS[b]) b++;
+  h.counts[b]++;
+  h.samples++;
+  if (ms > h.maxMs) h.maxMs = ms;
+}
+
+uint32_t rttPercentile(const RttHistogram &h, uint32_t pct) {
+  if (h.samples == 0) return 0;
+  uint32_t rank = (h.samples * pct + 99) / 100;
+  uint32_t seen = 0;
+  for (int b = 0; b < RTT_BUCKETS - 1; ++b) {
+    seen += h.counts[b];
+    if (seen >= rank) return std::min<uint32_t>(RTT_BUCKET_MS[b], h.maxMs);
+  }
+  return h.maxMs;
+}
+
+// "n=.. p50=.. p95=.. p99=.. max=.." for DIAG RTT replies and the About page.
+void formatRtt(char *out, size_t len, const RttHistogram &h) {
+  snprintf(out, len, "n=%u p50=%u p95=%u p99=%u max=%u", static_cast<unsigned>(h.samples),
+           static_cast<unsigned>(rttPercentile(h, 50)), static_cast<unsigned>(rttPercentile(h, 95)),
+           static_cast<unsigned>(rttPercentile(h, 99)), static_cast<unsigned>(h.maxMs));
+}
+
+void sendLinkProbe(uint32_t nowMs) {
+  CommMode route = pickCommandMode();
+  if (route == COMM_AUTO) return;  // nobody to answer
+  uint16_t seq = ++linkProbeSeq;
+  linkProbeRoute[seq % LINK_PROBE_SLOTS] = route == COMM_BLE ? LINK_BLE : LINK_USB;
+  char msg[40];
+  snprintf(msg, sizeof(msg), "PING %u %lu", static_cast<unsigned>(seq), static_cast<unsigned long>(nowMs));
+  sendBulkLine(msg);
+}
+
+void noteVolumeReply() {
+  if (linkLatency.volSetSentUs == 0) return;
+  uint64_t nowUs = esp_timer_get_time();
+  uint32_t rtt = static_cast<uint32_t>(nowUs - linkLatency.volSetSentUs);
+  linkLatency.volSetSentUs = 0;
+  linkLatency.lastRttUs = rtt;
+  linkLatency.samples++;
+  if (rtt > linkLatency.worstRttUs) linkLatency.worstRttUs = rtt;
+  if (linkLatency.volSetDuringCover && rtt > linkLatency.worstCoverRttUs) {
+    linkLatency.worstCoverRttUs = rtt;
+  }
+  linkLatency.dirty = true;
+}
+
+void resetCoverTransfer() {
+  coverXfer = {};
+  portENTER_CRITICAL(&coverFinishMux);
+  coverFinish.pending = false;
+  portEXIT_CRITICAL(&coverFinishMux);
+}
+
+void queueCoverLine(const char *line) {
+  portENTER_CRITICAL(&coverLineMux);
+  if (coverLineCount >= COVER_LINE_QUEUE_SIZE) {
+    portEXIT_CRITICAL(&coverLineMux);
+    // Dropped like a lost line; the PC resends chunks that are never acked.
+    ESP_LOGW("COVER", "line queue full, dropped: %.24s", line);
+    return;
+  }
+  uint8_t tail = static_cast<uint8_t>((coverLineHead + coverLineCount) % COVER_LINE_QUEUE_SIZE);
+  strncpy(coverLineQueue[tail], line, COVER_LINE_MAX - 1);
+  coverLineQueue[tail][COVER_LINE_MAX - 1] = '\0';
+  coverLineCount++;
+  portEXIT_CRITICAL(&coverLineMux);
+}
+
+// Any task: a stale finish must not commit, and the transfer itself is
+// dropped from the main loop behind the NP COV lines already queued.
+void cancelCoverTransfer() {
+  portENTER_CRITICAL(&coverFinishMux);
+  coverFinish.pending = false;
+  portEXIT_CRITICAL(&coverFinishMux);
+  queueCoverLine("NP COV ABORT 0");
+}
+
+void commitCover() {
+  memcpy(nowPlaying.coverFront, nowPlaying.coverBack, sizeof(nowPlaying.coverFront));
+  nowPlaying.coverValid = true;
+  if (coverCacheKeyValid) {
+    cover_cache_store(coverCacheKey, nowPlaying.coverFront);
+    coverCacheKeyValid = false;
+  }
+}
+
+void sendCoverAck() {
+  char msg[48];
+  if (cover_xfer_ack_line(&coverXfer, msg, sizeof(msg))) sendLine(msg);
+}
+
+bool decodeJpegCover(int totalBytes) {
+  CoverJpegInfo info;
+  uint64_t startUs = esp_timer_get_time();
+  bool ok = cover_decode_jpeg(coverWire, static_cast<size_t>(totalBytes), nowPlaying.coverBack, NP_COVER_W,
+                              NP_COVER_H, true, &info);
+  uint32_t decodeUs = static_cast<uint32_t>(esp_timer_get_time() - startUs);
+  char msg[112];
+  snprintf(msg, sizeof(msg), "APP COV JPG %s src=%dx%d scale=1/%d bytes=%d decode_us=%u work=%u res=%d",
+           ok ? "ok" : "fail", info.srcW, info.srcH, 1 << info.scale, totalBytes,
+           static_cast<unsigned>(decodeUs), static_cast<unsigned>(COVER_JPEG_WORK_BYTES), info.result);
+  sendBulkLine(msg);
+  return ok;
+}
+
+// Main loop: completes a transfer queued by handleCoverChunk().
+void finishCover() {
+  portENTER_CRITICAL(&coverFinishMux);
+  CoverFinish finish = coverFinish;
+  coverFinish.pending = false;
+  portEXIT_CRITICAL(&coverFinishMux);
+  if (!finish.pending) return;
+  bool ok = finish.format != COVER_FMT_JPEG || decodeJpegCover(finish.totalBytes);
+  // A BEGIN or cache hit that landed meanwhile owns the buffers now.
+  if (ok && coverXfer.id == finish.id) commitCover();
+}
+
+void handleCoverChunk(const char *args) {
+  if (!nowPlaying.coverReceiving) return;
+  CoverChunkResult res = cover_xfer_chunk(&coverXfer, args);
+  if (res == COVER_CHUNK_CORRUPT) {
+    ESP_LOGW("COVER", "xfer %u: corrupt stream at byte %d", static_cast<unsigned>(coverXfer.id),
+             coverXfer.fedBytes);
+    nowPlaying.coverReceiving = false;
+    resetCoverTransfer();
+    return;
+  }
+  if (res != COVER_CHUNK_STORED && res != COVER_CHUNK_COMPLETE) return;
+
+  if (coverXfer.format == COVER_FMT_JPEG) {
+    nowPlaying.coverIndex = static_cast<int>(static_cast<int64_t>(coverXfer.fedBytes) * nowPlaying.coverTotal /
+                                             coverXfer.totalBytes);
+  } else {
+    nowPlaying.coverIndex = coverXfer.decoder.pos;
+    if (coverXfer.previewUs == 0 && coverXfer.decoder.interlaced &&
+        cover_decoder_preview_ready(&coverXfer.decoder)) {
+      coverXfer.previewUs = static_cast<uint32_t>(esp_timer_get_time() - coverXfer.beginUs);
+    }
+  }
+  if (res == COVER_CHUNK_COMPLETE) {
+    nowPlaying.coverReceiving = false;
+    if (coverXfer.format == COVER_FMT_JPEG || cover_decoder_done(&coverXfer.decoder)) {
+      portENTER_CRITICAL(&coverFinishMux);
+      coverFinish = {true, coverXfer.id, coverXfer.format, coverXfer.totalBytes};
+      portEXIT_CRITICAL(&coverFinishMux);
+    }
+    ESP_LOGI("COVER", "xfer %u done fmt=%d bytes=%d crc errors=%u", static_cast<unsigned>(coverXfer.id),
+             static_cast<int>(coverXfer.format), coverXfer.totalBytes,
+             static_cast<unsigned>(coverXfer.crcErrors));
+    char msg[80];
+    snprintf(msg, sizeof(msg), "APP COV xfer=%u preview_ms=%u done_ms=%u", static_cast<unsigned>(coverXfer.id),
+             static_cast<unsigned>(coverXfer.previewUs / 1000),
+             static_cast<unsigned>((esp_timer_get_time() - coverXfer.beginUs) / 1000));
+    sendBulkLine(msg);
+  }
+}
+
+double clockPositionAt(uint64_t nowUs) {
+  const PlaybackClock &c = playbackClock;
+  if (!c.valid) return nowPlaying.posMs;
+  if (!c.playing) return c.anchorMs;
+  // Without a fresh NP PROG the player may have stopped; don't run far ahead.
+  uint64_t staleUs = c.explicitState ? CLOCK_STALE_US : CLOCK_STALE_INFERRED_US;
+  uint64_t elapsedUs = std::min<uint64_t>(nowUs - c.anchorUs, staleUs);
+  uint64_t slewUs = std::min<uint64_t>(std::min(nowUs, c.slewEndUs) - std::min(c.anchorUs, c.slewEndUs), staleUs);
+  double pos = c.anchorMs + (static_cast<double>(elapsedUs) * c.rate + static_cast<double>(slewUs) * c.slew) / 1000.0;
+  if (pos < 0.0) pos = 0.0;
+  if (nowPlaying.durMs > 0 && pos > nowPlaying.durMs) pos = nowPlaying.durMs;
+  return pos;
+}
+
+int32_t estimatePositionMs() { return static_cast<int32_t>(clockPositionAt(esp_timer_get_time())); }
+
+// state: 1 playing, 0 paused, -1 not sent (infer from motion).
+void updatePlaybackClock(int32_t pos, int state, double rate) {
+  PlaybackClock &c = playbackClock;
+  uint64_t nowUs = esp_timer_get_time();
+  bool playing = state >= 0 ? state == 1 : (c.valid && pos != nowPlaying.posMs);
+  double estimate = clockPositionAt(nowUs);
+  double err = pos - estimate;
+  bool snap = !c.valid || !playing || playing != c.playing || rate != c.rate || std::fabs(err) > CLOCK_SNAP_MS;
+  c.playing = playing;
+  c.explicitState = state >= 0;
+  c.rate = rate;
+  c.anchorUs = nowUs;
+  if (snap) {
+    c.anchorMs = pos;
+    c.slew = 0.0;
+    c.slewEndUs = nowUs;
+  } else {
+    c.anchorMs = estimate;
+    c.slew = err > 0.0 ? CLOCK_SLEW_RATE : -CLOCK_SLEW_RATE;
+    c.slewEndUs = nowUs + static_cast<uint64_t>(std::fabs(err) / CLOCK_SLEW_RATE * 1000.0);
+  }
+  c.valid = true;
+}
+
+void setLyricText(LyricLine &dst, const char *text, size_t len) {
+  if (len >= sizeof(dst.text)) len = sizeof(dst.text) - 1;
+  portENTER_CRITICAL(&textShapeMux);
+  memcpy(dst.text, text, len);
+  dst.text[len] = '\0';
+  dst.shapeDirty = true;
+  portEXIT_CRITICAL(&textShapeMux);
+}
+
+void shapeLyricLine(LyricLine &line) {
+  char text[sizeof(line.text)];
+  portENTER_CRITICAL(&textShapeMux);
+  bool due = line.shapeDirty;
+  if (due) {
+    memcpy(text, line.text, sizeof(text));
+    line.shapeDirty = false;
+  }
+  portEXIT_CRITICAL(&textShapeMux);
+  if (due) HAL::shapeText(text, line.shaped);
+}
+
+// UI task, once per loop before anything is drawn.
+void shapePendingText() {
+  shapeLyricLine(currentLyric);
+  shapeLyricLine(nextLyric);
+  char title[sizeof(nowPlaying.title)];
+  char artist[sizeof(nowPlaying.artist)];
+  portENTER_CRITICAL(&textShapeMux);
+  bool due = nowPlaying.shapeDirty;
+  if (due) {
+    memcpy(title, nowPlaying.title, sizeof(title));
+    memcpy(artist, nowPlaying.artist, sizeof(artist));
+    nowPlaying.shapeDirty = false;
+  }
+  portEXIT_CRITICAL(&textShapeMux);
+  if (due) {
+    HAL::shapeText(title[0] ? title : "Unknown", nowPlaying.titleShaped);
+    HAL::shapeText(artist, nowPlaying.artistShaped);
+  }
+}
+
+void copyLyricCue(LyricLine &dst, int idx) {
+  if (idx < 0 || idx >= lyricTimeline.count) {
+    setLyricText(dst, "", 0);
+    dst.active = false;
+    return;
+  }
+  const LyricCue &cue = lyricTimeline.cues[idx];
+  setLyricText(dst, lyricTimeline.arena + cue.offset, cue.len);
+  dst.active = true;
+}
+
+void reportLyricAccuracy() {
+  if (lyricAccuracy.switches == 0 && lyricAccuracy.corrections == 0) return;
+  char msg[128];
+  snprintf(msg, sizeof(msg),
+           "APP LRC switches=%u late_avg_ms=%u late_max_ms=%u pos_err_avg_ms=%u pos_err_max_ms=%u",
+           static_cast<unsigned>(lyricAccuracy.switches),
+           static_cast<unsigned>(lyricAccuracy.switches ? lyricAccuracy.lateSumMs / lyricAccuracy.switches : 0),
+           static_cast<unsigned>(lyricAccuracy.lateMaxMs),
+           static_cast<unsigned>(lyricAccuracy.corrections ? lyricAccuracy.posErrSumMs / lyricAccuracy.corrections : 0),
+           static_cast<unsigned>(lyricAccuracy.posErrMaxMs));
+  sendBulkLine(msg);
+  lyricAccuracy = {};
+}
+
+void clearLyricTimeline() {
+  if (lyricTimeline.ready) reportLyricAccuracy();
+  lyricLayout.dirty = true;
+  lyricTimeline.loading = false;
+  lyricTimeline.ready = false;
+  lyricTimeline.truncated = false;
+  lyricTimeline.count = 0;
+  lyricTimeline.arenaUsed = 0;
+  lyricTimeline.current = -1;
+  lyricAccuracy = {};
+}
+
+// LRC L <ms> <text>; cues must arrive in time order.
+void appendLyricCue(const char *args) {
+  char *end = nullptr;
+  long ms = strtol(args, &end, 10);
+  if (end == args) return;
+  if (*end == ' ') end++;
+  if (lyricTimeline.count > 0 && ms < lyricTimeline.cues[lyricTimeline.count - 1].ms) return;
+  size_t len = strlen(end);
+  if (len > sizeof(LyricLine::text) - 1) {
+    len = sizeof(LyricLine::text) - 1;
+    while (len > 0 && (static_cast<uint8_t>(end[len]) & 0xC0) == 0x80) len--;  // keep whole UTF-8 glyphs
+  }
+  if (lyricTimeline.count >= LYRIC_MAX_LINES ||
+      lyricTimeline.arenaUsed + static_cast<int>(len) > LYRIC_ARENA_BYTES) {
+    lyricTimeline.truncated = true;
+    return;
+  }
+  LyricCue &cue = lyricTimeline.cues[lyricTimeline.count++];
+  cue.ms = static_cast<int32_t>(ms);
+  cue.offset = static_cast<uint16_t>(lyricTimeline.arenaUsed);
+  cue.len = static_cast<uint16_t>(len);
+  memcpy(lyricTimeline.arena + lyricTimeline.arenaUsed, end, len);
+  lyricTimeline.arenaUsed += static_cast<int>(len);
+}
+
+void updateLyricSchedule() {
+  if (!lyricTimeline.ready || !nowPlaying.active) return;
+  int32_t pos = estimatePositionMs();
+  // Last cue at or before pos.
+  int lo = 0;
+  int hi = lyricTimeline.count - 1;
+  int idx = -1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    if (lyricTimeline.cues[mid].ms <= pos) {
+      idx = mid;
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  if (idx == lyricTimeline.current) return;
+  if (idx == lyricTimeline.current + 1 && idx >= 0) {
+    uint32_t late = static_cast<uint32_t>(pos - lyricTimeline.cues[idx].ms);
+    lyricAccuracy.switches++;
+    lyricAccuracy.lateSumMs += late;
+    if (late > lyricAccuracy.lateMaxMs) lyricAccuracy.lateMaxMs = late;
+  }
+  lyricTimeline.current = idx;
+  copyLyricCue(currentLyric, idx);
+  copyLyricCue(nextLyric, idx + 1);
+  lyricScrollOffset = 0;
+  lyricLastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+}
+
 void sendVolumeGet() { sendLine("VOL GET"); }
 
-void sendVolumeSet() {
-  char line[24];
-  snprintf(line, sizeof(line), "VOL SET %d", volumeValue);
+void sendVolumeSet(uint32_t nowMs) {
+  char line[32];
+  volumeSync.inFlightSeq = ++volumeSync.seq;
+  if (bridgeCaps.volSeq) {
+    snprintf(line, sizeof(line), "VOL SET %d %u", volumeValue, static_cast<unsigned>(volumeSync.inFlightSeq));
+  } else {
+    snprintf(line, sizeof(line), "VOL SET %d", volumeValue);
+  }
+  if (linkLatency.volSetSentUs == 0) {
+    linkLatency.volSetSentUs = esp_timer_get_time();
+    linkLatency.volSetDuringCover = nowPlaying.coverReceiving;
+  }
+  volumeSync.inFlight = true;
+  volumeSync.sentMs = nowMs;
+  volumeSync.inFlightDirtyUs = volumeSync.dirtyUs;
+  volumeSync.dirty = false;
+  volumeSync.spinMessages++;
   sendLine(line);
 }
 
+// Encoder detent: volumeValue is already on screen, the wire catches up in
+// pumpVolumeSync() with whatever the value is by then.
+void queueVolumeSet() {
+  uint64_t nowUs = esp_timer_get_time();
+  if (!volumeSync.dirty) volumeSync.dirtyUs = nowUs;
+  volumeSync.dirty = true;
+  volumeSync.lastDetentMs = static_cast<uint32_t>(nowUs / 1000ULL);
+  if (!volumeSync.spinning) {
+    volumeSync.spinning = true;
+    volumeSync.spinDetents = 0;
+    volumeSync.spinMessages = 0;
+    volumeSync.spinAcks = 0;
+    volumeSync.spinLatSumMs = 0;
+    volumeSync.spinLatMaxMs = 0;
+  }
+  volumeSync.spinDetents++;
+}
+
+bool volumeLocalPending() { return volumeSync.dirty || volumeSync.inFlight; }
+
+// VOL <v> [seq] from the bridge. Returns whether v should replace the local value.
+bool takeVolumeEcho(bool sequenced, uint16_t seq) {
+  if (sequenced && static_cast<int16_t>(seq - volumeSync.seq) < 0) {
+    volumeSync.stale++;
+    return false;
+  }
+  // An unsequenced VOL while a set is in flight is the reply of an older bridge.
+  if (volumeSync.inFlight) {
+    volumeSync.inFlight = false;
+    uint32_t lat = static_cast<uint32_t>((esp_timer_get_time() - volumeSync.inFlightDirtyUs) / 1000ULL);
+    volumeSync.spinAcks++;
+    volumeSync.spinLatSumMs += lat;
+    if (lat > volumeSync.spinLatMaxMs) volumeSync.spinLatMaxMs = lat;
+    noteVolumeReply();
+  }
+  return !volumeSync.dirty;
+}
+
+void pumpVolumeSync(uint32_t nowMs) {
+  bool expired = volumeSync.inFlight && nowMs - volumeSync.sentMs >= VOL_SET_RETRY_MS;
+  if (volumeSync.dirty) {
+    if ((!volumeSync.inFlight || expired) && nowMs - volumeSync.sentMs >= VOL_SET_MIN_GAP_MS) {
+      sendVolumeSet(nowMs);
+    }
+  } else if (expired) {
+    volumeSync.inFlight = false;  // echo lost; a later VOL reconciles
+  }
+  if (volumeSync.spinning && !volumeLocalPending() && nowMs - volumeSync.lastDetentMs >= VOL_SPIN_IDLE_MS) {
+    volumeSync.spinning = false;
+    volumeSync.lastDetents = volumeSync.spinDetents;
+    volumeSync.lastMessages = volumeSync.spinMessages;
+    volumeSync.lastLatAvgMs = volumeSync.spinAcks ? volumeSync.spinLatSumMs / volumeSync.spinAcks : 0;
+    volumeSync.lastLatMaxMs = volumeSync.spinLatMaxMs;
+    volumeSync.dirtyReport = true;
+  }
+}
+
 void sendMuteToggle() { sendLine("MUTE"); }
 
 void sendSpeakerListRequest() { sendLine("SPK LIST"); }
@@ -480,51 +1294,21 @@ void sendMicSet(int id) {
   sendLine(line);
 }
 
-void sendHello() { sendLine("HELLO"); }
-
-void rebuildOutputMenu() {
-  // 临时调试：打印speakers数组状态
-  char dbg[64];
-  snprintf(dbg, sizeof(dbg), "[REBUILD] speakers.size=%d, loading=%d", (int)speakers.size(), speakersLoading ? 1 : 0);
-  sendLine(dbg);
-  
-  for (auto *item : menuOutput->childMenu) {
-    if (item == outputRefreshItem) continue;
-    delete item;
-  }
-  menuOutput->childMenu.clear();
-  menuOutput->childWidget.clear();
-  speakerMenuMap.clear();
-
-  menuOutput->addItem(outputRefreshItem);
-
-  if (speakersLoading) {
-    auto *loading = new List("Loading...");
-    menuOutput->addItem(loading);
-    sendLine("[REBUILD] Showing loading");
-  } else if (speakers.empty()) {
-    auto *none = new List("No devices");
-    menuOutput->addItem(none);
-    sendLine("[REBUILD] Showing no devices");
-  } else {
-    snprintf(dbg, sizeof(dbg), "[REBUILD] Adding %d devices", (int)speakers.size());
-    sendLine(dbg);
-    for (const auto &spk : speakers) {
-      std::string title = spk.name;
-      if (spk.id == speakerCurrentId) title = "* " + title;
-      auto *item = new List(title);
-      menuOutput->addItem(item);
-      speakerMenuMap.push_back({item, spk.id});
-    }
-  }
-
-  menuOutput->forePosInit();
-  if (launcher.getCamera()) {
-    menuOutput->childPosInit(launcher.getCamera()->getPosition());
+void sendHello() {
+  // Capabilities go first so the bridge knows them when it answers.
+  sendLine(DEVICE_CAPS);
+  if (!linkSession.valid) {
+    sendLine("HELLO");
+    return;
   }
-  if (launcher.getCurrentMenu() == menuOutput && launcher.getSelector()) {
-    launcher.getSelector()->inject(menuOutput);
+  if (!linkSession.resuming) {
+    linkSession.resuming = true;
+    linkSession.startMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
   }
+  char msg[48];
+  snprintf(msg, sizeof(msg), "HELLO RESUME %08lX %lu", static_cast<unsigned long>(linkSession.id),
+           static_cast<unsigned long>(linkSession.lastSeq));
+  sendLine(msg);
 }
 
 void updateVolumeWidgets() {
@@ -558,6 +1342,10 @@ void updatePerfWidgets() {
     downCheck->value = showDown;
     downCheck->init();
   }
+  if (allocCheck) {
+    allocCheck->value = showAlloc;
+    allocCheck->init();
+  }
   if (logCheck) {
     logCheck->value = mcuLogEnabled;
     logCheck->init();
@@ -568,7 +1356,7 @@ void bleDebugForward(const char *line) {
   if (!mcuLogEnabled || !line || line[0] == '\0') return;
   char msg[220];
   snprintf(msg, sizeof(msg), "DEBUG: %s", line);
-  sendLine(msg);
+  sendBulkLine(msg);
 }
 
 void updateDisplayWidgets() {
@@ -642,18 +1430,386 @@ void applyDisplayConfig() {
   updateDisplayWidgets();
 }
 
+// "title\tartist" (or "title|artist") from NP META and the STATE snapshot.
+void applyNowPlayingMeta(const char *p) {
+  const char *sep = strchr(p, '\t');
+  if (!sep) sep = strchr(p, '|');
+  size_t titleLen = sep ? static_cast<size_t>(sep - p) : strlen(p);
+  if (titleLen >= sizeof(nowPlaying.title)) titleLen = sizeof(nowPlaying.title) - 1;
+  char newTitle[64];
+  strncpy(newTitle, p, titleLen);
+  newTitle[titleLen] = '\0';
+
+  char newArtist[64];
+  if (sep) {
+    const char *artist = sep + 1;
+    size_t artistLen = strlen(artist);
+    if (artistLen >= sizeof(newArtist)) artistLen = sizeof(newArtist) - 1;
+    strncpy(newArtist, artist, artistLen);
+    newArtist[artistLen] = '\0';
+  } else {
+    newArtist[0] = '\0';
+  }
+
+  bool sameMeta = (strcmp(nowPlaying.title, newTitle) == 0) &&
+                  (strcmp(nowPlaying.artist, newArtist) == 0);
+  if (!sameMeta) {
+    portENTER_CRITICAL(&textShapeMux);
+    strncpy(nowPlaying.title, newTitle, sizeof(nowPlaying.title) - 1);
+    nowPlaying.title[sizeof(nowPlaying.title) - 1] = '\0';
+    strncpy(nowPlaying.artist, newArtist, sizeof(nowPlaying.artist) - 1);
+    nowPlaying.artist[sizeof(nowPlaying.artist) - 1] = '\0';
+    nowPlaying.shapeDirty = true;
+    portEXIT_CRITICAL(&textShapeMux);
+  }
+  nowPlaying.active = true;
+  nowPlaying.lastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+  if (!sameMeta) {
+    cancelCoverTransfer();
+    clearLyricTimeline();
+    coverCacheKeyValid = false;
+    nowPlaying.coverValid = false;
+    nowPlaying.coverReceiving = false;
+    nowPlaying.coverIndex = 0;
+    nowPlaying.coverTotal = NP_COVER_PIXELS;
+    memset(nowPlaying.coverFront, 0, sizeof(nowPlaying.coverFront));
+    memset(nowPlaying.coverBack, 0, sizeof(nowPlaying.coverBack));
+  }
+}
+
+// Connect-time resync. Right after the handshake the device asks for one
+// STATE line (volume, mute, both device lists with their current ids, and
+// now-playing metadata) instead of walking VOL GET / SPK LIST / MIC LIST. A
+// bridge that stays silent gets the legacy VOL GET after a short timeout.
+//   STATE <vol> <mute> <spkCur> <spkN> <micCur> <micN>\t<spk>...\t<mic>...[\t<title>\t<artist>]
+constexpr uint32_t STATE_REPLY_TIMEOUT_MS = 600;
+
+struct StateSync {
+  bool pending;
+  uint32_t requestMs;
+};
+StateSync stateSync = {};
+
+void finishResume() {
+  uint32_t nowMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+  char msg[96];
+  snprintf(msg, sizeof(msg), "APP RESUME ms=%u lines=%u bytes=%u seq=%lu", static_cast<unsigned>(nowMs - linkSession.startMs),
+           static_cast<unsigned>(linkSession.replayLines), static_cast<unsigned>(linkSession.replayBytes),
+           static_cast<unsigned long>(linkSession.lastSeq));
+  sendBulkLine(msg);
+  linkSession.replaying = false;
+}
+
+void requestStateSnapshot() {
+  stateSync.pending = true;
+  stateSync.requestMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+  sendLine("STATE GET");
+}
+
+// Splits off the next tab-separated field (a view into the line); returns
+// nullptr when none is left.
+const char *nextStateField(const char *p, std::string_view &out) {
+  if (!p) return nullptr;
+  const char *tab = strchr(p, '\t');
+  out = std::string_view(p, tab ? static_cast<size_t>(tab - p) : strlen(p));
+  return tab ? tab + 1 : nullptr;
+}
+
+// Refills `list` with up to `count` names, reusing the entries (and their
+// string capacity) left from the previous snapshot.
+const char *readStateNames(const char *field, int count, std::vector<SpeakerEntry> &list) {
+  size_t n = 0;
+  std::string_view name;
+  for (int i = 0; i < count && field; ++i, ++n) {
+    field = nextStateField(field, name);
+    if (n == list.size()) list.emplace_back();
+    list[n].id = i;
+    list[n].name.assign(name.data(), name.size());
+  }
+  list.resize(n);
+  return field;
+}
+
+void applyStateSnapshot(const char *p) {
+  int vol = 0, mute = 0, spkCur = -1, spkCount = 0, micCur = -1, micCount = 0;
+  unsigned spkVer = 0, micVer = 0;
+  if (sscanf(p, "%d %d %d %d %d %d %u %u", &vol, &mute, &spkCur, &spkCount, &micCur, &micCount, &spkVer,
+             &micVer) < 6) {
+    return;
+  }
+  const char *field = strchr(p, '\t');
+  if (field) field++;
+
+  field = readStateNames(field, spkCount, speakers);
+  field = readStateNames(field, micCount, microphones);
+
+  noteVolumeReply();
+  if (!volumeLocalPending()) {
+    volumeValue = static_cast<uint8_t>(std::min(std::max(vol, 0), 100));
+    updateVolumeWidgets();
+  }
+  muteState = mute != 0;
+  updateMuteWidgets();
+  speakerCurrentId = spkCur;
+  speakerListVersion = static_cast<uint16_t>(spkVer);
+  microphoneListVersion = static_cast<uint16_t>(micVer);
+  speakersLoading = false;
+  speakersRequested = true;
+  microphoneCurrentId = micCur;
+  microphonesLoading = false;
+  microphonesRequested = true;
+  rebuildOutputMenu();
+  rebuildInputMenu();
+  if (field && field[0] != '\0') applyNowPlayingMeta(field);
+
+  uint32_t nowMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+  char msg[96];
+  snprintf(msg, sizeof(msg), "APP STATE ms=%u bytes=%u spk=%d mic=%d", static_cast<unsigned>(nowMs - stateSync.requestMs),
+           static_cast<unsigned>(strlen(p) + 6), spkCount, micCount);
+  sendBulkLine(msg);
+  stateSync.pending = false;
+}
+
+// Main loop: every NP COV line, in arrival order (see queueCoverLine()).
+void handleCoverLine(const char *line) {
+  if (strncmp(line, "NP COV BEGIN", 12) == 0) {
+    handshakeOk = true;
+    nowPlaying.coverReceiving = true;
+    nowPlaying.coverIndex = 0;
+    nowPlaying.coverTotal = NP_COVER_PIXELS;
+    nowPlaying.lastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+    resetCoverTransfer();
+    int w = 0;
+    int h = 0;
+    unsigned xfer = 0;
+    int chunkBytes = 0;
+    char fmt[8] = "RAW";
+    int totalBytes = 0;
+    int fields = sscanf(line + 12, "%d %d %u %d %7s %d", &w, &h, &xfer, &chunkBytes, fmt, &totalBytes);
+    if (fields >= 2 && w > 0 && h > 0) {
+      int total = w * h;
+      if (total > 0 && total < NP_COVER_PIXELS) {
+        nowPlaying.coverTotal = total;
+      } else {
+        nowPlaying.coverTotal = NP_COVER_PIXELS;
+      }
+    }
+    const char *reject = nullptr;
+    CoverFormat format = COVER_FMT_RAW565;
+    // A trailing I marks Adam7 pixel order (full cover box only).
+    size_t fmtLen = strlen(fmt);
+    bool interlaced = fmtLen > 1 && fmt[fmtLen - 1] == 'I';
+    if (interlaced) {
+      fmt[fmtLen - 1] = '\0';
+      if (w != NP_COVER_W || h != NP_COVER_H) reject = "SIZE";
+    }
+    if (strcmp(fmt, "Q565") == 0) {
+      format = COVER_FMT_Q565;
+    } else if (strcmp(fmt, "JPG") == 0) {
+      // w/h describe the JPEG itself; it is sampled into the fixed cover box.
+      format = COVER_FMT_JPEG;
+      nowPlaying.coverTotal = NP_COVER_PIXELS;
+      if (w > NP_COVER_JPEG_SRC_MAX || h > NP_COVER_JPEG_SRC_MAX) reject = "SIZE";
+      if (interlaced) reject = "FMT";
+    } else if (strcmp(fmt, "RAW") != 0) {
+      reject = "FMT";
+    }
+    if (fields < 6) totalBytes = nowPlaying.coverTotal * 2;
+    if (fields >= 4 && xfer > 0 && !reject &&
+        !cover_xfer_begin(&coverXfer, static_cast<uint16_t>(xfer), format, chunkBytes, totalBytes, coverWire,
+                          nowPlaying.coverBack, nowPlaying.coverTotal, true)) {
+      reject = "SIZE";
+    }
+    if (fields >= 4 && xfer > 0 && reject) {
+      nowPlaying.coverReceiving = false;
+      char nak[40];
+      snprintf(nak, sizeof(nak), "COV NAK %u %s", xfer, reject);
+      sendLine(nak);
+    } else if (fields >= 4 && xfer > 0) {
+      coverXfer.beginUs = esp_timer_get_time();
+      if (interlaced) cover_decoder_interlace(&coverXfer.decoder, w, h);
+    }
+    memset(nowPlaying.coverBack, 0, sizeof(nowPlaying.coverBack));
+    sendLine("APP RX NP COV BEGIN");
+  } else if (strncmp(line, "NP COV HAS ", 11) == 0) {
+    handshakeOk = true;
+    char *end = nullptr;
+    uint64_t key = strtoull(line + 11, &end, 16);
+    if (end == line + 11) return;
+    char reply[40];
+    if (cover_cache_lookup(key, nowPlaying.coverBack)) {
+      resetCoverTransfer();
+      nowPlaying.coverReceiving = false;
+      nowPlaying.coverIndex = NP_COVER_PIXELS;
+      nowPlaying.coverTotal = NP_COVER_PIXELS;
+      memcpy(nowPlaying.coverFront, nowPlaying.coverBack, sizeof(nowPlaying.coverFront));
+      nowPlaying.coverValid = true;
+      coverCacheKeyValid = false;
+      snprintf(reply, sizeof(reply), "COV HIT %016llX", static_cast<unsigned long long>(key));
+    } else {
+      coverCacheKey = key;
+      coverCacheKeyValid = true;
+      snprintf(reply, sizeof(reply), "COV MISS %016llX", static_cast<unsigned long long>(key));
+    }
+    sendLine(reply);
+  } else if (strncmp(line, "NP COV CHK ", 11) == 0) {
+    handshakeOk = true;
+    nowPlaying.lastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+    handleCoverChunk(line + 11);
+  } else if (strncmp(line, "NP COV ABORT", 12) == 0) {
+    unsigned xfer = static_cast<unsigned>(atoi(line + 12));
+    if (coverXfer.id != 0 && (xfer == 0 || xfer == coverXfer.id)) {
+      nowPlaying.coverReceiving = false;
+      resetCoverTransfer();
+    }
+  } else if (strncmp(line, "NP COV DATA ", 12) == 0) {
+    handshakeOk = true;
+    nowPlaying.lastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+    const char *hex = line + 12;
+    size_t len = strlen(hex);
+    int coverLimit = nowPlaying.coverTotal > 0 ? nowPlaying.coverTotal : NP_COVER_PIXELS;
+    if (coverLimit > NP_COVER_PIXELS) coverLimit = NP_COVER_PIXELS;
+    for (size_t i = 0; i + 3 < len && nowPlaying.coverIndex < coverLimit; i += 4) {
+      int n0 = cover_hex_nibble(hex[i]);
+      int n1 = cover_hex_nibble(hex[i + 1]);
+      int n2 = cover_hex_nibble(hex[i + 2]);
+      int n3 = cover_hex_nibble(hex[i + 3]);
+      if (n0 < 0 || n1 < 0 || n2 < 0 || n3 < 0) continue;
+      uint16_t value = static_cast<uint16_t>((n0 << 12) | (n1 << 8) | (n2 << 4) | n3);
+      // Cover data is transferred as hex; swap bytes to match panel endian.
+      value = static_cast<uint16_t>((value >> 8) | (value << 8));
+      nowPlaying.coverBack[nowPlaying.coverIndex++] = value;
+    }
+  } else if (strncmp(line, "NP COV END", 10) == 0) {
+    handshakeOk = true;
+    nowPlaying.lastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
+    if (coverXfer.id != 0) {
+      // Windowed mode commits on the last chunk; END only re-triggers an ack so
+      // the PC can repair any remaining holes.
+      coverXfer.ackPending = true;
+      return;
+    }
+    int coverLimit = nowPlaying.coverTotal > 0 ? nowPlaying.coverTotal : NP_COVER_PIXELS;
+    if (coverLimit > NP_COVER_PIXELS) coverLimit = NP_COVER_PIXELS;
+    if (nowPlaying.coverIndex >= coverLimit) {
+      nowPlaying.coverReceiving = false;
+      commitCover();
+    } else {
+      nowPlaying.coverReceiving = false;
+      nowPlaying.coverValid = false;
+    }
+    ESP_LOGI("COVER", "COV END count=%d", nowPlaying.coverIndex);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "APP RX NP COV END %d", nowPlaying.coverIndex);
+    sendLine(msg);
+  }
+}
+
+void pumpCoverLines() {
+  char line[COVER_LINE_MAX];
+  while (true) {
+    portENTER_CRITICAL(&coverLineMux);
+    if (coverLineCount == 0) {
+      portEXIT_CRITICAL(&coverLineMux);
+      return;
+    }
+    memcpy(line, coverLineQueue[coverLineHead], sizeof(line));
+    coverLineHead = static_cast<uint8_t>((coverLineHead + 1) % COVER_LINE_QUEUE_SIZE);
+    coverLineCount--;
+    portEXIT_CRITICAL(&coverLineMux);
+    handleCoverLine(line);
+  }
+}
+
 extern "C" void handleLine(char *line) {
   lastRxMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL); // 更新接收时间
+  rxLineCount = rxLineCount + 1;
   
   // Debug: log all received lines
   ESP_LOGI("SERIAL", "RX: %s", line);
-  
+
+  if (line[0] == '@') {
+    // Sequenced state line; drop what a replay overlaps with.
+    size_t rawLen = strlen(line);
+    char *body = nullptr;
+    uint32_t seq = strtoul(line + 1, &body, 10);
+    if (!body || *body != ' ') return;
+    line = body + 1;
+    if (linkSession.valid) {
+      if (seq <= linkSession.lastSeq) return;
+      linkSession.lastSeq = seq;
+      if (linkSession.replaying) {
+        linkSession.replayLines++;
+        linkSession.replayBytes += static_cast<uint32_t>(rawLen + 1);
+        if (seq >= linkSession.targetSeq) finishResume();
+      }
+    }
+  }
+
+  if (strncmp(line, "SESSION ", 8) == 0) {
+    unsigned long id = 0;
+    unsigned long seq = 0;
+    if (sscanf(line + 8, "%lx %lu", &id, &seq) == 2) {
+      linkSession = {};
+      linkSession.valid = true;
+      linkSession.id = static_cast<uint32_t>(id);
+      linkSession.lastSeq = static_cast<uint32_t>(seq);
+    }
+    return;
+  }
+  if (strncmp(line, "RESUME OK", 9) == 0) {
+    unsigned lines = 0;
+    unsigned long target = 0;
+    sscanf(line + 9, "%u %lu", &lines, &target);
+    handshakeOk = true;
+    syncedAfterHandshake = true;
+    linkSession.resuming = false;
+    linkSession.targetSeq = static_cast<uint32_t>(target);
+    linkSession.replayLines = 0;
+    linkSession.replayBytes = static_cast<uint32_t>(strlen(line) + 1);
+    linkSession.replaying = true;
+    if (linkSession.targetSeq <= linkSession.lastSeq) finishResume();
+    return;
+  }
+  if (strcmp(line, "RESUME FAIL") == 0) {
+    linkSession = {};
+    handshakeOk = true;
+    syncedAfterHandshake = true;
+    requestStateSnapshot();
+    return;
+  }
+
+  if (strncmp(line, "CAPS", 4) == 0 && (line[4] == ' ' || line[4] == '\0')) {
+    bridgeCapsPending = {true, false};
+    for (const char *tok = line + 4; *tok;) {
+      while (*tok == ' ') tok++;
+      size_t len = strcspn(tok, " ");
+      if (len == 6 && strncmp(tok, "VOLSEQ", 6) == 0) bridgeCapsPending.volSeq = true;
+      tok += len;
+    }
+    return;
+  }
+
   if (strncmp(line, "HELLO", 5) == 0) {
+    bridgeCaps = bridgeCapsPending.announced ? bridgeCapsPending : BridgeCaps{};
+    bridgeCapsPending = {};
+    if (line[5] == '\0') {  // a bridge (re)connecting; its clock is a new one
+      linkClock = {};
+      if (linkSession.valid) {
+        // Same bridge after a drop? Let it decide between replay and resync.
+        handshakeOk = true;
+        sendHello();
+        return;
+      }
+      sendLine(DEVICE_CAPS);
+    } else if (linkSession.resuming) {
+      linkSession = {};  // answered HELLO RESUME like a plain HELLO: no resume support
+    }
     sendLine("HELLO OK");
     handshakeOk = true;
     if (!syncedAfterHandshake) {
       syncedAfterHandshake = true;
-      sendVolumeGet();
+      requestStateSnapshot();
     }
     return;
   }
@@ -661,16 +1817,78 @@ extern "C" void handleLine(char *line) {
     handshakeOk = true;
     if (!syncedAfterHandshake) {
       syncedAfterHandshake = true;
-      sendVolumeGet();
+      requestStateSnapshot();
+    }
+    return;
+  }
+  if (strncmp(line, "PING ", 5) == 0) {
+    char msg[LINK_BULK_LINE_MAX];
+    snprintf(msg, sizeof(msg), "PONG %s", line + 5);
+    sendBulkLine(msg);
+    return;
+  }
+  if (strncmp(line, "PONG ", 5) == 0) {
+    unsigned seq = 0;
+    unsigned long sentMs = 0;
+    if (sscanf(line + 5, "%u %lu", &seq, &sentMs) == 2) {
+      uint32_t rtt = lastRxMs - static_cast<uint32_t>(sentMs);
+      if (rtt < 60000) rttRecord(linkRtt[linkProbeRoute[seq % LINK_PROBE_SLOTS]], rtt);
+    }
+    return;
+  }
+  if (strcmp(line, "DIAG RTT") == 0) {
+    for (int t = 0; t < LINK_TRANSPORTS; ++t) {
+      char stats[64];
+      char msg[96];
+      formatRtt(stats, sizeof(stats), linkRtt[t]);
+      snprintf(msg, sizeof(msg), "DIAG RTT %s %s", LINK_TRANSPORT_NAMES[t], stats);
+      sendBulkLine(msg);
+    }
+    return;
+  }
+  if (strncmp(line, "DIAG RTT ", 9) == 0) {
+    strncpy(linkPeerRtt, line + 9, sizeof(linkPeerRtt) - 1);
+    linkPeerRtt[sizeof(linkPeerRtt) - 1] = '\0';
+    return;
+  }
+  if (strncmp(line, "DIAG PING ", 10) == 0) {
+    long ms = atol(line + 10);
+    linkProbeIntervalMs = ms <= 0 ? 0 : std::max<uint32_t>(static_cast<uint32_t>(ms), LINK_PROBE_MIN_MS);
+    return;
+  }
+  if (strncmp(line, "TIME REQ ", 9) == 0) {
+    // t2 is the receive time stamped above, t3 is now.
+    char msg[64];
+    snprintf(msg, sizeof(msg), "TIME RSP %s %lu %lu", line + 9, static_cast<unsigned long>(lastRxMs),
+             static_cast<unsigned long>(esp_timer_get_time() / 1000ULL));
+    sendLine(msg);
+    return;
+  }
+  if (strncmp(line, "TIME SET ", 9) == 0) {
+    unsigned long offset = 0;
+    unsigned long rtt = 0;
+    if (sscanf(line + 9, "%lu %lu", &offset, &rtt) == 2) {
+      linkClock.valid = true;
+      linkClock.offsetMs = static_cast<uint32_t>(offset);
+      linkClock.rttMs = static_cast<uint32_t>(rtt);
+      linkClock.syncs++;
+      linkClock.dirty = true;
     }
     return;
   }
+  if (strncmp(line, "STATE ", 6) == 0) {
+    handshakeOk = true;
+    applyStateSnapshot(line + 6);
+    return;
+  }
   if (strncmp(line, "VOL ", 4) == 0) {
-    int v = atoi(line + 4);
+    int v = 0;
+    unsigned seq = 0;
+    int fields = sscanf(line + 4, "%d %u", &v, &seq);
     if (v < 0) v = 0;
     if (v > 100) v = 100;
-    // 只有在不处于音量调节模式时才接受PC端的音量更新
-    if (appMode != MODE_VOLUME_ADJUST) {
+    // 本地旋钮值尚未被确认时不接受PC端的音量（旧序号的回显直接丢弃）
+    if (takeVolumeEcho(fields >= 2, static_cast<uint16_t>(seq))) {
       volumeValue = static_cast<uint8_t>(v);
       updateVolumeWidgets();
     }
@@ -678,7 +1896,8 @@ extern "C" void handleLine(char *line) {
     int m = atoi(line + 5);
     muteState = (m != 0);
     updateMuteWidgets();
-  } else if (strcmp(line, "SPK BEGIN") == 0) {
+  } else if (strncmp(line, "SPK BEGIN", 9) == 0) {
+    speakerListVersion = static_cast<uint16_t>(atoi(line + 9));
     speakersLoading = true;
     speakers.clear();
     rebuildOutputMenu();
@@ -695,10 +1914,13 @@ extern "C" void handleLine(char *line) {
   } else if (strcmp(line, "SPK END") == 0) {
     speakersLoading = false;
     rebuildOutputMenu();
+  } else if (strncmp(line, "SPK ADD ", 8) == 0 || strncmp(line, "SPK DEL ", 8) == 0 ||
+             strncmp(line, "SPK REN ", 8) == 0) {
+    applyDeviceListDelta(true, line + 4);
   } else if (strncmp(line, "SPK CUR ", 8) == 0) {
-    speakerCurrentId = atoi(line + 8);
-    rebuildOutputMenu();
-  } else if (strcmp(line, "MIC BEGIN") == 0) {
+    setCurrentDevice(true, atoi(line + 8));
+  } else if (strncmp(line, "MIC BEGIN", 9) == 0) {
+    microphoneListVersion = static_cast<uint16_t>(atoi(line + 9));
     microphonesLoading = true;
     microphones.clear();
     rebuildInputMenu();
@@ -715,15 +1937,35 @@ extern "C" void handleLine(char *line) {
   } else if (strcmp(line, "MIC END") == 0) {
     microphonesLoading = false;
     rebuildInputMenu();
+  } else if (strncmp(line, "MIC ADD ", 8) == 0 || strncmp(line, "MIC DEL ", 8) == 0 ||
+             strncmp(line, "MIC REN ", 8) == 0) {
+    applyDeviceListDelta(false, line + 4);
   } else if (strncmp(line, "MIC CUR ", 8) == 0) {
-    microphoneCurrentId = atoi(line + 8);
-    rebuildInputMenu();
+    setCurrentDevice(false, atoi(line + 8));
+  } else if (strncmp(line, "LRC BEGIN", 9) == 0) {
+    clearLyricTimeline();
+    lyricTimeline.loading = true;
+  } else if (strncmp(line, "LRC L ", 6) == 0) {
+    if (lyricTimeline.loading) appendLyricCue(line + 6);
+  } else if (strncmp(line, "LRC END", 7) == 0) {
+    if (!lyricTimeline.loading) return;
+    lyricTimeline.loading = false;
+    lyricTimeline.ready = lyricTimeline.count > 0;
+    lyricTimeline.current = -2;  // force the first schedule pass to publish
+    lyricLayout.dirty = true;
+    char msg[64];
+    snprintf(msg, sizeof(msg), "LRC OK %d%s", lyricTimeline.count, lyricTimeline.truncated ? " TRUNC" : "");
+    sendLine(msg);
+    ESP_LOGI("LYRIC", "timeline %d cues, %d/%d arena bytes", lyricTimeline.count, lyricTimeline.arenaUsed,
+             LYRIC_ARENA_BYTES);
+  } else if (lyricTimeline.ready && (strncmp(line, "LRC CUR ", 8) == 0 || strncmp(line, "LRC NXT ", 8) == 0)) {
+    // Scheduled locally; a late push would only make the display flicker.
   } else if (strncmp(line, "LRC CUR ", 8) == 0) {
     // Current lyric line
     const char *text = line + 8;
-    strncpy(currentLyric.text, text, sizeof(currentLyric.text) - 1);
-    currentLyric.text[sizeof(currentLyric.text) - 1] = '\0';
+    setLyricText(currentLyric, text, strlen(text));
     currentLyric.active = true;
+    lyricLayout.dirty = true;
     lyricScrollOffset = 0;
     lyricLastUpdateMs = esp_timer_get_time() / 1000;
     
@@ -736,11 +1978,12 @@ extern "C" void handleLine(char *line) {
   } else if (strncmp(line, "LRC NXT ", 8) == 0) {
     // Next lyric line (preview)
     const char *text = line + 8;
-    strncpy(nextLyric.text, text, sizeof(nextLyric.text) - 1);
-    nextLyric.text[sizeof(nextLyric.text) - 1] = '\0';
+    setLyricText(nextLyric, text, strlen(text));
     nextLyric.active = true;
+    lyricLayout.dirty = true;
   } else if (strcmp(line, "LRC CLR") == 0) {
     // Clear lyrics
+    clearLyricTimeline();
     currentLyric.active = false;
     nextLyric.active = false;
     lyricScrollOffset = 0;
@@ -750,50 +1993,41 @@ extern "C" void handleLine(char *line) {
     handshakeOk = true;
     if (!syncedAfterHandshake) {
       syncedAfterHandshake = true;
-      sendVolumeGet();
-    }
-    const char *p = line + 8;
-    const char *sep = strchr(p, '\t');
-    if (!sep) sep = strchr(p, '|');
-    size_t titleLen = sep ? static_cast<size_t>(sep - p) : strlen(p);
-    if (titleLen >= sizeof(nowPlaying.title)) titleLen = sizeof(nowPlaying.title) - 1;
-    char newTitle[64];
-    strncpy(newTitle, p, titleLen);
-    newTitle[titleLen] = '\0';
-
-    char newArtist[64];
-    if (sep) {
-      const char *artist = sep + 1;
-      size_t artistLen = strlen(artist);
-      if (artistLen >= sizeof(newArtist)) artistLen = sizeof(newArtist) - 1;
-      strncpy(newArtist, artist, artistLen);
-      newArtist[artistLen] = '\0';
-    } else {
-      newArtist[0] = '\0';
-    }
-
-    bool sameMeta = (strcmp(nowPlaying.title, newTitle) == 0) &&
-                    (strcmp(nowPlaying.artist, newArtist) == 0);
-    strncpy(nowPlaying.title, newTitle, sizeof(nowPlaying.title) - 1);
-    nowPlaying.title[sizeof(nowPlaying.title) - 1] = '\0';
-    strncpy(nowPlaying.artist, newArtist, sizeof(nowPlaying.artist) - 1);
-    nowPlaying.artist[sizeof(nowPlaying.artist) - 1] = '\0';
-    nowPlaying.active = true;
-    nowPlaying.lastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
-    if (!sameMeta) {
-      nowPlaying.coverValid = false;
-      nowPlaying.coverReceiving = false;
-      nowPlaying.coverIndex = 0;
-      nowPlaying.coverTotal = NP_COVER_PIXELS;
-      memset(nowPlaying.coverFront, 0, sizeof(nowPlaying.coverFront));
-      memset(nowPlaying.coverBack, 0, sizeof(nowPlaying.coverBack));
+      requestStateSnapshot();
     }
+    applyNowPlayingMeta(line + 8);
     sendLine("APP RX NP META");
   } else if (strncmp(line, "NP PROG ", 8) == 0) {
     handshakeOk = true;
     long pos = 0;
     long dur = 0;
-    if (sscanf(line + 8, "%ld %ld", &pos, &dur) == 2) {
+    char stateTok[2] = "";
+    int ratePct = 100;
+    unsigned long sampledPcMs = 0;
+    int fields = sscanf(line + 8, "%ld %ld %1s %d %lu", &pos, &dur, stateTok, &ratePct, &sampledPcMs);
+    if (fields >= 2) {
+      if (ratePct <= 0 || ratePct > 400) ratePct = 100;
+      if (fields >= 5 && linkClock.valid) {
+        // The PC sampled pos at sampledPcMs; advance it by the time in flight.
+        uint32_t sampledMs = static_cast<uint32_t>(sampledPcMs) + linkClock.offsetMs;
+        int32_t ageMs = static_cast<int32_t>(lastRxMs - sampledMs);
+        if (ageMs < 0) ageMs = 0;
+        if (ageMs <= static_cast<int32_t>(LINK_AGE_MAX_MS)) {
+          if (stateTok[0] == 'P') pos += static_cast<long>(ageMs) * ratePct / 100;
+          linkClock.progAgeSumMs += static_cast<uint32_t>(ageMs);
+          if (static_cast<uint32_t>(ageMs) > linkClock.progAgeMaxMs) linkClock.progAgeMaxMs = static_cast<uint32_t>(ageMs);
+          linkClock.progStamped++;
+          linkClock.dirty = true;
+        }
+      }
+      if (lyricTimeline.ready && playbackClock.playing) {
+        uint32_t err = static_cast<uint32_t>(std::abs(estimatePositionMs() - static_cast<int32_t>(pos)));
+        lyricAccuracy.corrections++;
+        lyricAccuracy.posErrSumMs += err;
+        if (err > lyricAccuracy.posErrMaxMs) lyricAccuracy.posErrMaxMs = err;
+      }
+      int state = fields >= 3 ? (stateTok[0] == 'P' ? 1 : 0) : -1;
+      updatePlaybackClock(static_cast<int32_t>(pos), state, ratePct / 100.0);
       nowPlaying.posMs = static_cast<int32_t>(pos);
       nowPlaying.durMs = static_cast<int32_t>(dur);
       nowPlaying.active = true;
@@ -802,108 +2036,59 @@ extern "C" void handleLine(char *line) {
   } else if (strncmp(line, "NP CLR", 6) == 0) {
     handshakeOk = true;
     clearNowPlayingState(true);
-  } else if (strncmp(line, "NP COV BEGIN", 12) == 0) {
-    handshakeOk = true;
-    nowPlaying.coverReceiving = true;
-    nowPlaying.coverIndex = 0;
-    nowPlaying.coverTotal = NP_COVER_PIXELS;
-    nowPlaying.lastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
-    int w = 0;
-    int h = 0;
-    if (sscanf(line + 12, "%d %d", &w, &h) == 2 && w > 0 && h > 0) {
-      int total = w * h;
-      if (total > 0 && total < NP_COVER_PIXELS) {
-        nowPlaying.coverTotal = total;
-      } else {
-        nowPlaying.coverTotal = NP_COVER_PIXELS;
-      }
-    }
-    memset(nowPlaying.coverBack, 0, sizeof(nowPlaying.coverBack));
-    sendLine("APP RX NP COV BEGIN");
-  } else if (strncmp(line, "NP COV DATA ", 12) == 0) {
-    handshakeOk = true;
-    nowPlaying.lastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
-    const char *hex = line + 12;
-    size_t len = strlen(hex);
-    int coverLimit = nowPlaying.coverTotal > 0 ? nowPlaying.coverTotal : NP_COVER_PIXELS;
-    if (coverLimit > NP_COVER_PIXELS) coverLimit = NP_COVER_PIXELS;
-    for (size_t i = 0; i + 3 < len && nowPlaying.coverIndex < coverLimit; i += 4) {
-      auto nibble = [](char c) -> int {
-        if (c >= '0' && c <= '9') return c - '0';
-        if (c >= 'a' && c <= 'f') return 10 + (c - 'a');
-        if (c >= 'A' && c <= 'F') return 10 + (c - 'A');
-        return -1;
-      };
-      int n0 = nibble(hex[i]);
-      int n1 = nibble(hex[i + 1]);
-      int n2 = nibble(hex[i + 2]);
-      int n3 = nibble(hex[i + 3]);
-      if (n0 < 0 || n1 < 0 || n2 < 0 || n3 < 0) continue;
-      uint16_t value = static_cast<uint16_t>((n0 << 12) | (n1 << 8) | (n2 << 4) | n3);
-      // Cover data is transferred as hex; swap bytes to match panel endian.
-      value = static_cast<uint16_t>((value >> 8) | (value << 8));
-      nowPlaying.coverBack[nowPlaying.coverIndex++] = value;
-    }
-  } else if (strncmp(line, "NP COV END", 10) == 0) {
-    handshakeOk = true;
-    nowPlaying.lastUpdateMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
-    int coverLimit = nowPlaying.coverTotal > 0 ? nowPlaying.coverTotal : NP_COVER_PIXELS;
-    if (coverLimit > NP_COVER_PIXELS) coverLimit = NP_COVER_PIXELS;
-    if (nowPlaying.coverIndex >= coverLimit) {
-      nowPlaying.coverReceiving = false;
-      memcpy(nowPlaying.coverFront, nowPlaying.coverBack, sizeof(nowPlaying.coverFront));
-      nowPlaying.coverValid = true;
-    } else {
-      nowPlaying.coverReceiving = false;
-      nowPlaying.coverValid = false;
-    }
-    ESP_LOGI("COVER", "COV END count=%d", nowPlaying.coverIndex);
-    char msg[64];
-    snprintf(msg, sizeof(msg), "APP RX NP COV END %d", nowPlaying.coverIndex);
-    sendLine(msg);
+  } else if (strncmp(line, "NP COV ", 7) == 0) {
+    queueCoverLine(line);
   }
 }
 
 void readSerial() {
-  uint8_t data[64];
-  int len = uart_read_bytes(UART_NUM_0, data, sizeof(data), 0);
-  if (len > 0) {
+  // Drain what the UART has buffered (bounded per loop) so a control line that
+  // arrives behind cover data is handled this frame instead of frames later.
+  uint8_t data[256];
+  size_t budget = UART_RX_BUDGET_PER_LOOP;
+  while (budget > 0) {
+    size_t want = std::min(sizeof(data), budget);
+    int len = uart_read_bytes(UART_NUM_0, data, want, 0);
+    if (len <= 0) break;
+    budget -= static_cast<size_t>(len);
     rxBytes += static_cast<uint32_t>(len);
     lastUsbRxMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
-  }
-  for (int i = 0; i < len; ++i) {
-    char c = static_cast<char>(data[i]);
-    if (c == '\n') {
-      serialBuf[serialLen] = '\0';
-      if (serialLen > 0) handleLine(serialBuf);
-      serialLen = 0;
-    } else if (c != '\r') {
-      if (serialLen < sizeof(serialBuf) - 1) {
-        serialBuf[serialLen++] = c;
+    for (int i = 0; i < len; ++i) {
+      char c = static_cast<char>(data[i]);
+      if (c == '\n') {
+        serialBuf[serialLen] = '\0';
+        if (serialLen > 0) handleLine(serialBuf);
+        serialLen = 0;
+      } else if (c != '\r') {
+        if (serialLen < sizeof(serialBuf) - 1) {
+          serialBuf[serialLen++] = c;
+        }
       }
     }
+    if (static_cast<size_t>(len) < want) break;
   }
 }
 
-int speakerIdForMenu(Menu *item) {
-  for (const auto &pair : speakerMenuMap) {
-    if (pair.first == item) return pair.second;
-  }
-  return -1;
-}
+int speakerIdForMenu(Menu *item) { return device_row_id(&deviceRows, item, menuOutput); }
 
-int micIdForMenu(Menu *item) {
-  for (const auto &pair : microphoneMenuMap) {
-    if (pair.first == item) return pair.second;
-  }
-  return -1;
-}
+int micIdForMenu(Menu *item) { return device_row_id(&deviceRows, item, menuInput); }
 
 void handleConfirm(Menu *current) {
   if (!current) return;
   Menu *selected = current->childMenu.empty() ? nullptr : current->childMenu[current->selectIndex];
 
   if (current == menuMain) {
+    if (selected == menuLyrics) {
+      if (!lyricLayout.stripBuf) {
+        lyricLayout.stripBuf = new uint8_t[LYRIC_STRIP_SLOTS * HAL::getStripBytes()];
+      }
+      lyricLayout.snap = true;
+      lyricLayout.frameValid = false;
+      appMode = MODE_LYRICS_FULL;
+      adjustActive = true;
+      adjustTarget = ADJ_NONE;
+      return;
+    }
     if (selected == menuVolume) {
       if (!canUseControlFeatures()) {
         popInfoGlobal("Link Unavailable", 700);
@@ -977,9 +2162,8 @@ void handleConfirm(Menu *current) {
     }
     int id = speakerIdForMenu(selected);
     if (id >= 0) {
-      speakerCurrentId = id;
+      setCurrentDevice(true, id);
       sendSpeakerSet(id);
-      rebuildOutputMenu();
     }
     return;
   }
@@ -997,9 +2181,8 @@ void handleConfirm(Menu *current) {
     }
     int id = micIdForMenu(selected);
     if (id >= 0) {
-      microphoneCurrentId = id;
+      setCurrentDevice(false, id);
       sendMicSet(id);
-      rebuildInputMenu();
     }
     return;
   }
@@ -1064,6 +2247,11 @@ void handleConfirm(Menu *current) {
       updatePerfWidgets();
       return;
     }
+    if (selected == testAllocItem) {
+      showAlloc = allocCheck->toggle();
+      updatePerfWidgets();
+      return;
+    }
     if (selected == testLogItem) {
       mcuLogEnabled = logCheck->toggle();
       updatePerfWidgets();
@@ -1233,7 +2421,8 @@ void handleKeyEvents() {
   bool adjustCfgClose = (appMode == MODE_CFG_CLOSE_ADJUST);
   bool adjustTest = (appMode == MODE_TEST_PATTERN);
   bool adjustAbout = (appMode == MODE_ABOUT_INFO);
-  bool adjustMode = adjustActive && (adjustVolume || adjustSpi || adjustUi || adjustSel || adjustWrap || adjustColor || adjustScroll || adjustLyricScroll || adjustNpClose || adjustCfgClose || adjustTest || adjustAbout);
+  bool adjustLyrics = (appMode == MODE_LYRICS_FULL);
+  bool adjustMode = adjustActive && (adjustVolume || adjustSpi || adjustUi || adjustSel || adjustWrap || adjustColor || adjustScroll || adjustLyricScroll || adjustNpClose || adjustCfgClose || adjustTest || adjustAbout || adjustLyrics);
   auto consumeQueuedMenuSteps = [&]() {
     if (adjustMode || !launcher.getSelector()) return;
     int queued = hal.consumeQueuedEncoderSteps();
@@ -1254,7 +2443,7 @@ void handleKeyEvents() {
       if (adjustVolume) {
         if (volumeValue >= step) volumeValue = static_cast<uint8_t>(volumeValue - step);
         updateVolumeWidgets();
-        sendVolumeSet();
+        queueVolumeSet();
       } else if (adjustSpi) {
         if (spiPending > step) spiPending = static_cast<uint8_t>(spiPending - step);
         else spiPending = 1;
@@ -1323,7 +2512,7 @@ void handleKeyEvents() {
         if (volumeValue + step <= 100) volumeValue = static_cast<uint8_t>(volumeValue + step);
         else volumeValue = 100;
         updateVolumeWidgets();
-        sendVolumeSet();
+        queueVolumeSet();
       } else if (adjustSpi) {
         if (spiPending + step <= 80) spiPending = static_cast<uint8_t>(spiPending + step);
         else spiPending = 80;
@@ -1553,6 +2742,7 @@ void buildMenus() {
   menuTest = new List("Test Tools");
   menuMute = new List("Mute");
   menuSettings = new List("Settings");
+  menuLyrics = new List("Lyrics");
 
   volumeSlider = new Slider("Volume", 0, 100, 2, volumeValue);
   muteCheck = new CheckBox(muteState);
@@ -1560,6 +2750,7 @@ void buildMenus() {
   menuMain->addItem(menuVolume, volumeSlider);
   menuMain->addItem(menuOutput);
   menuMain->addItem(menuInput);
+  menuMain->addItem(menuLyrics);
   menuMain->addItem(menuTest);
   menuMain->addItem(menuSettings);
   menuMain->addItem(menuMute, muteCheck);
@@ -1568,6 +2759,14 @@ void buildMenus() {
   menuOutput->addItem(outputRefreshItem);
   inputRefreshItem = new List("Refresh List");
   menuInput->addItem(inputRefreshItem);
+  outputLoadingItem = new List("Loading...");
+  outputEmptyItem = new List("No devices");
+  inputLoadingItem = new List("Loading...");
+  inputEmptyItem = new List("No devices");
+  void *rowStorage = heap_caps_malloc(DEVICE_ROW_POOL_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!rowStorage) rowStorage = heap_caps_malloc(DEVICE_ROW_POOL_BYTES, MALLOC_CAP_8BIT);
+  if (!rowStorage) abort();
+  device_rows_init(&deviceRows, rowStorage);
 
   testIoItem = new List("IO Test");
   test4bitItem = new List("4bit Test");
@@ -1580,11 +2779,13 @@ void buildMenus() {
   testCpuItem = new List("CPU");
   testUpItem = new List("UP");
   testDownItem = new List("DOWN");
+  testAllocItem = new List("ALLOC");
   testLogItem = new List("MCU Log");
   fpsCheck = new CheckBox(showFps);
   cpuCheck = new CheckBox(showCpu);
   upCheck = new CheckBox(showUp);
   downCheck = new CheckBox(showDown);
+  allocCheck = new CheckBox(showAlloc);
   logCheck = new CheckBox(mcuLogEnabled);
   spiSlider = new Slider("SPI", 1, 80, 1, spiMHz);
   dmaCheck = new CheckBox(dmaEnabled);
@@ -1602,6 +2803,7 @@ void buildMenus() {
   menuTest->addItem(testCpuItem, cpuCheck);
   menuTest->addItem(testUpItem, upCheck);
   menuTest->addItem(testDownItem, downCheck);
+  menuTest->addItem(testAllocItem, allocCheck);
   menuTest->addItem(testLogItem, logCheck);
 
   uiSpeedItem = new List("UI Speed");
@@ -1766,40 +2968,109 @@ uint8_t mapCfgCloseFromMs(uint16_t ms) {
   return static_cast<uint8_t>(1 + ms / 200);
 }
 
-void rebuildInputMenu() {
-  for (auto *item : menuInput->childMenu) {
-    if (item == inputRefreshItem) continue;
-    delete item;
+// One PC endpoint list and the menu showing it. Versioned bridges send full
+// lists as <TAG> BEGIN <ver> and later changes as <TAG> ADD/DEL/REN <ver> ...,
+// each exactly one version ahead. A gap in the versions (missed line, bridge
+// restart) falls back to a full re-list.
+struct DeviceListRef {
+  DeviceMenu ui;
+  std::vector<SpeakerEntry> &entries;
+  int &currentId;
+  bool &loading;
+  bool requested;
+  uint16_t &version;
+  void (*requestList)();
+};
+
+DeviceListRef deviceList(bool output) {
+  if (output) {
+    return {{menuOutput, outputRefreshItem, outputLoadingItem, outputEmptyItem}, speakers, speakerCurrentId,
+            speakersLoading, speakersRequested, speakerListVersion, sendSpeakerListRequest};
   }
-  menuInput->childMenu.clear();
-  menuInput->childWidget.clear();
-  microphoneMenuMap.clear();
+  return {{menuInput, inputRefreshItem, inputLoadingItem, inputEmptyItem}, microphones, microphoneCurrentId,
+          microphonesLoading, microphonesRequested, microphoneListVersion, sendMicListRequest};
+}
 
-  menuInput->addItem(inputRefreshItem);
+void refreshDeviceSelector(const DeviceListRef &list) {
+  if (launcher.getCurrentMenu() == list.ui.menu && launcher.getSelector()) {
+    launcher.getSelector()->inject(list.ui.menu);
+  }
+}
 
-  if (microphonesLoading) {
-    auto *loading = new List("Loading...");
-    menuInput->addItem(loading);
-  } else if (microphones.empty()) {
-    auto *none = new List("No devices");
-    menuInput->addItem(none);
-  } else {
-    for (const auto &mic : microphones) {
-      std::string title = mic.name;
-      if (mic.id == microphoneCurrentId) title = "* " + title;
-      auto *item = new List(title);
-      menuInput->addItem(item);
-      microphoneMenuMap.push_back({item, mic.id});
-    }
+void syncDeviceMenu(bool output) {
+  DeviceListRef list = deviceList(output);
+  if (!device_menu_sync(&deviceRows, list.ui, list.entries, list.currentId, list.loading)) {
+    sendBulkLine("[REBUILD] device row pool exhausted");
+  }
+  refreshDeviceSelector(list);
+}
+
+void rebuildOutputMenu() { syncDeviceMenu(true); }
+
+void rebuildInputMenu() { syncDeviceMenu(false); }
+
+// Only the rows losing and gaining the "* " marker change.
+void setCurrentDevice(bool output, int id) {
+  DeviceListRef list = deviceList(output);
+  if (id == list.currentId) return;
+  int previous = list.currentId;
+  list.currentId = id;
+  for (const SpeakerEntry &entry : list.entries) {
+    if (entry.id == previous || entry.id == id) device_menu_retitle(&deviceRows, list.ui, entry, id);
   }
+  refreshDeviceSelector(list);
+}
 
-  menuInput->forePosInit();
-  if (launcher.getCamera()) {
-    menuInput->childPosInit(launcher.getCamera()->getPosition());
+void applyDeviceListDelta(bool output, const char *p) {
+  DeviceListRef list = deviceList(output);
+  char op[4] = {};
+  unsigned ver = 0;
+  int id = -1;
+  if (sscanf(p, "%3s %u %d", op, &ver, &id) != 3) return;
+  const char *name = p;
+  for (int i = 0; i < 3 && name; ++i) {
+    name = strchr(name, ' ');
+    if (name) name++;
+  }
+  if (!name) name = "";
+
+  if (!list.requested || list.loading) return;  // nothing shown yet, or a full list is on its way
+  uint16_t expected = static_cast<uint16_t>(list.version + 1);
+  if (expected == 0) expected = 1;
+  if (list.version == 0 || ver != expected) {
+    list.loading = true;
+    list.requestList();
+    syncDeviceMenu(output);
+    return;
+  }
+  list.version = expected;
+
+  // Deltas edit single pooled rows in place; rows below slide to their new
+  // slot. Going from or to an empty list swaps the "No devices" row, which
+  // takes the full sync.
+  auto entry = std::find_if(list.entries.begin(), list.entries.end(),
+                            [id](const SpeakerEntry &e) { return e.id == id; });
+  bool inPlace = true;
+  if (strcmp(op, "ADD") == 0) {
+    if (entry != list.entries.end()) return;
+    list.entries.push_back({id, name});
+    inPlace = device_menu_add(&deviceRows, list.ui, list.entries.back(), list.currentId);
+  } else if (strcmp(op, "DEL") == 0) {
+    if (entry == list.entries.end()) return;
+    list.entries.erase(entry);
+    inPlace = device_menu_remove(&deviceRows, list.ui, id);
+  } else if (strcmp(op, "REN") == 0) {
+    if (entry == list.entries.end()) return;
+    entry->name = name;
+    device_menu_retitle(&deviceRows, list.ui, *entry, list.currentId);
+  } else {
+    return;
   }
-  if (launcher.getCurrentMenu() == menuInput && launcher.getSelector()) {
-    launcher.getSelector()->inject(menuInput);
+  if (!inPlace) {
+    syncDeviceMenu(output);
+    return;
   }
+  refreshDeviceSelector(list);
 }
 
 uint16_t mapCfgCloseMs(uint8_t value) {
@@ -1832,14 +3103,6 @@ void popInfoGlobal(const std::string &text, uint16_t fallbackMs) {
   launcher.popInfo(text, getPopupDurationMs(fallbackMs));
 }
 
-int countUtf8Glyphs(const std::string &text) {
-  int count = 0;
-  for (unsigned char c : text) {
-    if ((c & 0xC0) != 0x80) count++;
-  }
-  return count;
-}
-
 void boostUiSpeed(float sliderValue) {
   uint8_t v = static_cast<uint8_t>(std::round(sliderValue));
   float scale = mapUiSpeedScale(v);
@@ -1874,17 +3137,21 @@ void applyFontColor() {
 }
 
 void clearNowPlayingState(bool clearLyrics) {
+  cancelCoverTransfer();
+  coverCacheKeyValid = false;
   nowPlaying.active = false;
   nowPlaying.coverValid = false;
   nowPlaying.coverReceiving = false;
   nowPlaying.coverIndex = 0;
   nowPlaying.coverTotal = NP_COVER_PIXELS;
   nowPlaying.lastUpdateMs = 0;
+  playbackClock = {};
   memset(nowPlaying.coverFront, 0, sizeof(nowPlaying.coverFront));
   memset(nowPlaying.coverBack, 0, sizeof(nowPlaying.coverBack));
   hal.clearImageOverlay();
   hal.clearBarOverlay();
   if (clearLyrics) {
+    clearLyricTimeline();
     currentLyric.active = false;
     nextLyric.active = false;
     lyricScrollOffset = 0;
@@ -1974,13 +3241,12 @@ void renderLyrics() {
 
   hal._setDrawType(1);
 
-  auto drawScrolling = [&](const std::string &text, int baselineY, bool enableScroll) {
-    if (text.empty()) return;
-    std::string tmp = text;
-    const int textW = HAL::getFontWidth(tmp);
+  auto drawScrolling = [&](const HAL::ShapedText &text, int baselineY, bool enableScroll) {
+    if (text.count == 0) return;
+    const int textW = text.width;
     const int avail = sys.screenWeight - margin * 2;
     if (!enableScroll || textW <= avail) {
-      hal._drawChinese(margin, baselineY, text);
+      hal._drawShaped(margin, baselineY, text);
       return;
     }
 
@@ -1991,24 +3257,173 @@ void renderLyrics() {
     uint32_t nowMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
     uint32_t elapsed = nowMs - lyricLastUpdateMs;
     if (elapsed < 300) {
-      hal._drawChinese(margin, baselineY, text);
+      hal._drawShaped(margin, baselineY, text);
       return;
     }
     uint32_t phase = static_cast<uint32_t>(elapsed % static_cast<uint32_t>(loopMs));
     int offset = static_cast<int>(std::round(static_cast<float>(phase) * cycle / loopMs));
     int x = margin - offset;
-    hal._drawChinese(x, baselineY, text);
+    hal._drawShaped(x, baselineY, text);
     if (x + cycle < sys.screenWeight) {
-      hal._drawChinese(x + cycle, baselineY, text);
+      hal._drawShaped(x + cycle, baselineY, text);
     }
   };
 
   int baseY = sys.screenHeight - 4;
   int nextY = baseY - fontH - 4;
 
-  drawScrolling(currentLyric.text, baseY, true);
+  drawScrolling(currentLyric.shaped, baseY, true);
   if (nextLyric.active && nextY > 0) {
-    drawScrolling(nextLyric.text, nextY, false);
+    drawScrolling(nextLyric.shaped, nextY, false);
+  }
+}
+
+int lyricCueCount() {
+  if (lyricTimeline.ready) return lyricTimeline.count;
+  if (!currentLyric.active) return 0;
+  return nextLyric.active ? 2 : 1;
+}
+
+// Without a timeline the live CUR/NXT pair stands in as cues 0 and 1.
+int lyricCurrentCue() {
+  if (lyricTimeline.ready) return lyricTimeline.current;
+  return currentLyric.active ? 0 : -1;
+}
+
+std::string_view lyricCueText(int cue) {
+  if (lyricTimeline.ready) {
+    const LyricCue &c = lyricTimeline.cues[cue];
+    return std::string_view(lyricTimeline.arena + c.offset, c.len);
+  }
+  return lyricLiveText[cue == 0 ? 0 : 1];
+}
+
+// Greedy wrap of every cue to the screen width, breaking after a space when
+// the row has one. Only glyph ranges are kept; strips re-shape their cue.
+void layoutLyrics() {
+  LyricLayout &l = lyricLayout;
+  l.dirty = false;
+  l.snap = true;
+  l.generation++;
+  l.rowCount = 0;
+  l.cueCount = 0;
+  // After clearing dirty: a line arriving past this point lays out again.
+  portENTER_CRITICAL(&textShapeMux);
+  memcpy(lyricLiveText[0], currentLyric.text, sizeof(lyricLiveText[0]));
+  memcpy(lyricLiveText[1], nextLyric.text, sizeof(lyricLiveText[1]));
+  portEXIT_CRITICAL(&textShapeMux);
+  const int maxW = HAL::getSystemConfig().screenWeight - LYRIC_FULL_MARGIN * 2;
+  HAL::ShapedText &shaped = lyricShapeScratch;
+  HAL::shapeText(" ", shaped);
+  const void *space = shaped.count ? shaped.glyphs[0].handle : nullptr;
+
+  const int cues = lyricCueCount();
+  for (int cue = 0; cue < cues; ++cue) {
+    HAL::shapeText(lyricCueText(cue), shaped);
+    if (l.rowCount >= LYRIC_ROWS_MAX) break;
+    l.cueRow[cue] = static_cast<uint16_t>(l.rowCount);
+    if (shaped.count == 0) {
+      l.rows[l.rowCount++] = {static_cast<uint16_t>(cue), 0, 0, 0};  // keep instrumental gaps
+    }
+    int start = 0;
+    while (start < shaped.count && l.rowCount < LYRIC_ROWS_MAX) {
+      int end = start;
+      int width = 0;
+      int lastBreak = -1;
+      while (end < shaped.count && width + shaped.glyphs[end].advance <= maxW) {
+        if (shaped.glyphs[end].handle == space) lastBreak = end;
+        width += shaped.glyphs[end].advance;
+        end++;
+      }
+      if (end == start) end = start + 1;  // a single glyph wider than the screen
+      else if (end < shaped.count && lastBreak > start) end = lastBreak + 1;
+      width = 0;
+      for (int i = start; i < end; ++i) width += shaped.glyphs[i].advance;
+      l.rows[l.rowCount++] = {static_cast<uint16_t>(cue), static_cast<uint16_t>(start),
+                              static_cast<uint16_t>(end - start), static_cast<int16_t>(width)};
+      start = end;
+    }
+    l.cueCount = cue + 1;
+  }
+  l.cueRow[l.cueCount] = static_cast<uint16_t>(l.rowCount);
+}
+
+// Strip for a row, rendered on a miss into the least recently used slot.
+const uint8_t *lyricRowStrip(int row) {
+  LyricLayout &l = lyricLayout;
+  const size_t stripBytes = HAL::getStripBytes();
+  LyricStrip *victim = &l.strips[0];
+  for (int i = 0; i < LYRIC_STRIP_SLOTS; ++i) {
+    LyricStrip &s = l.strips[i];
+    if (s.row == row && s.generation == l.generation) {
+      s.used = ++l.stripTick;
+      return l.stripBuf + i * stripBytes;
+    }
+    bool stale = s.generation != l.generation;
+    bool victimStale = victim->generation != l.generation;
+    if ((stale && !victimStale) || (stale == victimStale && s.used < victim->used)) victim = &s;
+  }
+  const LyricRow &r = l.rows[row];
+  uint8_t *buf = l.stripBuf + (victim - l.strips) * stripBytes;
+  HAL::shapeText(lyricCueText(r.cue), lyricShapeScratch);
+  const float x = static_cast<float>((HAL::getSystemConfig().screenWeight - r.width) / 2);
+  HAL::renderStrip(buf, x, lyricShapeScratch, r.glyphStart, r.glyphCount);
+  victim->row = row;
+  victim->generation = l.generation;
+  victim->used = ++l.stripTick;
+  return buf;
+}
+
+void renderLyricsFull() {
+  HAL::canvasClear();
+  Animation::tick();
+  auto &sys = HAL::getSystemConfig();
+  const int w = sys.screenWeight;
+  const int h = sys.screenHeight;
+  if (w <= 0 || h <= 0) return;
+
+  hal._setFont(u8g2_font_zpix);
+  HAL::setDrawType(1);
+  if (lyricLayout.dirty) layoutLyrics();
+  LyricLayout &l = lyricLayout;
+  l.scrollOnly = false;
+  if (l.rowCount == 0 || !l.stripBuf) {
+    const char *empty = "No Lyrics";
+    HAL::drawEnglish(static_cast<float>((w - HAL::getFontWidth(empty)) / 2),
+                     static_cast<float>((h + HAL::getFontHeight()) / 2), empty);
+    return;
+  }
+
+  // The current cue sits a third of the way down; the view eases towards it.
+  const int pitch = HAL::getFontHeight() + LYRIC_ROW_GAP;
+  int cur = lyricCurrentCue();
+  if (cur >= l.cueCount) cur = -1;
+  const int anchor = (h - pitch) / 3;
+  const float target = static_cast<float>((cur >= 0 ? l.cueRow[cur] * pitch : 0) - anchor);
+  if (l.snap) {
+    l.scroll = target;
+    l.snap = false;
+  }
+  Animation::move(&l.scroll, target, getUIConfig().listAnimationSpeed);
+
+  const int scroll = static_cast<int>(std::round(l.scroll));
+  l.scrollOnly = l.frameValid && l.drawnGeneration == l.generation && l.drawnCue == cur;
+  l.scrollDelta = scroll - l.drawnScroll;
+  l.drawnGeneration = l.generation;
+  l.drawnCue = cur;
+  l.drawnScroll = scroll;
+  if (cur >= 0) {
+    const int top = l.cueRow[cur] * pitch - scroll - LYRIC_ROW_GAP / 2;
+    const int rows = l.cueRow[cur + 1] - l.cueRow[cur];
+    HAL::drawRBox(LYRIC_FULL_MARGIN / 2, static_cast<float>(top), static_cast<float>(w - LYRIC_FULL_MARGIN),
+                  static_cast<float>(rows * pitch), 2);
+  }
+  int row = scroll > 0 ? scroll / pitch : 0;
+  for (; row < l.rowCount; ++row) {
+    const int y = row * pitch - scroll;
+    if (y >= h) break;
+    if (l.rows[row].glyphCount == 0) continue;
+    HAL::drawStrip(lyricRowStrip(row), static_cast<float>(y), 0, static_cast<float>(h), l.rows[row].cue == cur);
   }
 }
 
@@ -2042,6 +3457,10 @@ void renderNowPlayingOverlay() {
   int coverY = panelY + padding;
   if (nowPlaying.coverValid) {
     hal.setImageOverlay(nowPlaying.coverFront, NP_COVER_W, NP_COVER_H, coverX, coverY);
+  } else if (nowPlaying.coverReceiving && coverXfer.decoder.interlaced &&
+             cover_decoder_preview_ready(&coverXfer.decoder)) {
+    // Coarse passes already fill every cell; show the back buffer as it refines.
+    hal.setImageOverlay(nowPlaying.coverBack, NP_COVER_W, NP_COVER_H, coverX, coverY);
   } else {
     hal.clearImageOverlay();
     HAL::drawRFrame(coverX, coverY, cover, cover, 4);
@@ -2078,22 +3497,21 @@ void renderNowPlayingOverlay() {
   int line2Y = line1Y + fontH + 2;
   int line3Y = line2Y + fontH + 2;
 
-  auto drawScroll = [&](const std::string &text, int x, int y, int maxW, int idx) {
-    std::string tmp = text;
-    int textW = HAL::getFontWidth(tmp);
+  auto drawScroll = [&](const HAL::ShapedText &text, int x, int y, int maxW, int idx) {
+    int textW = text.width;
     if (textW <= maxW) {
       int clipX0 = x;
       int clipY0 = y - fontH;
       int clipX1 = x + maxW;
       int clipY1 = y + 2;
       HAL::setClipWindow(clipX0, clipY0, clipX1, clipY1);
-      HAL::drawChinese(x, y, text);
+      HAL::drawShaped(x, y, text);
       HAL::clearClipWindow();
       return;
     }
     float gap = std::max(8.0f, maxW * 0.2f);
     float cyclePx = textW + gap;
-    int glyphs = countUtf8Glyphs(text);
+    int glyphs = text.count;
     float avgPx = glyphs > 0 ? static_cast<float>(textW) / static_cast<float>(glyphs) : static_cast<float>(textW);
     float cps = static_cast<float>(lyricScrollCpsValue);
     if (cps < 1.0f) cps = 1.0f;
@@ -2108,21 +3526,18 @@ void renderNowPlayingOverlay() {
     int clipX1 = x + maxW;
     int clipY1 = y + 2;
     HAL::setClipWindow(clipX0, clipY0, clipX1, clipY1);
-    HAL::drawChinese(baseX, y, text);
-    HAL::drawChinese(baseX + cyclePx, y, text);
+    HAL::drawShaped(baseX, y, text);
+    HAL::drawShaped(baseX + cyclePx, y, text);
     HAL::clearClipWindow();
   };
 
-  std::string title = nowPlaying.title[0] ? nowPlaying.title : std::string("Unknown");
-  std::string artist = nowPlaying.artist[0] ? nowPlaying.artist : std::string("");
-  drawScroll(title, textX, line1Y, textMaxW, 0);
-  if (!artist.empty()) {
-    drawScroll(artist, textX, line2Y, textMaxW, 1);
+  drawScroll(nowPlaying.titleShaped, textX, line1Y, textMaxW, 0);
+  if (nowPlaying.artistShaped.count > 0) {
+    drawScroll(nowPlaying.artistShaped, textX, line2Y, textMaxW, 1);
   }
 
   if (currentLyric.active) {
-    std::string lyric = currentLyric.text;
-    drawScroll(lyric, textX, line3Y, textMaxW, 2);
+    drawScroll(currentLyric.shaped, textX, line3Y, textMaxW, 2);
   }
 
   int barY = panelY + panelH - padding - 2;
@@ -2130,21 +3545,22 @@ void renderNowPlayingOverlay() {
   int barW = panelX + panelW - padding - barX;
   if (barW > 4) {
     float ratio = 0.0f;
-    if (nowPlaying.durMs > 0) ratio = std::min(1.0f, std::max(0.0f, (float)nowPlaying.posMs / (float)nowPlaying.durMs));
+    int32_t posMs = estimatePositionMs();
+    if (nowPlaying.durMs > 0) ratio = std::min(1.0f, std::max(0.0f, (float)posMs / (float)nowPlaying.durMs));
     if (nowPlaying.durMs > 0) {
-      int remainMs = std::max<int32_t>(0, nowPlaying.durMs - nowPlaying.posMs);
+      int remainMs = std::max<int32_t>(0, nowPlaying.durMs - posMs);
       int totalSec = remainMs / 1000;
-      int min = totalSec / 60;
-      int sec = totalSec % 60;
-      char remainText[16];
-      snprintf(remainText, sizeof(remainText), "-%d:%02d", min, sec);
-      std::string remainStr = remainText;
-      // int remainW = HAL::getFontWidth(remainStr);  // Currently unused
+      static char remainText[16] = "";
+      static int remainSec = -1;
+      if (totalSec != remainSec) {
+        remainSec = totalSec;
+        snprintf(remainText, sizeof(remainText), "-%d:%02d", totalSec / 60, totalSec % 60);
+      }
       int remainY = coverY + cover + HAL::getFontHeight();
       int maxY = barY - 2;
       if (remainY > maxY) remainY = maxY;
       if (remainY > coverY + HAL::getFontHeight()) {
-        HAL::drawEnglish(coverX, remainY, remainStr);
+        HAL::drawEnglish(coverX, remainY, remainText);
       }
     }
     if (barW <= 4) {
@@ -2266,6 +3682,32 @@ void scaleUi(float factor) {
   scale(cfg.checkBoxRadius);
 }
 
+void formatAdjustValue(char *out, size_t outSize, AdjustTarget target, int level) {
+  switch (target) {
+    case ADJ_VOLUME: snprintf(out, outSize, "%d%%", level); break;
+    case ADJ_SPI: snprintf(out, outSize, "%d MHz", level); break;
+    case ADJ_UI_SPEED: snprintf(out, outSize, "%dx", level); break;
+    case ADJ_SEL_SPEED:
+    case ADJ_WRAP_PAUSE:
+    case ADJ_SCROLL_TIME: snprintf(out, outSize, "%d ms", level); break;
+    case ADJ_FONT_COLOR: snprintf(out, outSize, "%d deg", level); break;
+    case ADJ_LYRIC_SCROLL_CPS: snprintf(out, outSize, "%d cps", level); break;
+    case ADJ_NP_CLOSE_SEC:
+    case ADJ_CFG_CLOSE:
+      if (level <= 0) {
+        snprintf(out, outSize, "0 ms");
+      } else if (level >= 60) {
+        snprintf(out, outSize, "NEVER");
+      } else {
+        uint8_t v = static_cast<uint8_t>(level);
+        snprintf(out, outSize, "%u ms",
+                 static_cast<unsigned>(target == ADJ_NP_CLOSE_SEC ? mapNpCloseMs(v) : mapCfgCloseMs(v)));
+      }
+      break;
+    default: out[0] = '\0'; break;
+  }
+}
+
 void renderAdjustScreen() {
   HAL::canvasClear();
   auto &sys = HAL::getSystemConfig();
@@ -2282,16 +3724,14 @@ void renderAdjustScreen() {
   float minValue = 0.0f;
   float maxValue = 1.0f;
 
-  std::string label;
-  std::string valueText;
-  std::string minText;
-  std::string maxText;
+  const char *label = "";
+  const char *minText = "";
+  const char *maxText = "";
   if (adjustTarget == ADJ_VOLUME) {
     targetValue = static_cast<float>(volumeValue);
     minValue = 0.0f;
     maxValue = 100.0f;
     label = "VOLUME";
-    valueText = std::to_string(static_cast<int>(std::round(targetValue))) + "%";
     minText = "0%";
     maxText = "100%";
   } else if (adjustTarget == ADJ_SPI) {
@@ -2299,7 +3739,6 @@ void renderAdjustScreen() {
     minValue = 1.0f;
     maxValue = 80.0f;
     label = "SPI MHz";
-    valueText = std::to_string(static_cast<int>(std::round(targetValue))) + " MHz";
     minText = "1 MHz";
     maxText = "80 MHz";
   } else if (adjustTarget == ADJ_UI_SPEED) {
@@ -2308,7 +3747,6 @@ void renderAdjustScreen() {
     minValue = mapUiSpeedScale(1);
     maxValue = mapUiSpeedScale(50);
     label = "UI SPEED";
-    valueText = std::to_string(static_cast<int>(std::round(mappedValue))) + "x";
     minText = "1x";
     maxText = "50x";
   } else if (adjustTarget == ADJ_SEL_SPEED) {
@@ -2317,7 +3755,6 @@ void renderAdjustScreen() {
     minValue = mapSelSpeedMs(1);
     maxValue = mapSelSpeedMs(50);
     label = "SEL SPEED";
-    valueText = std::to_string(static_cast<int>(std::round(mappedValue))) + " ms";
     minText = "900 ms";
     maxText = "20 ms";
   } else if (adjustTarget == ADJ_WRAP_PAUSE) {
@@ -2326,7 +3763,6 @@ void renderAdjustScreen() {
     minValue = mapWrapPauseMs(0);
     maxValue = mapWrapPauseMs(50);
     label = "WRAP PAUSE";
-    valueText = std::to_string(static_cast<int>(std::round(mappedValue))) + " ms";
     minText = "0 ms";
     maxText = "1000 ms";
   } else if (adjustTarget == ADJ_FONT_COLOR) {
@@ -2335,7 +3771,6 @@ void renderAdjustScreen() {
     minValue = mapHueDeg(0);
     maxValue = mapHueDeg(50);
     label = "FONT COLOR";
-    valueText = std::to_string(static_cast<int>(std::round(mappedValue))) + " deg";
     minText = "0 deg";
     maxText = "360 deg";
   } else if (adjustTarget == ADJ_SCROLL_TIME) {
@@ -2344,7 +3779,6 @@ void renderAdjustScreen() {
     minValue = mapScrollMs(1);
     maxValue = mapScrollMs(50);
     label = "SCROLL TIME";
-    valueText = std::to_string(static_cast<int>(std::round(mappedValue))) + " ms";
     minText = "100 ms";
     maxText = "15000 ms";
   } else if (adjustTarget == ADJ_LYRIC_SCROLL_CPS) {
@@ -2352,7 +3786,6 @@ void renderAdjustScreen() {
     minValue = 1.0f;
     maxValue = 30.0f;
     label = "LYRIC SPEED";
-    valueText = std::to_string(static_cast<int>(std::round(targetValue))) + " cps";
     minText = "1 cps";
     maxText = "30 cps";
   } else if (adjustTarget == ADJ_NP_CLOSE_SEC) {
@@ -2360,13 +3793,6 @@ void renderAdjustScreen() {
     minValue = 0.0f;
     maxValue = 60.0f;
     label = "MUSIC CLOSE";
-    if (npAutoCloseSecPending == 0) {
-      valueText = "0 ms";
-    } else if (npAutoCloseSecPending >= 60) {
-      valueText = "NEVER";
-    } else {
-      valueText = std::to_string(mapNpCloseMs(npAutoCloseSecPending)) + " ms";
-    }
     minText = "0 ms";
     maxText = "NEVER";
   } else if (adjustTarget == ADJ_CFG_CLOSE) {
@@ -2374,13 +3800,6 @@ void renderAdjustScreen() {
     minValue = 0.0f;
     maxValue = 60.0f;
     label = "AUTO CLOSE MSG";
-    if (cfgMsgAutoClosePending == 0) {
-      valueText = "0 ms";
-    } else if (cfgMsgAutoClosePending >= 60) {
-      valueText = "NEVER";
-    } else {
-      valueText = std::to_string(mapCfgCloseMs(cfgMsgAutoClosePending)) + " ms";
-    }
     minText = "0 ms";
     maxText = "NEVER";
   }
@@ -2400,40 +3819,15 @@ void renderAdjustScreen() {
   }
   if (progress < 0.0f) progress = 0.0f;
   if (progress > 1.0f) progress = 1.0f;
-  if (adjustTarget == ADJ_VOLUME) {
-    valueText = std::to_string(static_cast<int>(std::round(shownValue))) + "%";
-  } else if (adjustTarget == ADJ_SPI) {
-    valueText = std::to_string(static_cast<int>(std::round(shownValue))) + " MHz";
-  } else if (adjustTarget == ADJ_UI_SPEED) {
-    valueText = std::to_string(static_cast<int>(std::round(shownValue))) + "x";
-  } else if (adjustTarget == ADJ_SEL_SPEED) {
-    valueText = std::to_string(static_cast<int>(std::round(shownValue))) + " ms";
-  } else if (adjustTarget == ADJ_WRAP_PAUSE) {
-    valueText = std::to_string(static_cast<int>(std::round(shownValue))) + " ms";
-  } else if (adjustTarget == ADJ_FONT_COLOR) {
-    valueText = std::to_string(static_cast<int>(std::round(shownValue))) + " deg";
-  } else if (adjustTarget == ADJ_SCROLL_TIME) {
-    valueText = std::to_string(static_cast<int>(std::round(shownValue))) + " ms";
-  } else if (adjustTarget == ADJ_LYRIC_SCROLL_CPS) {
-    valueText = std::to_string(static_cast<int>(std::round(shownValue))) + " cps";
-  } else if (adjustTarget == ADJ_NP_CLOSE_SEC) {
-    int level = static_cast<int>(std::round(shownValue));
-    if (level <= 0) {
-      valueText = "0 ms";
-    } else if (level >= 60) {
-      valueText = "NEVER";
-    } else {
-      valueText = std::to_string(mapNpCloseMs(static_cast<uint8_t>(level))) + " ms";
-    }
-  } else if (adjustTarget == ADJ_CFG_CLOSE) {
-    int level = static_cast<int>(std::round(shownValue));
-    if (level <= 0) {
-      valueText = "0 ms";
-    } else if (level >= 60) {
-      valueText = "NEVER";
-    } else {
-      valueText = std::to_string(mapCfgCloseMs(static_cast<uint8_t>(level))) + " ms";
-    }
+  // Only re-format the value when its shown integer changes.
+  static char valueText[24] = "";
+  static AdjustTarget valueTarget = ADJ_NONE;
+  static int valueLevel = 0;
+  int level = static_cast<int>(std::round(shownValue));
+  if (adjustTarget != valueTarget || level != valueLevel) {
+    valueTarget = adjustTarget;
+    valueLevel = level;
+    formatAdjustValue(valueText, sizeof(valueText), adjustTarget, level);
   }
 
   float enterOffset = (1.0f - enterProgress) * 18.0f;
@@ -2457,7 +3851,7 @@ void renderAdjustScreen() {
 
   float startDeg = 225.0f;
   float endDeg = 225.0f + 270.0f;
-  auto drawTickLabel = [&](float deg, std::string text) {
+  auto drawTickLabel = [&](float deg, std::string_view text) {
     float rad = deg * 3.1415926f / 180.0f;
     float tx = cx + std::cos(rad) * (r + 4.0f);
     float ty = cy + std::sin(rad) * (r + 4.0f);
@@ -2466,8 +3860,8 @@ void renderAdjustScreen() {
   };
   drawTickLabel(startDeg, minText);
   drawTickLabel(endDeg, maxText);
-  std::string help1;
-  std::string help2;
+  const char *help1 = nullptr;
+  const char *help2 = nullptr;
   if (adjustTarget == ADJ_UI_SPEED) {
     help1 = "\u754c\u9762\u6574\u4f53\u52a8\u753b\u901f\u5ea6";
     help2 = "\u6570\u503c\u8d8a\u5927\u8d8a\u5feb";
@@ -2494,11 +3888,11 @@ void renderAdjustScreen() {
     help2 = "0ms=\u7acb\u5373  NEVER=\u4e0d\u81ea\u52a8\u5173\u95ed";
   }
 
-  if (!help1.empty()) {
+  if (help1) {
     int fontH = HAL::getFontHeight();
     int baseY = static_cast<int>(cy);
     HAL::drawChinese(6, baseY + enterOffset, help1);
-    if (!help2.empty()) {
+    if (help2) {
       HAL::drawChinese(6, baseY + fontH + 2 + enterOffset, help2);
     }
   }
@@ -2544,46 +3938,35 @@ void renderLinkIndicator(uint32_t nowMs) {
   HAL::drawBox(x, y, 3, 3);
 }
 
-void renderPopupBackground() {
-  if (nowPlaying.active) {
-    renderNowPlayingOverlay();
-  } else {
-    hal.clearImageOverlay();
-    hal.clearBarOverlay();
-  }
-}
-
 void renderStatusBar(uint32_t nowMs, int fpsValue, int cpuValue) {
-  std::string text;
   bool usbReady = isUsbLinkReady();
   bool bleClientReady = isBleClientLinkReady();
   bool bleBasicReady = isBleBasicLinkReady();
   bool linkReady = usbReady || bleClientReady;
 
-  if (usbReady && bleClientReady) text = "U+BC";
-  else if (usbReady && bleBasicReady) text = "U+BB";
-  else if (usbReady) text = "USB";
-  else if (bleClientReady) text = "BLEC";
-  else if (bleBasicReady) text = "BLEB";
-  else text = "OFF";
-
-  std::string perf;
-  if (showFps) perf += "F:" + std::to_string(fpsValue);
-  if (showCpu) {
-    if (!perf.empty()) perf += " ";
-    perf += "C:" + std::to_string(cpuValue);
-  }
-  if (showUp) {
-    if (!perf.empty()) perf += " ";
-    perf += "U:" + std::to_string(upBps / 1024) + "K";
-  }
-  if (showDown) {
-    if (!perf.empty()) perf += " ";
-    perf += "D:" + std::to_string(downBps / 1024) + "K";
-  }
-  if (!perf.empty()) {
-    text += "  ";
-    text += perf;
+  int link = 5;
+  if (usbReady && bleClientReady) link = 0;
+  else if (usbReady && bleBasicReady) link = 1;
+  else if (usbReady) link = 2;
+  else if (bleClientReady) link = 3;
+  else if (bleBasicReady) link = 4;
+
+  // Re-format only when a shown value changed; hidden fields read as -1.
+  static char text[64] = "";
+  static int lastKey[6] = {-1, -1, -1, -1, -1, -1};
+  const int key[6] = {link, showFps ? fpsValue : -1, showCpu ? cpuValue : -1, showUp ? upBps / 1024 : -1,
+                      showDown ? downBps / 1024 : -1, showAlloc ? static_cast<int>(allocPerFrame) : -1};
+  if (!std::equal(key, key + 6, lastKey)) {
+    std::copy(key, key + 6, lastKey);
+    static const char *const LINK_LABELS[] = {"U+BC", "U+BB", "USB", "BLEC", "BLEB", "OFF"};
+    static const char *const PERF_FORMATS[] = {"%sF:%d", "%sC:%d", "%sU:%dK", "%sD:%dK", "%sA:%d"};
+    size_t len = snprintf(text, sizeof(text), "%s", LINK_LABELS[link]);
+    const char *sep = "  ";
+    for (int i = 1; i < 6 && len < sizeof(text); ++i) {
+      if (key[i] < 0) continue;
+      len += snprintf(text + len, sizeof(text) - len, PERF_FORMATS[i - 1], sep, key[i]);
+      sep = " ";
+    }
   }
 
   bool blink = (!linkReady) && (((nowMs / 700) % 2) != 0);
@@ -2678,7 +4061,7 @@ void renderAboutInfo() {
   int footerHeight = lineHeight + 4;
   int viewHeight = h - footerHeight;
 
-  auto drawLine = [&](const std::string &text, int extraGap = 0) {
+  auto drawLine = [&](std::string_view text, int extraGap = 0) {
     if (y >= -lineHeight && y < h) {
       HAL::drawEnglish(contentX, y, text);
     }
@@ -2765,6 +4148,13 @@ void renderAboutInfo() {
   uint32_t psramFree = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
   snprintf(buf, sizeof(buf), "PSRAM: %u KB", static_cast<unsigned>(psramFree / 1024));
   drawLine(buf);
+  CoverCacheStats coverStats = cover_cache_stats();
+  snprintf(buf, sizeof(buf), "Covers: %d RAM %d/%d Flash", coverStats.ramEntries, coverStats.flashEntries,
+           coverStats.flashSlots);
+  drawLine(buf);
+  snprintf(buf, sizeof(buf), "Cover Hit: %u/%u", static_cast<unsigned>(coverStats.hits),
+           static_cast<unsigned>(coverStats.hits + coverStats.misses));
+  drawLine(buf);
   const char *modeName = commModeLabel(commMode);
   snprintf(buf, sizeof(buf), "Prefer: %s", modeName);
   drawLine(buf);
@@ -2778,6 +4168,25 @@ void renderAboutInfo() {
   drawLine(buf);
   snprintf(buf, sizeof(buf), "USB Link: %s", usbReady ? "OK" : "None");
   drawLine(buf, 2);
+
+  // Link round trips (PING/PONG, ms)
+  drawLine("Link RTT:");
+  for (int t = 0; t < LINK_TRANSPORTS; ++t) {
+    char stats[64];
+    formatRtt(stats, sizeof(stats), linkRtt[t]);
+    snprintf(buf, sizeof(buf), "%s %s", t == LINK_USB ? "USB" : "BLE", stats);
+    drawLine(buf);
+  }
+  if (linkPeerRtt[0] != '\0') {
+    snprintf(buf, sizeof(buf), "PC %s", linkPeerRtt);
+    drawLine(buf);
+  }
+  if (linkProbeIntervalMs > 0) {
+    snprintf(buf, sizeof(buf), "Probe: %u ms", static_cast<unsigned>(linkProbeIntervalMs));
+  } else {
+    snprintf(buf, sizeof(buf), "Probe: Off");
+  }
+  drawLine(buf, 2);
   
   // Divider line
   if (y >= 0 && y < h) {
@@ -2864,6 +4273,8 @@ extern "C" void app_main(void) {
   }
 
   loadSettings();
+  cover_cache_init(sizeof(nowPlaying.coverFront));
+  nowPlaying.shapeDirty = true;  // "Unknown" until the first NP META names the track
   cfgMsgAutoCloseValue = mapCfgCloseFromMs(cfgMsgAutoCloseMs);
   cfgMsgAutoClosePending = cfgMsgAutoCloseValue;
   applySelectorSpeed();
@@ -2919,7 +4330,6 @@ extern "C" void app_main(void) {
   scaleUi(2.0f);
   buildMenus();
   launcher.init(menuMain);
-  launcher.setPopRenderHook(renderPopupBackground);
 
   sendVolumeGet();
 
@@ -2933,6 +4343,10 @@ extern "C" void app_main(void) {
   uint64_t lastLoopUs = 0;
   uint32_t lastBtUiUpdateMs = 0;
   uint32_t lastLockUiUpdateMs = 0;
+  uint32_t lastFrameMs = 0;
+  uint32_t framedLineCount = 0;
+  uint32_t frameAllocMax = 0;
+  allocCountTask = xTaskGetCurrentTaskHandle();
 
   while (true) {
     uint64_t loopStartUs = esp_timer_get_time();
@@ -2941,8 +4355,22 @@ extern "C" void app_main(void) {
     lastLoopUs = loopStartUs;
 
     HAL::keyScan();
+    bool keyInput = *HAL::getKeyFlag() == key::KEY_PRESSED;
+    launcher.popKeys();
     handleKeyEvents();
     readSerial();
+    pumpCoverLines();
+    sendCoverAck();
+    finishCover();
+    pumpBulkLine();
+    pumpVolumeSync(static_cast<uint32_t>(esp_timer_get_time() / 1000ULL));
+    // Flash persistence blocks the loop for an erase; only run it while
+    // nothing on screen moves (the same test that skips frames below).
+    if (launcher.isIdle() && !nowPlaying.active && !nowPlaying.coverReceiving && !currentLyric.active && !keyInput) {
+      cover_cache_service();
+    }
+    updateLyricSchedule();
+    shapePendingText();
 
     uint32_t nowMs = static_cast<uint32_t>(esp_timer_get_time() / 1000ULL);
     if (nowMs - lastLockUiUpdateMs >= 120) {
@@ -2970,19 +4398,23 @@ extern "C" void app_main(void) {
     uint16_t npCloseMs = mapNpCloseMs(npAutoCloseSecValue);
     if (npCloseMs < 65535) {
       uint32_t npTimeoutMs = static_cast<uint32_t>(npCloseMs);
+      uint32_t npSilenceMs = playbackClock.explicitState ? std::max(npTimeoutMs, CLOCK_HEARTBEAT_GRACE_MS) : npTimeoutMs;
       if (nowPlaying.active && nowPlaying.lastUpdateMs > 0 &&
-          (nowMs - nowPlaying.lastUpdateMs > npTimeoutMs)) {
+          (nowMs - nowPlaying.lastUpdateMs > npSilenceMs)) {
         clearNowPlayingState(true);
       }
       if (!nowPlaying.active && currentLyric.active && lyricLastUpdateMs > 0 &&
           (nowMs - lyricLastUpdateMs > npTimeoutMs)) {
         currentLyric.active = false;
         nextLyric.active = false;
+        lyricLayout.dirty = true;
         lyricScrollOffset = 0;
         lyricLastUpdateMs = 0;
       }
     }
 
+    bool framed = true;
+    uint32_t frameAllocStart = allocCount;
     if (adjustActive) {
     hal.clearImageOverlay();
     hal.clearBarOverlay();
@@ -2990,12 +4422,39 @@ extern "C" void app_main(void) {
       renderTestPattern();
     } else if (appMode == MODE_ABOUT_INFO) {
       renderAboutInfo();
+    } else if (appMode == MODE_LYRICS_FULL) {
+      renderLyricsFull();
     } else {
       renderAdjustScreen();
     }
     renderStatusBar(nowMs, fpsValue, cpuValue);
-    HAL::canvasUpdate();
+    launcher.renderPopup();
+    // canvasScroll() refuses on landscape panels, so on the shipped board
+    // (TFT_SWAP_XY) the lyric view is always flushed in full.
+    bool lyricScrollOnly = appMode == MODE_LYRICS_FULL && lyricLayout.scrollOnly && !launcher.isPopShown();
+    if (!(lyricScrollOnly &&
+          hal.canvasScroll(0, HAL::getSystemConfig().screenHeight, lyricLayout.scrollDelta))) {
+      HAL::canvasUpdate();
+    }
+    lyricLayout.frameValid = appMode == MODE_LYRICS_FULL && !launcher.isPopShown();
+  } else if (launcher.isIdle() && !nowPlaying.active && !currentLyric.active && !keyInput &&
+             rxLineCount == framedLineCount && nowMs - lastFrameMs < IDLE_FRAME_MS) {
+      framed = false;  // same picture as the last flush
+  } else if (modalDraw.backdropValid && launcher.isPopShown() && !nowPlaying.active && !currentLyric.active &&
+             !keyInput && rxLineCount == modalDraw.backdropLineCount &&
+             nowMs - modalDraw.backdropMs < BACKDROP_REFRESH_MS) {
+      uint64_t drawStartUs = esp_timer_get_time();
+      Animation::tick();
+      HAL::canvasRestore();
+      renderStatusBar(nowMs, fpsValue, cpuValue);
+      launcher.renderPopup();
+      HAL::canvasUpdateRegion(launcher.getPopBandY(), launcher.getPopBandH());
+      modalDraw.backdropFrames++;
+      modalDraw.backdropUs += esp_timer_get_time() - drawStartUs;
+      modalDraw.backdropBytes += hal.takeFlushedBytes();
   } else {
+      uint64_t drawStartUs = esp_timer_get_time();
+      hal.takeFlushedBytes();  // count this frame only
       hal.clearArcOverlay();
       launcher.update();
       if (nowPlaying.active) {
@@ -3006,16 +4465,94 @@ extern "C" void app_main(void) {
         renderLyrics(); // Display lyrics
       }
       renderStatusBar(nowMs, fpsValue, cpuValue);
+      modalDraw.backdropValid = false;
+      if (launcher.isPopShown() && launcher.isPageStill() && !nowPlaying.active && !currentLyric.active &&
+          HAL::canvasSnapshot()) {
+        modalDraw.backdropValid = true;
+        modalDraw.backdropMs = nowMs;
+        modalDraw.backdropLineCount = rxLineCount;
+      }
+      launcher.renderPopup();
       HAL::canvasUpdate();
+      if (launcher.isPopShown()) {
+        modalDraw.fullFrames++;
+        modalDraw.fullUs += esp_timer_get_time() - drawStartUs;
+        modalDraw.fullBytes += hal.takeFlushedBytes();
+      }
+    }
+    if (!launcher.isPopShown()) modalDraw.backdropValid = false;
+    if (framed) {
+      lastFrameMs = nowMs;
+      framedLineCount = rxLineCount;
+      frameCount++;
+      frameAllocMax = std::max(frameAllocMax, allocCount - frameAllocStart);
     }
-
-    frameCount++;
     uint64_t loopEndUs = esp_timer_get_time();
     busyUsAccum += (loopEndUs - loopStartUs);
 
     if (liveHeartbeat && (nowMs - lastLiveMs >= 1000)) {
       lastLiveMs = nowMs;
       sendLine("APP LIVE");
+      if (linkLatency.dirty) {
+        linkLatency.dirty = false;
+        char msg[96];
+        snprintf(msg, sizeof(msg), "APP LINK vol_rtt_ms=%u worst=%u cover_worst=%u n=%u drop=%u",
+                 static_cast<unsigned>(linkLatency.lastRttUs / 1000),
+                 static_cast<unsigned>(linkLatency.worstRttUs / 1000),
+                 static_cast<unsigned>(linkLatency.worstCoverRttUs / 1000),
+                 static_cast<unsigned>(linkLatency.samples),
+                 static_cast<unsigned>(linkBulkDropped));
+        sendBulkLine(msg);
+      }
+      if (volumeSync.dirtyReport) {
+        volumeSync.dirtyReport = false;
+        char msg[96];
+        snprintf(msg, sizeof(msg), "APP VOL detents=%u msgs=%u lat_avg_ms=%u lat_max_ms=%u stale=%u",
+                 static_cast<unsigned>(volumeSync.lastDetents), static_cast<unsigned>(volumeSync.lastMessages),
+                 static_cast<unsigned>(volumeSync.lastLatAvgMs), static_cast<unsigned>(volumeSync.lastLatMaxMs),
+                 static_cast<unsigned>(volumeSync.stale));
+        sendBulkLine(msg);
+      }
+      if (modalDraw.fullFrames + modalDraw.backdropFrames > 0) {
+        char msg[128];
+        uint32_t nf = modalDraw.fullFrames;
+        uint32_t nb = modalDraw.backdropFrames;
+        snprintf(msg, sizeof(msg), "APP MODAL full=%u us=%u kb=%u backdrop=%u us=%u kb=%u",
+                 static_cast<unsigned>(nf), static_cast<unsigned>(nf ? modalDraw.fullUs / nf : 0),
+                 static_cast<unsigned>(nf ? modalDraw.fullBytes / nf / 1024 : 0), static_cast<unsigned>(nb),
+                 static_cast<unsigned>(nb ? modalDraw.backdropUs / nb : 0),
+                 static_cast<unsigned>(nb ? modalDraw.backdropBytes / nb / 1024 : 0));
+        sendBulkLine(msg);
+        modalDraw.fullFrames = 0;
+        modalDraw.fullUs = 0;
+        modalDraw.fullBytes = 0;
+        modalDraw.backdropFrames = 0;
+        modalDraw.backdropUs = 0;
+        modalDraw.backdropBytes = 0;
+      }
+      if (linkClock.dirty) {
+        linkClock.dirty = false;
+        char msg[128];
+        uint32_t n = linkClock.progStamped;
+        snprintf(msg, sizeof(msg), "APP TIME ofs=%lu rtt_ms=%u err_ms=%u syncs=%u prog_age_avg_ms=%u max=%u n=%u",
+                 static_cast<unsigned long>(linkClock.offsetMs), static_cast<unsigned>(linkClock.rttMs),
+                 static_cast<unsigned>(linkClock.rttMs / 2), static_cast<unsigned>(linkClock.syncs),
+                 static_cast<unsigned>(n ? linkClock.progAgeSumMs / n : 0),
+                 static_cast<unsigned>(linkClock.progAgeMaxMs), static_cast<unsigned>(n));
+        sendBulkLine(msg);
+      }
+    }
+    if (stateSync.pending && nowMs - stateSync.requestMs >= STATE_REPLY_TIMEOUT_MS) {
+      stateSync.pending = false;
+      sendVolumeGet();  // bridge predates STATE; lists stay lazy as before
+    }
+    if (handshakeOk && linkProbeIntervalMs > 0 && nowMs - linkProbeLastMs >= linkProbeIntervalMs) {
+      linkProbeLastMs = nowMs;
+      sendLinkProbe(nowMs);
+    }
+    if (appMode == MODE_ABOUT_INFO && handshakeOk && nowMs - linkPeerQueryMs >= LINK_PEER_QUERY_MS) {
+      linkPeerQueryMs = nowMs;
+      sendBulkLine("DIAG RTT");  // refresh the bridge-side row while the page is open
     }
     if (lastPerfMs == 0) lastPerfMs = nowMs;
     if (nowMs - lastPerfMs >= 1000) {
@@ -3034,6 +4571,8 @@ extern "C" void app_main(void) {
       txBytes = 0;
       rxBytes = 0;
       frameCount = 0;
+      allocPerFrame = frameAllocMax;
+      frameAllocMax = 0;
       busyUsAccum = 0;
       totalUsAccum = 0;
       lastPerfMs = nowMs;
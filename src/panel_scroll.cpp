@@ -0,0 +1,82 @@
+#include "panel_scroll.h"
+
+#include <algorithm>
+
+namespace {
+
+int axisGap(const PanelGeometry &geo) { return geo.swapXY ? geo.gapX : geo.gapY; }
+
+// Logical coordinate along the scroll axis <-> gate line.
+int gateOf(const PanelGeometry &geo, int pos) {
+  const int q = pos + axisGap(geo);
+  return geo.mirrorY ? geo.nativeRows - 1 - q : q;
+}
+
+int posOf(const PanelGeometry &geo, int gate) {
+  const int q = geo.mirrorY ? geo.nativeRows - 1 - gate : gate;
+  return q - axisGap(geo);
+}
+
+// GRAM row shown on a gate line, per VSCRDEF/VSCSAD.
+int shownRow(uint16_t tfa, uint16_t vsa, uint16_t vsp, int gate) {
+  if (gate < tfa || gate >= tfa + vsa) return gate;
+  return tfa + (gate - tfa + vsp - tfa) % vsa;
+}
+
+void put16(uint8_t *out, uint16_t v) {
+  out[0] = static_cast<uint8_t>(v >> 8);
+  out[1] = static_cast<uint8_t>(v & 0xFF);
+}
+
+}  // namespace
+
+void panel_scroll_init(PanelScroll *s, const PanelGeometry &geo) {
+  s->geo = geo;
+  const int a = posOf(geo, 0);
+  const int b = posOf(geo, geo.nativeRows - 1);
+  panel_scroll_set_area(s, std::min(a, b), std::max(a, b) + 1);
+}
+
+bool panel_scroll_set_area(PanelScroll *s, int lo, int hi) {
+  if (hi <= lo) return false;
+  const int g0 = gateOf(s->geo, lo);
+  const int g1 = gateOf(s->geo, hi - 1);
+  const int top = std::min(g0, g1);
+  const int bottom = std::max(g0, g1);
+  if (top < 0 || bottom >= s->geo.nativeRows) return false;
+  s->areaLo = lo;
+  s->areaHi = hi;
+  s->tfa = static_cast<uint16_t>(top);
+  s->vsa = static_cast<uint16_t>(bottom - top + 1);
+  s->bfa = static_cast<uint16_t>(s->geo.nativeRows - bottom - 1);
+  s->vsp = s->tfa;
+  return true;
+}
+
+void panel_scroll_by(PanelScroll *s, int delta, int *exposedLo, int *exposedHi) {
+  const int len = s->vsa;
+  // A mirrored axis runs against the gate order.
+  const int step = (s->geo.mirrorY ? -delta : delta) % len;
+  const int offset = ((s->vsp - s->tfa + step) % len + len) % len;
+  s->vsp = static_cast<uint16_t>(s->tfa + offset);
+  const int n = std::min(delta < 0 ? -delta : delta, len);
+  if (delta > 0) {
+    *exposedLo = s->areaHi - n;
+    *exposedHi = s->areaHi;
+  } else {
+    *exposedLo = s->areaLo;
+    *exposedHi = s->areaLo + n;
+  }
+}
+
+int panel_scroll_address(const PanelScroll *s, int pos) {
+  return posOf(s->geo, shownRow(s->tfa, s->vsa, s->vsp, gateOf(s->geo, pos)));
+}
+
+void panel_scroll_area_params(const PanelScroll *s, uint8_t out[6]) {
+  put16(out, s->tfa);
+  put16(out + 2, s->vsa);
+  put16(out + 4, s->bfa);
+}
+
+void panel_scroll_start_params(const PanelScroll *s, uint8_t out[2]) { put16(out, s->vsp); }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+
+// ST7789 hardware scrolling, tracked in the logical coordinates that
+// esp_lcd_panel_draw_bitmap() takes.
+//
+// The controller scrolls along its gate lines (GRAM rows, 320 on a 240x320
+// part): VSCRDEF splits them into a top fixed area, a scroll area and a
+// bottom fixed area, and VSCSAD picks the GRAM row shown on the first line of
+// the scroll area. MADCTL only changes how host addresses land in GRAM, so
+// which logical axis scrolls, and in which direction, follows from the
+// orientation set up in init_display():
+//   column = swapXY ? y : x, row = swapXY ? x : y  (after adding the gap)
+//   mirrorX flips the GRAM column, mirrorY flips the GRAM row.
+// With swapXY the scroll axis is the logical x axis. The HAL only scrolls
+// along y, so landscape builds (TFT_SWAP_XY, the shipped board) never scroll.
+constexpr uint8_t PANEL_CMD_VSCRDEF = 0x33;
+constexpr uint8_t PANEL_CMD_VSCSAD = 0x37;
+
+struct PanelGeometry {
+  int nativeCols;  // GRAM columns (source lines)
+  int nativeRows;  // GRAM rows (gate lines), the scroll direction
+  int gapX;
+  int gapY;
+  bool swapXY;
+  bool mirrorX;
+  bool mirrorY;
+};
+
+// Scroll state in gate lines. lo/hi arguments and results are logical
+// coordinates along the scroll axis, hi exclusive.
+struct PanelScroll {
+  PanelGeometry geo;
+  int areaLo;  // logical extent of the scroll area
+  int areaHi;
+  uint16_t tfa;
+  uint16_t vsa;
+  uint16_t bfa;
+  uint16_t vsp;  // VSCSAD, tfa while unscrolled
+};
+
+// Whole panel as one scroll area, unscrolled.
+void panel_scroll_init(PanelScroll *s, const PanelGeometry &geo);
+
+inline bool panel_scroll_axis_is_y(const PanelScroll *s) { return !s->geo.swapXY; }
+
+// Moves the scroll area to [lo, hi) and back to its origin. Content already in
+// GRAM no longer lines up afterwards, so the caller rewrites the frame.
+bool panel_scroll_set_area(PanelScroll *s, int lo, int hi);
+
+inline bool panel_scroll_shifted(const PanelScroll *s) { return s->vsp != s->tfa; }
+
+// Back to the origin of the current area, for a caller about to rewrite the
+// whole frame anyway.
+inline void panel_scroll_rewind(PanelScroll *s) { s->vsp = s->tfa; }
+
+// Content moves towards lower logical coordinates by delta (negative moves it
+// up the axis). Returns the logical lines that now show stale GRAM and must be
+// written.
+void panel_scroll_by(PanelScroll *s, int delta, int *exposedLo, int *exposedHi);
+
+// Logical address to write so the pixels show up at pos on the glass.
+int panel_scroll_address(const PanelScroll *s, int pos);
+
+// VSCRDEF (TFA, VSA, BFA) and VSCSAD parameters, big-endian.
+void panel_scroll_area_params(const PanelScroll *s, uint8_t out[6]);
+void panel_scroll_start_params(const PanelScroll *s, uint8_t out[2]);
@@ -0,0 +1,26 @@
+// Replaces the global allocator so tests can assert that a code path does not
+// touch the heap.
+#include <cstdlib>
+#include <new>
+
+#include "test_support.h"
+
+int testFailures = 0;
+size_t testAllocs = 0;
+bool testCountAllocs = false;
+
+namespace {
+void *countedAlloc(size_t size) {
+  if (testCountAllocs) testAllocs++;
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+}  // namespace
+
+void *operator new(size_t size) { return countedAlloc(size); }
+void *operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
@@ -0,0 +1,93 @@
+// Steady-state UI frames must not touch the heap: a menu tree shaped like
+// the firmware's (slider, checkbox, popup, a long device list) is driven for
+// 1000 frames of navigation, page changes and popups under a counting
+// operator new, after one warm-up pass over the same sequence.
+#include <chrono>
+#include <string>
+
+#include "astra/ui/launcher.h"
+#include "astra/ui/item/widget/widget.h"
+#include "test_support.h"
+
+using namespace astra;
+
+namespace {
+
+constexpr int FRAMES = 1000;
+constexpr uint32_t FRAME_MS = 16;
+
+StubHal hal;
+bool mute = false;
+unsigned char volume = 40;
+unsigned char mode = 1;
+
+// One scripted frame: a key action every few frames, then the regular update.
+void frame(Launcher &launcher, Menu *deviceList, int f) {
+  hal.nowMs += FRAME_MS;
+  switch (f % 200) {
+    case 10:
+    case 20:
+    case 30:  // Main -> Output Device
+    case 60:
+    case 70:  // down the device rows
+    case 110:
+      launcher.getSelector()->goNext();
+      break;
+    case 40:
+      if (launcher.getCurrentMenu()->childMenu[launcher.getCurrentMenu()->selectIndex] == deviceList) {
+        launcher.open();
+      }
+      break;
+    case 90:
+      if (launcher.getCurrentMenu() == deviceList) launcher.close();  // back on Main, first row
+      break;
+    case 130:
+      launcher.getSelector()->goPreview();
+      break;
+    case 170:
+      launcher.popInfo("Saved", 300);
+      break;
+    default:
+      break;
+  }
+  launcher.popKeys();
+  launcher.update();
+  launcher.renderPopup();
+}
+
+}  // namespace
+
+int main() {
+  HAL::inject(&hal);
+  auto *root = new List("Main");
+  auto *deviceList = new List("Output Device");
+  root->addItem(new List("Volume"), new Slider("Volume", 0, 100, 2, volume));
+  root->addItem(new List("Mute"), new CheckBox(mute));
+  root->addItem(new List("Mode"), new PopUp(1, "Mode", {"Off", "On", "Auto"}, mode));
+  root->addItem(deviceList);
+  root->addItem(new List("Settings"));
+  deviceList->addItem(new List("Refresh List"));
+  for (int i = 0; i < 20; ++i) {
+    deviceList->addItem(new List("Speakers (Realtek High Definition Audio) " + std::to_string(i)));
+  }
+
+  Launcher launcher;
+  launcher.init(root);
+  for (int f = 0; f < FRAMES; ++f) frame(launcher, deviceList, f);  // warm-up
+
+  bool opened = false;
+  testAllocs = 0;
+  testCountAllocs = true;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int f = 0; f < FRAMES; ++f) {
+    frame(launcher, deviceList, f);
+    opened = opened || launcher.getCurrentMenu() == deviceList;
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  testCountAllocs = false;
+
+  printf("%d frames: %zu heap allocations, %.2f us/frame\n", FRAMES, testAllocs, us / FRAMES);
+  CHECK(opened);
+  CHECK(testAllocs == 0);
+  return testResult("astra_alloc_test");
+}
@@ -0,0 +1,310 @@
+// Loopback test for the windowed cover transfer: a port of the PC sender
+// (pc/SongLedPc/CoverTransfer.cs: window 8, cumulative + selective acks,
+// RTT-gated retransmit, ack timeout) talks to the device-side cover_xfer_* code over
+// a simulated link that drops, delays, reorders and corrupts lines.
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "cover_transfer.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                     \
+    }                                                                 \
+  } while (0)
+
+uint32_t rngState = 1;
+uint32_t rnd() {
+  rngState = rngState * 1664525u + 1013904223u;
+  return rngState >> 8;
+}
+bool chance(int percent) { return static_cast<int>(rnd() % 100) < percent; }
+
+std::string chunkLine(int xfer, int idx, const std::vector<uint8_t> &payload, int chunkBytes) {
+  int start = idx * chunkBytes;
+  int count = std::min(chunkBytes, static_cast<int>(payload.size()) - start);
+  char head[32];
+  snprintf(head, sizeof(head), "%d %d %04X ", xfer, idx,
+           cover_crc16(payload.data() + start, static_cast<size_t>(count), 0xFFFF));
+  std::string line = head;
+  for (int i = 0; i < count; ++i) {
+    char hex[3];
+    snprintf(hex, sizeof(hex), "%02X", payload[start + i]);
+    line += hex;
+  }
+  return line;
+}
+
+struct InFlight {
+  int arriveMs;
+  std::string text;
+};
+
+struct Link {
+  int lossPercent;     // per line, both directions
+  int corruptPercent;  // PC -> device only
+  int maxDelayMs;      // uniform extra delay; > 0 reorders
+};
+
+struct LoopResult {
+  bool delivered;
+  int resent;
+  int elapsedMs;
+  uint32_t crcErrors;
+};
+
+constexpr int WINDOW = 8;
+constexpr int ACK_TIMEOUT_MS = 600;
+constexpr int MIN_ACK_TIMEOUT_MS = 50;
+constexpr int INITIAL_RTT_MS = 300;
+constexpr int MIN_RTT_MS = 10;
+constexpr int MAX_TIMEOUTS = 8;
+constexpr int BASE_DELAY_MS = 2;
+
+LoopResult runLoopback(const Link &link, CoverFormat format, const std::vector<uint8_t> &payload, int chunkBytes,
+                       uint16_t *out, int pixels) {
+  static uint8_t wire[COVER_XFER_WIRE_MAX];
+  memset(wire, 0, sizeof(wire));
+  const int xfer = 7;
+  CoverTransfer dev = {};
+  LoopResult result = {};
+  if (!cover_xfer_begin(&dev, xfer, format, chunkBytes, static_cast<int>(payload.size()), wire, out, pixels,
+                        false)) {
+    return result;
+  }
+
+  const int chunks = (static_cast<int>(payload.size()) + chunkBytes - 1) / chunkBytes;
+  std::vector<bool> acked(chunks, false);
+  std::vector<int> sentAt(chunks, 0);
+  std::vector<int> sendCount(chunks, 0);
+  std::deque<InFlight> toDevice;
+  std::deque<InFlight> toPc;
+  int now = 0;
+  int baseIdx = 0;
+  int next = 0;
+  int timeouts = 0;
+  int ackCum = 0;
+  uint32_t ackSack = 0;
+  double srtt = 0;
+
+  auto rttMs = [&]() { return srtt > 0 ? std::max(static_cast<int>(srtt), MIN_RTT_MS) : INITIAL_RTT_MS; };
+  auto ackWaitMs = [&]() {
+    return std::min(ACK_TIMEOUT_MS, std::max(MIN_ACK_TIMEOUT_MS, rttMs() * 4) << std::min(timeouts, 4));
+  };
+
+  auto send = [&](int idx) {
+    sentAt[idx] = now;
+    sendCount[idx]++;
+    if (chance(link.lossPercent)) return;
+    std::string text = chunkLine(xfer, idx, payload, chunkBytes);
+    if (chance(link.corruptPercent)) text[text.size() - 1] = text[text.size() - 1] == '0' ? '1' : '0';
+    int arrive = now + BASE_DELAY_MS + (link.maxDelayMs > 0 ? static_cast<int>(rnd() % link.maxDelayMs) : 0);
+    auto it = toDevice.begin();
+    while (it != toDevice.end() && it->arriveMs <= arrive) ++it;
+    toDevice.insert(it, {arrive, text});
+  };
+
+  // One device main-loop pass: consume arrived lines, then at most one ack.
+  auto deviceTick = [&]() {
+    while (!toDevice.empty() && toDevice.front().arriveMs <= now) {
+      cover_xfer_chunk(&dev, toDevice.front().text.c_str());
+      toDevice.pop_front();
+    }
+    char ack[48];
+    if (cover_xfer_ack_line(&dev, ack, sizeof(ack)) && !chance(link.lossPercent)) {
+      toPc.push_back({now + BASE_DELAY_MS, ack});
+    }
+  };
+
+  while (baseIdx < chunks) {
+    while (next < chunks && next < baseIdx + WINDOW) send(next++);
+
+    bool gotAck = false;
+    const int waitMs = ackWaitMs();
+    for (int waited = 0; waited < waitMs && !gotAck; ++waited) {
+      ++now;
+      deviceTick();
+      while (!toPc.empty() && toPc.front().arriveMs <= now) {
+        unsigned id = 0;
+        int cum = 0;
+        unsigned sack = 0;
+        if (sscanf(toPc.front().text.c_str(), "COV ACK %u %d %x", &id, &cum, &sack) == 3 &&
+            static_cast<int>(id) == xfer) {
+          ackCum = cum;
+          ackSack = sack;
+          gotAck = true;
+        }
+        toPc.pop_front();
+      }
+    }
+
+    if (!gotAck) {
+      if (++timeouts > MAX_TIMEOUTS) break;
+      for (int i = baseIdx; i < next; ++i) {
+        if (acked[i]) continue;
+        send(i);
+        result.resent++;
+      }
+      continue;
+    }
+
+    timeouts = 0;
+    int sample = -1;
+    auto ack = [&](int idx) {
+      if (acked[idx]) return;
+      acked[idx] = true;
+      if (sendCount[idx] == 1) sample = now - sentAt[idx];
+    };
+    int cum = std::max(0, std::min(ackCum, chunks));
+    for (int i = baseIdx; i < cum; ++i) ack(i);
+    int highest = cum - 1;
+    for (int b = 0; b < 32; ++b) {
+      int idx = cum + 1 + b;
+      if (idx >= chunks) break;
+      if (ackSack & (1u << b)) {
+        ack(idx);
+        highest = idx;
+      }
+    }
+    baseIdx = std::max(baseIdx, cum);
+    if (sample < 0 && srtt == 0) sample = now;  // BEGIN was queued at t=0
+    if (sample >= 0) srtt = srtt > 0 ? srtt * 0.875 + sample * 0.125 : std::max(sample, 1);
+    for (int i = baseIdx; i < highest; ++i) {
+      if (acked[i]) continue;
+      if (sendCount[i] == 1 || now - sentAt[i] >= rttMs()) {
+        send(i);
+        result.resent++;
+      }
+    }
+  }
+
+  result.delivered = baseIdx >= chunks && dev.cumulative == dev.chunkCount;
+  result.elapsedMs = now;
+  result.crcErrors = dev.crcErrors;
+  return result;
+}
+
+void testSackBitmap() {
+  static uint8_t wire[COVER_XFER_WIRE_MAX];
+  static uint16_t out[64];
+  std::vector<uint8_t> payload(10 * 8);
+  for (size_t i = 0; i < payload.size(); ++i) payload[i] = static_cast<uint8_t>(i * 7);
+  CoverTransfer x = {};
+  CHECK(cover_xfer_begin(&x, 3, COVER_FMT_JPEG, 8, static_cast<int>(payload.size()), wire, out, 64, false));
+
+  char ack[48];
+  CHECK(cover_xfer_ack_line(&x, ack, sizeof(ack)));
+  CHECK(strcmp(ack, "COV ACK 3 0 00000000") == 0);
+  CHECK(!cover_xfer_ack_line(&x, ack, sizeof(ack)));
+
+  CHECK(cover_xfer_chunk(&x, chunkLine(3, 0, payload, 8).c_str()) == COVER_CHUNK_STORED);
+  CHECK(cover_xfer_chunk(&x, chunkLine(3, 2, payload, 8).c_str()) == COVER_CHUNK_STORED);
+  CHECK(cover_xfer_chunk(&x, chunkLine(3, 5, payload, 8).c_str()) == COVER_CHUNK_STORED);
+  CHECK(cover_xfer_chunk(&x, chunkLine(3, 5, payload, 8).c_str()) == COVER_CHUNK_DUP);
+  CHECK(cover_xfer_chunk(&x, chunkLine(4, 1, payload, 8).c_str()) == COVER_CHUNK_STALE);
+  CHECK(cover_xfer_chunk(&x, chunkLine(3, 10, payload, 8).c_str()) == COVER_CHUNK_STALE);
+  // Cumulative point is 1 (chunk 0); chunk 2 is bit 0, chunk 5 bit 3.
+  CHECK(x.cumulative == 1);
+  CHECK(cover_xfer_sack(&x) == 0x9u);
+  CHECK(cover_xfer_ack_line(&x, ack, sizeof(ack)));
+  CHECK(strcmp(ack, "COV ACK 3 1 00000009") == 0);
+
+  std::string bad = chunkLine(3, 1, payload, 8);
+  bad[bad.size() - 1] = bad[bad.size() - 1] == 'F' ? 'E' : 'F';
+  CHECK(cover_xfer_chunk(&x, bad.c_str()) == COVER_CHUNK_BAD);
+  std::string shortLine = chunkLine(3, 1, payload, 8);
+  shortLine.resize(shortLine.size() - 2);
+  CHECK(cover_xfer_chunk(&x, shortLine.c_str()) == COVER_CHUNK_BAD);
+  CHECK(x.crcErrors == 2);
+  CHECK(!x.seen[1]);
+
+  CHECK(cover_xfer_chunk(&x, chunkLine(3, 1, payload, 8).c_str()) == COVER_CHUNK_STORED);
+  CHECK(x.cumulative == 3);
+  CHECK(cover_xfer_sack(&x) == 0x2u);
+  for (int idx : {3, 4, 6, 7, 8}) cover_xfer_chunk(&x, chunkLine(3, idx, payload, 8).c_str());
+  CHECK(cover_xfer_chunk(&x, chunkLine(3, 9, payload, 8).c_str()) == COVER_CHUNK_COMPLETE);
+  CHECK(memcmp(wire, payload.data(), payload.size()) == 0);
+}
+
+void testBeginLimits() {
+  static uint8_t wire[COVER_XFER_WIRE_MAX];
+  static uint16_t out[16];
+  CoverTransfer x = {};
+  CHECK(!cover_xfer_begin(&x, 1, COVER_FMT_RAW565, COVER_XFER_CHUNK_MAX + 1, 100, wire, out, 16, false));
+  CHECK(!cover_xfer_begin(&x, 1, COVER_FMT_RAW565, 8, COVER_XFER_WIRE_MAX + 1, wire, out, 16, false));
+  CHECK(!cover_xfer_begin(&x, 1, COVER_FMT_RAW565, 8, 8 * COVER_XFER_MAX_CHUNKS + 1, wire, out, 16, false));
+  CHECK(!cover_xfer_begin(&x, 0, COVER_FMT_RAW565, 8, 32, wire, out, 16, false));
+  CHECK(x.id == 0);
+}
+
+// A RAW565 cover through lossy links: every run must land byte-exact in the
+// output buffer, and CRC-corrupted lines must be counted and recovered.
+void testLoopback() {
+  constexpr int W = 40;
+  constexpr int H = 40;
+  static uint16_t out[W * H];
+  std::vector<uint16_t> pixels(W * H);
+  std::vector<uint8_t> payload(W * H * 2);
+  for (int i = 0; i < W * H; ++i) {
+    pixels[i] = static_cast<uint16_t>(i * 2654435761u >> 16);
+    payload[i * 2] = static_cast<uint8_t>(pixels[i] >> 8);
+    payload[i * 2 + 1] = static_cast<uint8_t>(pixels[i] & 0xFF);
+  }
+
+  const Link links[] = {
+      {0, 0, 0},     // clean, in order
+      {10, 0, 0},    // loss only
+      {0, 0, 40},    // reordering only
+      {15, 5, 40},   // loss, corruption and reordering
+      {25, 5, 80},   // hostile
+  };
+  for (const Link &link : links) {
+    int worstMs = 0;
+    for (uint32_t seed = 1; seed <= 20; ++seed) {
+      rngState = seed;
+      memset(out, 0, sizeof(out));
+      LoopResult r = runLoopback(link, COVER_FMT_RAW565, payload, 80, out, W * H);
+      CHECK(r.delivered);
+      CHECK(memcmp(out, pixels.data(), sizeof(out)) == 0);
+      // The sender treats a hole under a SACK as lost at once (the real link is
+      // in order), so only a lossless in-order link must need no resends.
+      if (link.lossPercent == 0 && link.corruptPercent == 0 && link.maxDelayMs == 0) CHECK(r.resent == 0);
+      if (link.corruptPercent == 0) CHECK(r.crcErrors == 0);
+      worstMs = std::max(worstMs, r.elapsedMs);
+      if (seed == 1) {
+        printf("loss=%d%% corrupt=%d%% delay<=%dms: %s, %d resent, %d crc errors, %d ms, %.0f B/s goodput\n",
+               link.lossPercent, link.corruptPercent, link.maxDelayMs, r.delivered ? "delivered" : "FAILED",
+               r.resent, static_cast<int>(r.crcErrors), r.elapsedMs,
+               payload.size() * 1000.0 / std::max(r.elapsedMs, 1));
+      }
+    }
+    printf("  worst of 20 seeds: %d ms\n", worstMs);
+    // 10% loss on an in-order link must not stall on fixed timeouts: a 3.2 KB
+    // cover is 40 chunks, a few milliseconds each on the simulated link.
+    if (link.lossPercent == 10 && link.maxDelayMs == 0) CHECK(worstMs < 1000);
+  }
+}
+
+}  // namespace
+
+int main() {
+  testSackBitmap();
+  testBeginLimits();
+  testLoopback();
+  if (failures) {
+    fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("cover_transfer_test: ok\n");
+  return 0;
+}
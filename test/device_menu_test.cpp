@@ -0,0 +1,235 @@
+// Device menus from the row pool: a 200-entry list is rebuilt the ways the
+// bridge changes it (same list again, reordered, renamed, churned) and edited
+// by deltas. Reports heap allocations and time per rebuild; the steady-state
+// paths must not allocate.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "device_menu.h"
+#include "test_support.h"
+
+using astra::List;
+using astra::Menu;
+
+namespace {
+
+constexpr int LIST_SIZE = 200;
+constexpr int ROUNDS = 50;
+
+std::vector<SpeakerEntry> makeEntries(int count, int firstId, const char *suffix) {
+  std::vector<SpeakerEntry> entries;
+  for (int i = 0; i < count; ++i) {
+    int id = firstId + i;
+    entries.push_back({id, "Speakers (USB Audio Device " + std::to_string(id) + ")" + suffix});
+  }
+  return entries;
+}
+
+// Menu rows must mirror the entries, ids and titles included, in slot order.
+bool matches(const DeviceRowPool &pool, const DeviceMenu &ui, const std::vector<SpeakerEntry> &entries,
+             int currentId) {
+  const auto &rows = ui.menu->childMenu;
+  if (rows.size() != entries.size() + 1 || rows[0] != ui.refreshItem) return false;
+  const float lineHeight = astra::getUIConfig().listLineHeight;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    Menu *row = rows[i + 1];
+    if (device_row_id(&pool, row, ui.menu) != entries[i].id) return false;
+    std::string want = (entries[i].id == currentId ? "* " : "") + entries[i].name;
+    if (row->title != want) return false;
+    if (row->position.yTrg != static_cast<float>(i + 1) * lineHeight) return false;
+  }
+  return true;
+}
+
+struct Measure {
+  size_t allocs;
+  double us;
+};
+
+template <typename Fn>
+Measure measure(Fn fn) {
+  testAllocs = 0;
+  testCountAllocs = true;
+  auto t0 = std::chrono::steady_clock::now();
+  fn();
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  testCountAllocs = false;
+  return {testAllocs, us};
+}
+
+void report(const char *what, const Measure &m, int rounds) {
+  printf("  %-34s %6.2f allocs  %8.2f us\n", what, static_cast<double>(m.allocs) / rounds, m.us / rounds);
+}
+
+struct Fixture {
+  DeviceRowPool pool = {};
+  void *storage = nullptr;
+  List *menu = nullptr;
+  DeviceMenu ui = {};
+
+  Fixture() {
+    storage = aligned_alloc(alignof(DeviceRow), DEVICE_ROW_POOL_BYTES);
+    device_rows_init(&pool, storage);
+    menu = new List("Output Device");
+    ui = {menu, new List("Refresh List"), new List("Loading..."), new List("No devices")};
+  }
+};
+
+void testRebuilds() {
+  Fixture f;
+  const int current = 5;
+  std::vector<SpeakerEntry> base = makeEntries(LIST_SIZE, 1, "");
+  std::vector<SpeakerEntry> reordered = base;
+  std::reverse(reordered.begin(), reordered.end());
+  std::vector<SpeakerEntry> renamed = makeEntries(LIST_SIZE, 1, " #2");
+  // 10% churn: the last 20 ids leave, 20 new ones arrive at the front.
+  std::vector<SpeakerEntry> churned = makeEntries(20, 1000, "");
+  churned.insert(churned.end(), base.begin(), base.end() - 20);
+
+  printf("rebuild %d-entry list (per rebuild):\n", LIST_SIZE);
+  Measure first = measure([&] { CHECK(device_menu_sync(&f.pool, f.ui, base, current, false)); });
+  report("first build", first, 1);
+  CHECK(matches(f.pool, f.ui, base, current));
+
+  Measure same = measure([&] {
+    for (int r = 0; r < ROUNDS; ++r) device_menu_sync(&f.pool, f.ui, base, current, false);
+  });
+  report("same list again", same, ROUNDS);
+  CHECK(same.allocs == 0);
+  CHECK(matches(f.pool, f.ui, base, current));
+
+  Measure reorder = measure([&] {
+    for (int r = 0; r < ROUNDS; ++r) {
+      device_menu_sync(&f.pool, f.ui, r % 2 ? base : reordered, current, false);
+    }
+  });
+  report("reordered", reorder, ROUNDS);
+  CHECK(reorder.allocs == 0);
+  CHECK(matches(f.pool, f.ui, base, current));
+
+  // Longer names grow the title buffers once; after that renames are free.
+  device_menu_sync(&f.pool, f.ui, renamed, current, false);
+  Measure rename = measure([&] {
+    for (int r = 0; r < ROUNDS; ++r) device_menu_sync(&f.pool, f.ui, r % 2 ? base : renamed, current, false);
+  });
+  report("renamed", rename, ROUNDS);
+  CHECK(rename.allocs == 0);
+  CHECK(matches(f.pool, f.ui, base, current));
+
+  // Warm every pool row once so recycled rows already own a large enough title.
+  device_menu_sync(&f.pool, f.ui, churned, current, false);
+  device_menu_sync(&f.pool, f.ui, base, current, false);
+  Measure churn = measure([&] {
+    for (int r = 0; r < ROUNDS; ++r) device_menu_sync(&f.pool, f.ui, r % 2 ? base : churned, current, false);
+  });
+  report("10% churn", churn, ROUNDS);
+  CHECK(churn.allocs == 0);
+  CHECK(matches(f.pool, f.ui, base, current));
+  CHECK(f.pool.freeCount == DEVICE_ROW_POOL - LIST_SIZE);
+
+  // Loading and empty states hand every row back.
+  device_menu_sync(&f.pool, f.ui, {}, current, true);
+  CHECK(f.menu->childMenu.size() == 2 && f.menu->childMenu[1] == f.ui.loadingItem);
+  CHECK(f.pool.freeCount == DEVICE_ROW_POOL);
+  std::vector<SpeakerEntry> none;
+  device_menu_sync(&f.pool, f.ui, none, current, false);
+  CHECK(f.menu->childMenu.size() == 2 && f.menu->childMenu[1] == f.ui.emptyItem);
+
+  // A list larger than the pool is cut short, not overrun.
+  std::vector<SpeakerEntry> huge = makeEntries(static_cast<int>(DEVICE_ROW_POOL) + 10, 1, "");
+  CHECK(!device_menu_sync(&f.pool, f.ui, huge, current, false));
+  CHECK(f.menu->childMenu.size() == DEVICE_ROW_POOL + 1);
+  CHECK(f.pool.freeCount == 0);
+}
+
+void testSelectionFollowsRow() {
+  Fixture f;
+  std::vector<SpeakerEntry> entries = makeEntries(10, 1, "");
+  device_menu_sync(&f.pool, f.ui, entries, -1, false);
+  f.menu->selectIndex = 4;  // id 4
+  Menu *selected = f.menu->childMenu[4];
+  std::reverse(entries.begin(), entries.end());
+  device_menu_sync(&f.pool, f.ui, entries, -1, false);
+  CHECK(f.menu->childMenu[f.menu->selectIndex] == selected);
+  CHECK(device_row_id(&f.pool, selected, f.menu) == 4);
+  // Kept rows slide; they do not jump to the new slot.
+  CHECK(selected->position.y != selected->position.yTrg);
+}
+
+void testDeltas() {
+  Fixture f;
+  const int current = 2;
+  std::vector<SpeakerEntry> entries;
+  device_menu_sync(&f.pool, f.ui, entries, current, false);
+
+  // First entry replaces "No devices": needs the full sync.
+  entries.push_back({1, "Speakers"});
+  CHECK(!device_menu_add(&f.pool, f.ui, entries.back(), current));
+  device_menu_sync(&f.pool, f.ui, entries, current, false);
+  for (int id = 2; id <= 6; ++id) {
+    entries.push_back({id, "Headset " + std::to_string(id)});
+    CHECK(device_menu_add(&f.pool, f.ui, entries.back(), current));
+  }
+  CHECK(matches(f.pool, f.ui, entries, current));
+
+  // Remove below, at and above the selection.
+  f.menu->selectIndex = 3;  // id 3
+  Menu *selected = f.menu->childMenu[3];
+  entries.erase(entries.begin() + 4);  // id 5
+  CHECK(device_menu_remove(&f.pool, f.ui, 5));
+  CHECK(f.menu->childMenu[f.menu->selectIndex] == selected);
+  entries.erase(entries.begin() + 0);  // id 1
+  CHECK(device_menu_remove(&f.pool, f.ui, 1));
+  CHECK(f.menu->childMenu[f.menu->selectIndex] == selected);
+  entries.erase(entries.begin() + 1);  // id 3, the selected one
+  CHECK(device_menu_remove(&f.pool, f.ui, 3));
+  CHECK(device_row_id(&f.pool, f.menu->childMenu[f.menu->selectIndex], f.menu) == 4);
+  CHECK(matches(f.pool, f.ui, entries, current));
+  CHECK(!device_menu_remove(&f.pool, f.ui, 42));
+
+  entries[0].name = "Headset (renamed)";
+  device_menu_retitle(&f.pool, f.ui, entries[0], current);
+  CHECK(matches(f.pool, f.ui, entries, current));
+
+  // Removing the selected last row moves the selection up.
+  f.menu->selectIndex = static_cast<uint16_t>(f.menu->childMenu.size() - 1);
+  entries.pop_back();  // id 6
+  CHECK(device_menu_remove(&f.pool, f.ui, 6));
+  CHECK(f.menu->selectIndex == f.menu->childMenu.size() - 1);
+  CHECK(matches(f.pool, f.ui, entries, current));
+
+  // Deltas on warm rows stay off the heap.
+  Measure m = measure([&] {
+    for (int r = 0; r < ROUNDS; ++r) {
+      SpeakerEntry e = {6, "Headset 6"};
+      device_menu_add(&f.pool, f.ui, e, current);
+      device_menu_retitle(&f.pool, f.ui, e, current);
+      device_menu_remove(&f.pool, f.ui, 6);
+    }
+  });
+  printf("delta add + retitle + remove: %.2f allocs, %.2f us\n", static_cast<double>(m.allocs) / ROUNDS,
+         m.us / ROUNDS);
+  CHECK(m.allocs == 0);
+  CHECK(matches(f.pool, f.ui, entries, current));
+
+  // The last entry gives way to "No devices" through the full sync.
+  while (entries.size() > 1) {
+    CHECK(device_menu_remove(&f.pool, f.ui, entries.back().id));
+    entries.pop_back();
+  }
+  CHECK(!device_menu_remove(&f.pool, f.ui, entries.back().id));
+}
+
+}  // namespace
+
+int main() {
+  static StubHal hal;
+  HAL::inject(&hal);
+  testRebuilds();
+  testSelectionFollowsRow();
+  testDeltas();
+  return testResult("device_menu_test");
+}
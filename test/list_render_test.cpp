@@ -0,0 +1,101 @@
+// Per-frame cost of a List with 10, 100 and 1000 rows, built from child Menu
+// nodes and from a ListSource. The camera settles on the middle of the list
+// (at most row 250) before timing; only rows near the viewport may be
+// measured, so text widths per frame must not grow with the row count.
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "astra/ui/launcher.h"
+#include "test_support.h"
+
+using namespace astra;
+
+namespace {
+
+constexpr int SETTLE_FRAMES = 400;
+constexpr int FRAMES = 1000;
+
+class CountingHal : public StubHal {
+ public:
+  size_t widthCalls = 0;
+  unsigned char _getFontWidth(std::string_view _text) override {
+    widthCalls++;
+    return StubHal::_getFontWidth(_text);
+  }
+};
+
+CountingHal hal;
+
+class TitleSource : public ListSource {
+ public:
+  explicit TitleSource(const std::vector<std::string> &_titles) : titles(_titles) {}
+  [[nodiscard]] uint16_t size() const override { return static_cast<uint16_t>(titles.size()); }
+  [[nodiscard]] const std::string &title(uint16_t _index) const override { return titles[_index]; }
+
+ private:
+  const std::vector<std::string> &titles;
+};
+
+struct Result {
+  double usPerFrame;
+  double widthsPerFrame;
+};
+
+Result run(int rows, bool virtualRows) {
+  std::vector<std::string> titles;
+  for (int i = 0; i < rows; ++i) titles.push_back("Speakers (USB Audio Device " + std::to_string(i) + ")");
+  TitleSource source(titles);
+
+  auto *root = new List("Main");
+  auto *list = new List("Output Device");
+  root->addItem(list);
+  if (virtualRows) {
+    list->setSource(&source);
+  } else {
+    for (const auto &t : titles) list->addItem(new List(t));
+  }
+
+  Launcher launcher;
+  launcher.init(root);
+  launcher.open();
+  int target = std::min(rows / 2, 250);
+  for (int i = 0; i < target; ++i) launcher.getSelector()->goNext();
+  for (int f = 0; f < SETTLE_FRAMES; ++f) {
+    hal.nowMs += 16;
+    launcher.update();
+  }
+  CHECK(launcher.getCurrentMenu() == list);
+  CHECK(list->selectIndex == target);
+
+  hal.widthCalls = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int f = 0; f < FRAMES; ++f) {
+    hal.nowMs += 16;
+    launcher.update();
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+  // The tree is left alive: Menu has no owning destructor and the test exits next.
+  return {us / FRAMES, static_cast<double>(hal.widthCalls) / FRAMES};
+}
+
+}  // namespace
+
+int main() {
+  HAL::inject(&hal);
+  const auto &sys = HAL::getSystemConfig();
+  // Visible lines plus the one-line margin on each side, and the title bar.
+  double widthBound = sys.screenHeight / getUIConfig().listLineHeight + 4;
+
+  printf("rows  nodes                  virtual\n");
+  for (int rows : {10, 100, 1000}) {
+    Result nodes = run(rows, false);
+    Result virt = run(rows, true);
+    printf("%-5d %6.2f us %5.1f widths  %6.2f us %5.1f widths\n", rows, nodes.usPerFrame, nodes.widthsPerFrame,
+           virt.usPerFrame, virt.widthsPerFrame);
+    CHECK(nodes.widthsPerFrame <= widthBound);
+    CHECK(virt.widthsPerFrame <= widthBound);
+  }
+  return testResult("list_render_test");
+}
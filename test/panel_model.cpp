@@ -0,0 +1,66 @@
+#include "panel_model.h"
+
+#include <algorithm>
+
+namespace {
+
+bool modelAddress(const PanelGeometry &geo, int x, int y, int *col, int *row) {
+  const int cx = x + geo.gapX;
+  const int cy = y + geo.gapY;
+  int c = geo.swapXY ? cy : cx;
+  int r = geo.swapXY ? cx : cy;
+  if (geo.mirrorX) c = geo.nativeCols - 1 - c;
+  if (geo.mirrorY) r = geo.nativeRows - 1 - r;
+  if (c < 0 || c >= geo.nativeCols || r < 0 || r >= geo.nativeRows) return false;
+  *col = c;
+  *row = r;
+  return true;
+}
+
+// GRAM row shown on a gate line, per VSCRDEF/VSCSAD.
+int shownRow(const PanelModel *m, int gate) {
+  if (gate < m->tfa || gate >= m->tfa + m->vsa) return gate;
+  return m->tfa + (gate - m->tfa + m->vsp - m->tfa) % m->vsa;
+}
+
+uint16_t get16(const uint8_t *in) { return static_cast<uint16_t>((in[0] << 8) | in[1]); }
+
+}  // namespace
+
+void panel_model_init(PanelModel *m, const PanelGeometry &geo, uint16_t *gram) {
+  m->geo = geo;
+  m->gram = gram;
+  m->tfa = 0;
+  m->vsa = static_cast<uint16_t>(geo.nativeRows);
+  m->bfa = 0;
+  m->vsp = 0;
+  std::fill(gram, gram + geo.nativeCols * geo.nativeRows, 0);
+}
+
+void panel_model_draw(PanelModel *m, int x0, int y0, int x1, int y1, const uint16_t *data) {
+  const int w = x1 - x0;
+  for (int y = y0; y < y1; ++y) {
+    for (int x = x0; x < x1; ++x) {
+      int col, row;
+      if (modelAddress(m->geo, x, y, &col, &row)) {
+        m->gram[row * m->geo.nativeCols + col] = data[(y - y0) * w + (x - x0)];
+      }
+    }
+  }
+}
+
+void panel_model_command(PanelModel *m, uint8_t cmd, const uint8_t *params, int len) {
+  if (cmd == PANEL_CMD_VSCRDEF && len >= 6) {
+    m->tfa = get16(params);
+    m->vsa = get16(params + 2);
+    m->bfa = get16(params + 4);
+  } else if (cmd == PANEL_CMD_VSCSAD && len >= 2) {
+    m->vsp = get16(params);
+  }
+}
+
+uint16_t panel_model_glass(const PanelModel *m, int x, int y) {
+  int col, gate;
+  if (!modelAddress(m->geo, x, y, &col, &gate)) return 0;
+  return m->gram[shownRow(m, gate) * m->geo.nativeCols + col];
+}
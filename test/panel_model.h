@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+#include "panel_scroll.h"
+
+// Headless ST7789 for the scroll tests: GRAM, the MADCTL address mapping and
+// the VSCRDEF/VSCSAD registers, fed the same draw_bitmap windows and command
+// bytes the HAL sends. Written from the controller's side, independently of
+// panel_scroll.cpp, so the two check each other.
+struct PanelModel {
+  PanelGeometry geo;
+  uint16_t *gram;  // nativeCols * nativeRows, owned by the caller
+  uint16_t tfa;
+  uint16_t vsa;
+  uint16_t bfa;
+  uint16_t vsp;
+};
+
+void panel_model_init(PanelModel *m, const PanelGeometry &geo, uint16_t *gram);
+// esp_lcd_panel_draw_bitmap(): logical window, end exclusive, row-major data.
+void panel_model_draw(PanelModel *m, int x0, int y0, int x1, int y1, const uint16_t *data);
+void panel_model_command(PanelModel *m, uint8_t cmd, const uint8_t *params, int len);
+// Pixel seen on the glass at the spot logical (x, y) occupies when unscrolled.
+uint16_t panel_model_glass(const PanelModel *m, int x, int y);
@@ -0,0 +1,184 @@
+// panel_scroll against the panel model, with and without a gap. Portrait
+// orientations (scroll axis y) are driven the way the HAL drives them: full
+// frames as one unscrolled window, scroll steps as exposed rows at their
+// scrolled addresses, status rows resent at theirs. Every pixel on the glass
+// must match the picture that was meant to be there. Landscape orientations
+// scroll along x, which the HAL refuses, so they only check the mapping.
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "panel_model.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                     \
+    }                                                                 \
+  } while (0)
+
+constexpr int NATIVE_COLS = 240;
+constexpr int NATIVE_ROWS = 320;
+constexpr int FRAMES = 400;
+constexpr int STATUS_ROWS = 12;  // resent as whole rows, like the status bar
+
+uint32_t mix(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352d;
+  x ^= x >> 15;
+  x *= 0x846ca68b;
+  x ^= x >> 16;
+  return x;
+}
+
+struct Scene {
+  PanelScroll scroll;
+  PanelModel model;
+  std::vector<uint16_t> gram;
+  int w;
+  int h;
+  int lo;  // scrolled rows
+  int hi;
+  int offset;
+  uint32_t salt;  // changes the static part of the first STATUS_ROWS rows
+  size_t sentPixels;
+
+  // The intended picture: rows inside [lo, hi) move with offset.
+  uint16_t pixel(int x, int y) const {
+    if (y >= lo && y < hi) return static_cast<uint16_t>(mix((y + offset) * 4099 + x));
+    return static_cast<uint16_t>(mix(y * 131 + x * 7 + (y < STATUS_ROWS ? salt : 0)));
+  }
+
+  void sendState() {
+    uint8_t area[6];
+    uint8_t start[2];
+    panel_scroll_area_params(&scroll, area);
+    panel_scroll_start_params(&scroll, start);
+    panel_model_command(&model, PANEL_CMD_VSCRDEF, area, sizeof(area));
+    panel_model_command(&model, PANEL_CMD_VSCSAD, start, sizeof(start));
+  }
+
+  void draw(int x0, int y0, int x1, int y1, const uint16_t *data) {
+    panel_model_draw(&model, x0, y0, x1, y1, data);
+    sentPixels += static_cast<size_t>((x1 - x0) * (y1 - y0));
+  }
+
+  void fullFrame() {
+    if (panel_scroll_shifted(&scroll)) {
+      panel_scroll_rewind(&scroll);
+      sendState();
+    }
+    std::vector<uint16_t> frame(static_cast<size_t>(w * h));
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) frame[y * w + x] = pixel(x, y);
+    }
+    draw(0, 0, w, h, frame.data());
+  }
+
+  // Whole logical rows, as flushCanvasRows sends them.
+  void rows(int y0, int y1) {
+    std::vector<uint16_t> line(static_cast<size_t>(w));
+    for (int y = y0; y < y1; ++y) {
+      for (int x = 0; x < w; ++x) line[x] = pixel(x, y);
+      const int a = panel_scroll_shifted(&scroll) ? panel_scroll_address(&scroll, y) : y;
+      draw(0, a, w, a + 1, line.data());
+    }
+  }
+
+  void scrollBy(int delta) {
+    offset += delta;
+    if (scroll.areaLo != lo || scroll.areaHi != hi) {
+      CHECK(panel_scroll_set_area(&scroll, lo, hi));
+      sendState();
+      fullFrame();
+      return;
+    }
+    int e0, e1;
+    panel_scroll_by(&scroll, delta, &e0, &e1);
+    sendState();
+    rows(e0, e1);
+  }
+
+  int mismatches() const {
+    int bad = 0;
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) bad += panel_model_glass(&model, x, y) != pixel(x, y);
+    }
+    return bad;
+  }
+};
+
+void run(bool swapXY, bool mirrorX, bool mirrorY, int gap) {
+  // The gap shortens the screen along the gate lines (a 240x280 cut).
+  const PanelGeometry geo{NATIVE_COLS, NATIVE_ROWS, swapXY ? gap : 0, swapXY ? 0 : gap, swapXY, mirrorX, mirrorY};
+  Scene s{};
+  s.w = swapXY ? NATIVE_ROWS - 2 * gap : NATIVE_COLS;
+  s.h = swapXY ? NATIVE_COLS : NATIVE_ROWS - 2 * gap;
+  s.gram.resize(static_cast<size_t>(NATIVE_COLS * NATIVE_ROWS));
+  panel_model_init(&s.model, geo, s.gram.data());
+  panel_scroll_init(&s.scroll, geo);
+  s.lo = STATUS_ROWS;
+  s.hi = s.h;
+  s.sendState();
+  s.fullFrame();
+  CHECK(s.mismatches() == 0);
+  CHECK(panel_scroll_axis_is_y(&s.scroll) == !swapXY);
+  if (swapXY) return;
+
+  srand(swapXY * 4 + mirrorX * 2 + mirrorY + gap);
+  size_t scrollPixels = 0;
+  int scrolls = 0;
+  int bad = s.mismatches();
+  for (int f = 0; f < FRAMES && bad == 0; ++f) {
+    const int r = rand() % 100;
+    if (r < 3) {
+      s.lo = rand() % 40;
+      s.hi = s.h - rand() % 40;
+    }
+    if (r >= 3 && r < 6) {
+      s.offset += rand() % 9 - 4;
+      s.fullFrame();
+    } else if (r >= 6 && r < 9) {
+      s.salt++;
+      s.rows(0, STATUS_ROWS);
+    } else {
+      s.sentPixels = 0;
+      s.scrollBy(r % 7 == 0 ? rand() % 80 - 40 : rand() % 9 - 4);
+      scrollPixels += s.sentPixels;
+      scrolls++;
+    }
+    bad = s.mismatches();
+    if (bad) fprintf(stderr, "frame %d (r=%d): %d pixels differ\n", f, r, bad);
+  }
+  CHECK(bad == 0);
+
+  // A full frame after scrolling is one window again, not rows in address order.
+  s.scrollBy(7);
+  s.sentPixels = 0;
+  s.fullFrame();
+  CHECK(!panel_scroll_shifted(&s.scroll));
+  CHECK(s.sentPixels == static_cast<size_t>(s.w * s.h));
+  CHECK(s.mismatches() == 0);
+
+  printf("swap=%d mirrorX=%d mirrorY=%d gap=%d: scroll frames avg %zu px of %d\n", swapXY, mirrorX, mirrorY, gap,
+         scrolls ? scrollPixels / scrolls : 0, s.w * s.h);
+}
+
+}  // namespace
+
+int main() {
+  for (int combo = 0; combo < 8; ++combo) {
+    for (int gap : {0, 20}) run(combo & 4, combo & 2, combo & 1, gap);
+  }
+  if (failures) {
+    fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("panel_scroll_test: ok\n");
+  return 0;
+}
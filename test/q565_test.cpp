@@ -0,0 +1,279 @@
+// Q565 round trips: a port of the PC encoder (pc/SongLedPc/Q565Codec.cs)
+// produces the streams, the firmware decoder (cover_codec.cpp) must give back
+// the source pixels for every opcode, run length and feed split.
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "cover_codec.h"
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                   \
+  do {                                                                \
+    if (!(cond)) {                                                    \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                     \
+    }                                                                 \
+  } while (0)
+
+constexpr int MAX_RUN = 62;
+
+int hash(uint16_t px) {
+  int r = (px >> 11) & 0x1F;
+  int g = (px >> 5) & 0x3F;
+  int b = px & 0x1F;
+  return (r * 3 + g * 5 + b * 7) & 63;
+}
+
+int wrap(int delta, int range) {
+  int half = range / 2;
+  return ((delta + half) & (range - 1)) - half;
+}
+
+std::vector<uint8_t> encode(const std::vector<uint16_t> &pixels) {
+  std::vector<uint8_t> out;
+  uint16_t index[64] = {};
+  uint16_t prev = 0;
+  int run = 0;
+  for (size_t i = 0; i < pixels.size(); ++i) {
+    uint16_t px = pixels[i];
+    if (px == prev) {
+      run++;
+      if (run == MAX_RUN || i == pixels.size() - 1) {
+        out.push_back(static_cast<uint8_t>(Q565_OP_RUN | (run - 1)));
+        run = 0;
+      }
+      continue;
+    }
+    if (run > 0) {
+      out.push_back(static_cast<uint8_t>(Q565_OP_RUN | (run - 1)));
+      run = 0;
+    }
+    int h = hash(px);
+    if (index[h] == px) {
+      out.push_back(static_cast<uint8_t>(Q565_OP_INDEX | h));
+    } else {
+      index[h] = px;
+      int dr = wrap(((px >> 11) & 0x1F) - ((prev >> 11) & 0x1F), 32);
+      int dg = wrap(((px >> 5) & 0x3F) - ((prev >> 5) & 0x3F), 64);
+      int db = wrap((px & 0x1F) - (prev & 0x1F), 32);
+      int drdg = dr - dg;
+      int dbdg = db - dg;
+      if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+        out.push_back(static_cast<uint8_t>(Q565_OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2)));
+      } else if (drdg >= -8 && drdg <= 7 && dbdg >= -8 && dbdg <= 7) {
+        out.push_back(static_cast<uint8_t>(Q565_OP_LUMA | (dg + 32)));
+        out.push_back(static_cast<uint8_t>(((drdg + 8) << 4) | (dbdg + 8)));
+      } else {
+        out.push_back(Q565_OP_RGB);
+        out.push_back(static_cast<uint8_t>(px >> 8));
+        out.push_back(static_cast<uint8_t>(px & 0xFF));
+      }
+    }
+    prev = px;
+  }
+  return out;
+}
+
+std::vector<uint16_t> adam7Order(const std::vector<uint16_t> &pixels, int width, int height) {
+  static const int passes[7][4] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4},
+                                   {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+  std::vector<uint16_t> ordered;
+  for (const auto &p : passes) {
+    for (int y = p[1]; y < height; y += p[3]) {
+      for (int x = p[0]; x < width; x += p[2]) ordered.push_back(pixels[y * width + x]);
+    }
+  }
+  return ordered;
+}
+
+// Op counts by kind, walking the stream the way the decoder does.
+struct OpStats {
+  int index, diff, luma, run, rgb, maxRun;
+};
+
+OpStats scan(const std::vector<uint8_t> &stream) {
+  OpStats s = {};
+  for (size_t i = 0; i < stream.size();) {
+    uint8_t tag = stream[i];
+    if (tag == Q565_OP_RGB) {
+      s.rgb++;
+      i += 3;
+    } else if ((tag & Q565_MASK) == Q565_OP_LUMA) {
+      s.luma++;
+      i += 2;
+    } else {
+      if ((tag & Q565_MASK) == Q565_OP_INDEX) s.index++;
+      if ((tag & Q565_MASK) == Q565_OP_DIFF) s.diff++;
+      if ((tag & Q565_MASK) == Q565_OP_RUN) {
+        s.run++;
+        s.maxRun = std::max(s.maxRun, (tag & 0x3F) + 1);
+      }
+      i += 1;
+    }
+  }
+  return s;
+}
+
+uint16_t swap16(uint16_t v) { return static_cast<uint16_t>((v >> 8) | (v << 8)); }
+
+// Decodes `stream` fed `slice` bytes at a time (0 = all at once).
+bool decode(const std::vector<uint8_t> &stream, size_t slice, std::vector<uint16_t> &out, bool swapBytes,
+            int width = 0, int height = 0) {
+  CoverStreamDecoder dec;
+  cover_decoder_begin(&dec, COVER_FMT_Q565, out.data(), static_cast<int>(out.size()), swapBytes);
+  if (width > 0) cover_decoder_interlace(&dec, width, height);
+  if (slice == 0) slice = stream.size();
+  for (size_t i = 0; i < stream.size(); i += slice) {
+    size_t n = std::min(slice, stream.size() - i);
+    if (!cover_decoder_feed(&dec, stream.data() + i, n)) return false;
+  }
+  return cover_decoder_done(&dec);
+}
+
+bool roundTrip(const std::vector<uint16_t> &pixels) {
+  std::vector<uint8_t> stream = encode(pixels);
+  bool ok = true;
+  for (size_t slice : {size_t(0), size_t(1), size_t(2), size_t(7)}) {
+    for (bool swapBytes : {false, true}) {
+      std::vector<uint16_t> out(pixels.size(), 0xDEAD);
+      if (!decode(stream, slice, out, swapBytes)) {
+        ok = false;
+        continue;
+      }
+      for (size_t i = 0; i < pixels.size(); ++i) {
+        if (out[i] != (swapBytes ? swap16(pixels[i]) : pixels[i])) {
+          ok = false;
+          break;
+        }
+      }
+    }
+  }
+  return ok;
+}
+
+uint16_t rgb(int r, int g, int b) { return static_cast<uint16_t>(((r & 0x1F) << 11) | ((g & 0x3F) << 5) | (b & 0x1F)); }
+
+void testRuns() {
+  const uint16_t c = rgb(3, 9, 27);
+  for (int n : {1, 2, 61, 62, 63, 124, 125, 200}) {
+    // Leading pixel breaks away from prev = 0, then n repeats of it.
+    std::vector<uint16_t> pixels(static_cast<size_t>(n) + 1, c);
+    OpStats s = scan(encode(pixels));
+    CHECK(s.maxRun <= MAX_RUN);
+    CHECK(s.run == (n + MAX_RUN - 1) / MAX_RUN);
+    if (n >= MAX_RUN) CHECK(s.maxRun == MAX_RUN);
+    CHECK(roundTrip(pixels));
+
+    // Same run followed by a different pixel (run flushed by a color change).
+    pixels.push_back(rgb(4, 9, 27));
+    CHECK(roundTrip(pixels));
+  }
+  // The longest RUN tag is 0xFD; 0xFE is the RGB escape, not a 63-pixel run.
+  std::vector<uint16_t> flat(MAX_RUN + 1, c);
+  std::vector<uint8_t> stream = encode(flat);
+  CHECK(stream.back() == static_cast<uint8_t>(Q565_OP_RUN | (MAX_RUN - 1)));
+  CHECK(stream.back() == 0xFD);
+  // A stream starting with black is one run of prev = 0.
+  std::vector<uint16_t> black(10, 0);
+  CHECK(encode(black).size() == 1);
+  CHECK(roundTrip(black));
+}
+
+void testOps() {
+  // DIFF: small steps in every channel, including 5/6-bit wraparound.
+  std::vector<uint16_t> diff;
+  int r = 30, g = 62, b = 1;
+  for (int i = 0; i < 200; ++i) {
+    r = (r + (i % 4) - 2) & 0x1F;
+    g = (g + ((i / 4) % 4) - 2) & 0x3F;
+    b = (b + ((i / 16) % 4) - 2) & 0x1F;
+    diff.push_back(rgb(r, g, b));
+  }
+  OpStats s = scan(encode(diff));
+  CHECK(s.diff > 0);
+  CHECK(roundTrip(diff));
+
+  // LUMA: large green steps with the red/blue deltas tracking it.
+  std::vector<uint16_t> luma;
+  for (int i = 0; i < 200; ++i) luma.push_back(rgb(i * 5 + 3, i * 11, i * 5 - 2));
+  s = scan(encode(luma));
+  CHECK(s.luma > 0);
+  CHECK(roundTrip(luma));
+
+  // RGB escape: unrelated channels jump far apart.
+  std::vector<uint16_t> noise;
+  uint32_t seed = 12345;
+  for (int i = 0; i < 1600; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    noise.push_back(static_cast<uint16_t>(seed >> 16));
+  }
+  s = scan(encode(noise));
+  CHECK(s.rgb > 0);
+  CHECK(roundTrip(noise));
+
+  // INDEX: a small palette cycled so every color is back in the table.
+  const uint16_t palette[] = {rgb(31, 0, 0), rgb(0, 63, 0), rgb(0, 0, 31), rgb(20, 40, 10)};
+  std::vector<uint16_t> cycled;
+  for (int i = 0; i < 400; ++i) cycled.push_back(palette[i % 4]);
+  s = scan(encode(cycled));
+  CHECK(s.index > 300);
+  CHECK(roundTrip(cycled));
+
+  // A cover-like mix of all of the above.
+  std::vector<uint16_t> mix;
+  for (int y = 0; y < 40; ++y) {
+    for (int x = 0; x < 40; ++x) {
+      uint16_t px = y < 10 ? rgb(x / 2, y * 3, 31 - x / 2) : y < 20 ? palette[(x / 5) % 4]
+                  : y < 30 ? noise[static_cast<size_t>(y * 40 + x)] : rgb(5, 5, 5);
+      mix.push_back(px);
+    }
+  }
+  s = scan(encode(mix));
+  CHECK(s.index > 0 && s.diff > 0 && s.run > 0 && s.rgb > 0);
+  CHECK(roundTrip(mix));
+}
+
+void testInterlaced() {
+  constexpr int W = 40;
+  constexpr int H = 40;
+  std::vector<uint16_t> pixels;
+  for (int y = 0; y < H; ++y) {
+    for (int x = 0; x < W; ++x) pixels.push_back(rgb(x * 31 / W, (x + y) * 63 / (W + H), y * 31 / H));
+  }
+  std::vector<uint8_t> stream = encode(adam7Order(pixels, W, H));
+  for (size_t slice : {size_t(0), size_t(1), size_t(80)}) {
+    std::vector<uint16_t> out(pixels.size(), 0);
+    CHECK(decode(stream, slice, out, false, W, H));
+    CHECK(out == pixels);
+  }
+}
+
+void testMalformed() {
+  std::vector<uint16_t> out(4, 0);
+  // A run past the end of the image.
+  CHECK(!decode({static_cast<uint8_t>(Q565_OP_RUN | 4)}, 0, out, false));
+  // Reserved tag.
+  CHECK(!decode({0xFF}, 0, out, false));
+  // More pixels than the buffer holds.
+  CHECK(!decode({Q565_OP_RGB, 0x12, 0x34, static_cast<uint8_t>(Q565_OP_RUN | 3)}, 0, out, false));
+}
+
+}  // namespace
+
+int main() {
+  testRuns();
+  testOps();
+  testInterlaced();
+  testMalformed();
+  if (failures) {
+    fprintf(stderr, "%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("q565_test: ok\n");
+  return 0;
+}
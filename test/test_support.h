@@ -0,0 +1,44 @@
+#pragma once
+
+// Shared bits of the host tests: a CHECK macro that counts failures, a HAL
+// that draws nothing, and the heap counter from alloc_count.cpp.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+#include "hal.h"
+
+extern int testFailures;
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+      testFailures++;                                                          \
+    }                                                                          \
+  } while (0)
+
+// operator new calls while testCountAllocs is set (alloc_count.cpp).
+extern size_t testAllocs;
+extern bool testCountAllocs;
+
+// Canvas-less HAL: fixed-pitch text widths and a clock the test advances.
+class StubHal : public HAL {
+ public:
+  uint32_t nowMs = 0;
+  unsigned char _getFontWidth(std::string_view _text) override {
+    return static_cast<unsigned char>(_text.size() * 6);
+  }
+  unsigned char _getFontHeight() override { return 12; }
+  unsigned long _millis() override { return nowMs; }
+};
+
+inline int testResult(const char *name) {
+  if (testFailures) {
+    fprintf(stderr, "%s: %d check(s) failed\n", name, testFailures);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
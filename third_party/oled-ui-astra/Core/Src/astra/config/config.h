@@ -9,6 +9,9 @@
 #include "../../hal/hal_dreamCore/components/oled/graph_lib/u8g2/u8g2.h"
 
 namespace astra {
+//页面切换过渡 按时间推进 不阻塞
+enum class PageTransition : unsigned char { None, Fade, Slide };
+
 /**
  * @brief config of astra ui. astra ui的配置结构体
  */
@@ -23,10 +26,12 @@ struct config {
   float wrapPauseMs = 300;
   float windowAnimationSpeed = 25;
   float sideBarAnimationSpeed = 15;
-  float fadeAnimationSpeed = 100;
+  float fadeAnimationSpeed = 100; //页面过渡时长(ms)
   float cameraAnimationSpeed = 80;
   float logoAnimationSpeed = 70;
 
+  PageTransition pageTransition = PageTransition::Fade;
+
   bool tileUnfold = true;
   bool listUnfold = true;
 
@@ -90,7 +95,9 @@ struct config {
   float checkBoxRadius = 1;
 };
 
-static config &getUIConfig() {
+// inline (not static): one instance shared by every translation unit, so
+// settings written from the app are the ones the widgets read.
+inline config &getUIConfig() {
   static config astraConfig;
   return astraConfig;
 }
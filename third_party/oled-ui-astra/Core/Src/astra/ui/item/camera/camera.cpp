@@ -45,20 +45,12 @@ unsigned char Camera::outOfView(float _x, float _y) {
   return 0;
 }
 
-std::vector<float> Camera::getPosition() {
-  return {x, y};
-}
-
-std::vector<float> Camera::getPositionTrg() {
-  return {xTrg, yTrg};
-}
-
-void Camera::init(const std::string &_type) {
-  if (_type == "List") {
+void Camera::init(MenuType _type) {
+  if (_type == MenuType::List) {
     this->goDirect(0, static_cast<float>((0 - sys::getSystemConfig().screenHeight) * 10));
     //this->render();
   }
-  else if (_type == "Tile") {
+  else if (_type == MenuType::Tile) {
     this->goDirect(static_cast<float>((0 - sys::getSystemConfig().screenWeight) * 10), 0);
     //this->render();
   }
@@ -77,9 +69,9 @@ void Camera::go(float _x, float _y) {
   this->yTrg = 0 - _y;
 }
 
-void Camera::go(const std::vector<float> &_pos) {
-  this->xTrg = 0 - _pos[0];
-  this->yTrg = 0 - _pos[1];
+void Camera::go(const Vec2 &_pos) {
+  this->xTrg = 0 - _pos.x;
+  this->yTrg = 0 - _pos.y;
 }
 
 void Camera::goDirect(float _x, float _y) {
@@ -124,7 +116,7 @@ void Camera::goToListItemRolling(List *_menu) {
   else return;
 }
 
-void Camera::goToTileItem(unsigned char _index) {
+void Camera::goToTileItem(uint16_t _index) {
   go(_index * (astraConfig.tilePicWidth + astraConfig.tilePicMargin), 0);
 }
 
@@ -144,13 +136,13 @@ void Camera::render() {
 void Camera::update(Menu *_menu, Selector *_selector) {
 
   if (_menu->cameraPosMemoryFlag) {
-    go(0 - _menu->getCameraMemoryPos()[0], 0 - _menu->getCameraMemoryPos()[1]);
+    go(0 - _menu->getCameraMemoryPos().x, 0 - _menu->getCameraMemoryPos().y);
     _menu->cameraPosMemoryFlag = false;
     _menu->resetCameraMemoryPos();
   }
     //if (this->isReached(_menu->getCameraMemoryPos())) _menu->cameraPosMemoryFlag = false;
-  if (_menu->getType() == "List") goToListItemRolling(static_cast<List*>(_menu));
-  else if (_menu->getType() == "Tile") goToTileItem(_menu->selectIndex);
+  if (_menu->getType() == MenuType::List) goToListItemRolling(static_cast<List*>(_menu));
+  else if (_menu->getType() == MenuType::Tile) goToTileItem(_menu->selectIndex);
 
   this->render();
 }
@@ -28,11 +28,11 @@ public:
   Camera(float _x, float _y); //build a camera instance with position.
 
   unsigned char outOfView(float _x, float _y);
-  unsigned char outOfView(std::vector<float> _pos) { return outOfView(_pos[0], _pos[1]); }
-  [[nodiscard]] std::vector<float> getPosition();
-  [[nodiscard]] std::vector<float> getPositionTrg();
+  unsigned char outOfView(const Vec2 &_pos) { return outOfView(_pos.x, _pos.y); }
+  [[nodiscard]] Vec2 getPosition() const { return {x, y}; }
+  [[nodiscard]] Vec2 getPositionTrg() const { return {xTrg, yTrg}; }
 
-  void init(const std::string &_type);
+  void init(MenuType _type);
 
   //在启动器中新建selector和camera 然后注入menu render
   //在启动器中执行下述方法即可实现视角移动
@@ -41,7 +41,7 @@ public:
 
   //go to a position.
   void go(float _x, float _y);
-  void go(const std::vector<float> &_pos); //go to a position.
+  void go(const Vec2 &_pos); //go to a position.
   void goDirect(float _x, float _y);
 
   //move to a position.
@@ -49,7 +49,7 @@ public:
   void moveDirect(float _x, float _y);
 
   void goToListItemRolling(List *_menu);
-  void goToTileItem(unsigned char _index);
+  void goToTileItem(uint16_t _index);
 
   void reset();
   void resetDirect();
@@ -15,77 +15,40 @@ extern float g_anim_dt;
 extern uint32_t g_anim_last_ms;
 extern float g_anim_speed_scale;
 
+//每帧的缓动系数按速度(1~95)缓存 同一帧内相同速度只算一次 exp 由 tick 清空
+constexpr unsigned char ANIM_SPEED_MAX = 95;
+extern float g_anim_alpha[ANIM_SPEED_MAX + 1];
+//本帧有变化的动画数 为 0 表示全部静止 由 tick 清零
+extern uint16_t g_anim_active;
+
+//摄像机/选择框坐标 按值传递 不分配堆内存
+struct Vec2 {
+  float x, y;
+};
+
+//列表/磁贴类型标签 代替字符串比较
+enum class MenuType : unsigned char { Base, List, Tile };
+
 class Item {
 protected:
-  sys::config systemConfig;
-  config astraConfig;
-
-  inline void updateConfig() {
-    this->systemConfig = HAL::getSystemConfig();
-    this->astraConfig = getUIConfig();
-  }
+  //直接引用全局配置 渲染时不再整体拷贝
+  //item 必须在 HAL::inject() 之后创建
+  const sys::config &systemConfig = HAL::getSystemConfig();
+  const config &astraConfig = getUIConfig();
 };
 
 class Animation {
 public:
   static void entry();
-  static void exit();
   static void blur();
   static void tick();
   static void move(float *_pos, float _posTrg, float _speed);
+  static void busy() { g_anim_active++; } //不经过 move 的动画（按时间推进的）每帧调用一次
+  [[nodiscard]] static bool idle() { return g_anim_active == 0; } //上一帧所有动画都已静止
 };
 
 inline void Animation::entry() { }
 
-//todo 未实现功能
-inline void Animation::exit() {
-  static unsigned char fadeFlag = 1;
-  static size_t bufferLen = 8 * static_cast<size_t>(HAL::getBufferTileHeight()) *
-                            static_cast<size_t>(HAL::getBufferTileWidth());
-  auto *bufferPointer = (unsigned char *) HAL::getCanvasBuffer();
-
-  HAL::delay(getUIConfig().fadeAnimationSpeed);
-
-  if (getUIConfig().lightMode)
-    switch (fadeFlag) {
-      case 1:
-        for (uint16_t i = 0; i < bufferLen; ++i) if (i % 2 != 0) bufferPointer[i] = bufferPointer[i] & 0xAA;
-        break;
-      case 2:
-        for (uint16_t i = 0; i < bufferLen; ++i) if (i % 2 != 0) bufferPointer[i] = bufferPointer[i] & 0x00;
-        break;
-      case 3:
-        for (uint16_t i = 0; i < bufferLen; ++i) if (i % 2 == 0) bufferPointer[i] = bufferPointer[i] & 0x55;
-        break;
-      case 4:
-        for (uint16_t i = 0; i < bufferLen; ++i) if (i % 2 == 0) bufferPointer[i] = bufferPointer[i] & 0x00;
-        break;
-      default:
-        //放动画结束退出函数的代码
-        fadeFlag = 0;
-        break;
-    }
-  else
-    switch (fadeFlag) {
-      case 1:
-        for (uint16_t i = 0; i < bufferLen; ++i) if (i % 2 != 0) bufferPointer[i] = bufferPointer[i] | 0xAA;
-        break;
-      case 2:
-        for (uint16_t i = 0; i < bufferLen; ++i) if (i % 2 != 0) bufferPointer[i] = bufferPointer[i] | 0x00;
-        break;
-      case 3:
-        for (uint16_t i = 0; i < bufferLen; ++i) if (i % 2 == 0) bufferPointer[i] = bufferPointer[i] | 0x55;
-        break;
-      case 4:
-        for (uint16_t i = 0; i < bufferLen; ++i) if (i % 2 == 0) bufferPointer[i] = bufferPointer[i] | 0x00;
-        break;
-      default:
-        fadeFlag = 0;
-        break;
-    }
-  fadeFlag++;
-}
-
 inline void Animation::blur() {
   static size_t bufferLen = 8 * static_cast<size_t>(HAL::getBufferTileHeight()) *
                             static_cast<size_t>(HAL::getBufferTileWidth());
@@ -96,19 +59,24 @@ inline void Animation::blur() {
 
 inline void Animation::move(float *_pos, float _posTrg, float _speed) {
   if (*_pos == _posTrg) return;
+  g_anim_active++;  //落到终点的这一帧也要画出来
   float diff = _posTrg - *_pos;
   if (std::fabs(diff) <= 1.0f) {
     *_pos = _posTrg;
     return;
   }
-  float dt = g_anim_dt * g_anim_speed_scale;
-  if (dt < 0.001f) dt = 0.001f;
-  if (dt > 0.25f) dt = 0.25f;
-  float speed = _speed;
-  if (speed < 1.0f) speed = 1.0f;
-  if (speed > 95.0f) speed = 95.0f;
-  float k = speed / 30.0f; // tuned to match legacy at 60fps
-  float alpha = 1.0f - std::exp(-k * dt);
+  int speed = static_cast<int>(_speed + 0.5f);
+  if (speed < 1) speed = 1;
+  if (speed > ANIM_SPEED_MAX) speed = ANIM_SPEED_MAX;
+  float &alpha = g_anim_alpha[speed];
+  if (alpha < 0.0f) {
+    //指数衰减的精确离散 与帧率无关
+    float dt = g_anim_dt * g_anim_speed_scale;
+    if (dt < 0.001f) dt = 0.001f;
+    if (dt > 0.25f) dt = 0.25f;
+    float k = speed / 30.0f; // tuned to match legacy at 60fps
+    alpha = 1.0f - std::exp(-k * dt);
+  }
   *_pos += diff * alpha;
 }
 }
@@ -28,25 +28,24 @@
  */
 
 namespace astra {
-Menu::Position Menu::getItemPosition(unsigned char _index) const { return childMenu[_index]->position; }
+Menu::Position Menu::getItemPosition(uint16_t _index) const { return childMenu[_index]->position; }
+
+const std::string &Menu::getItemTitle(uint16_t _index) const { return childMenu[_index]->title; }
 
 std::vector<unsigned char> Menu::generateDefaultPic() {
   this->picDefault.resize(120, 0xFF);
   return this->picDefault;
 }
 
-unsigned char Menu::getItemNum() const { return childMenu.size(); }
+uint16_t Menu::getItemNum() const { return childMenu.size(); }
 
-Menu *Menu::getNextMenu() const { return childMenu[selectIndex]; }
+Menu *Menu::getNextMenu() const { return selectIndex < childMenu.size() ? childMenu[selectIndex] : nullptr; }
 
 Menu *Menu::getPreview() const { return parent; }
 
-void Menu::init(const std::vector<float>& _camera) { }
+void Menu::init(const Vec2 &_camera) { }
 
-void Menu::deInit() {
-  //todo 未实现完全
-  Animation::exit();
-}
+void Menu::deInit() { }
 
 bool Menu::addItem(Menu *_page) {
   if (_page == nullptr) return false;
@@ -68,8 +67,8 @@ bool Menu::addItem(Menu *_page, Widget *_anyWidget) {
   } else return false;
 }
 
-void List::childPosInit(const std::vector<float> &_camera) {
-  unsigned char _index = 0;
+void List::childPosInit(const Vec2 &_camera) {
+  uint16_t _index = 0;
 
   for (auto _iter : childMenu) {
     _iter->position.x = astraConfig.listTextMargin;
@@ -81,7 +80,7 @@ void List::childPosInit(const std::vector<float> &_camera) {
     //受展开开关影响的坐标初始化
     //根页面有开场动画 所以不需要从头展开
     if (_iter->parent->parent == nullptr) { _iter->position.y = _iter->position.yTrg; continue; }
-    if (astraConfig.listUnfold) { _iter->position.y = _camera[1] - astraConfig.listLineHeight;
+    if (astraConfig.listUnfold) { _iter->position.y = _camera.y - astraConfig.listLineHeight;
       continue; } //text unfold from top.
   }
 }
@@ -153,49 +152,94 @@ List::List(const std::string &_title, const std::vector<unsigned char> &_pic) {
   this->positionForeground = {};
 }
 
-void List::render(const std::vector<float> &_camera) {
-  Item::updateConfig();
+void List::setSource(ListSource *_source) {
+  source = _source;
+  if (selectIndex >= getItemNum()) selectIndex = getItemNum() > 0 ? getItemNum() - 1 : 0;
+}
 
+uint16_t List::getItemNum() const { return source ? source->size() : Menu::getItemNum(); }
+
+Menu::Position List::getItemPosition(uint16_t _index) const {
+  if (!source) return Menu::getItemPosition(_index);
+  float y = _index * astraConfig.listLineHeight;
+  return {astraConfig.listTextMargin, astraConfig.listTextMargin, y, y};
+}
+
+const std::string &List::getItemTitle(uint16_t _index) const {
+  return source ? source->title(_index) : Menu::getItemTitle(_index);
+}
+
+//视口上下各留一行余量
+bool List::rowVisible(float _y, const Vec2 &_camera) const {
+  float top = _y + _camera.y;
+  return top + 2 * astraConfig.listLineHeight > 0 && top - astraConfig.listLineHeight < systemConfig.screenHeight;
+}
+
+void List::drawRow(float _x, float _y, const std::string &_title, uint16_t _index, bool _hasWidget,
+                   const Vec2 &_camera) {
+  //draw text (scroll if overflow)
+  float textX = _x + _camera.x;
+  float textY = _y + astraConfig.listTextHeight + astraConfig.listTextMargin + _camera.y;
+  float maxWidth = systemConfig.screenWeight - astraConfig.listBarWeight - astraConfig.listTextMargin - 2;
+  if (_hasWidget) {
+    maxWidth -= (astraConfig.checkBoxRightMargin + astraConfig.checkBoxWidth);
+  }
+  if (maxWidth < 10) maxWidth = 10;
+  float textW = HAL::getFontWidth(_title);
+  if (textW > maxWidth) {
+    Animation::busy();  //滚动的长标题一直在动
+    float gap = std::max(8.0f, maxWidth * 0.2f);
+    float cyclePx = textW + gap;
+    float durationMs = astraConfig.listScrollLoopMs;
+    if (durationMs < 200.0f) durationMs = 200.0f;
+    float speedPxPerMs = cyclePx / durationMs;
+    float phaseMs = static_cast<float>(HAL::millis()) + _index * 200.0f;
+    float offset = std::fmod(phaseMs * speedPxPerMs, cyclePx);
+    float baseX = textX - offset;
+    HAL::drawChinese(baseX, textY, _title);
+    HAL::drawChinese(baseX + cyclePx, textY, _title);
+  } else {
+    HAL::drawChinese(textX, textY, _title);
+  }
+}
+
+void List::render(const Vec2 &_camera) {
   HAL::setDrawType(1);
   //allow x > screen height, y > screen weight.
-  //scan all children, draw text and widget on the list.
-  unsigned char idx = 0;
-  for (auto _iter : childMenu) {
-    //绘制控件在列表中的指示器
-    if (!_iter->childWidget.empty()) {
-      for (auto _widget : _iter->childWidget) {
-        _widget->renderIndicator(
-            systemConfig.screenWeight - astraConfig.checkBoxRightMargin - astraConfig.checkBoxWidth,
-            _iter->position.y + astraConfig.checkBoxTopMargin,
-            _camera);
+  //只绘制视口内的行 视口外的行不测字宽也不画字
+  if (source) {
+    //虚拟列表的行都在目标位置上 直接算出可见的序号范围
+    float lineHeight = astraConfig.listLineHeight;
+    float first = std::floor((-_camera.y - lineHeight) / lineHeight);
+    float last = std::ceil((systemConfig.screenHeight - _camera.y + lineHeight) / lineHeight);
+    uint16_t count = source->size();
+    uint16_t begin = first < 0 ? 0 : static_cast<uint16_t>(std::min<float>(first, count));
+    uint16_t end = last < 0 ? 0 : static_cast<uint16_t>(std::min<float>(last + 1, count));
+    for (uint16_t idx = begin; idx < end; idx++)
+      drawRow(astraConfig.listTextMargin, idx * lineHeight, source->title(idx), idx, false, _camera);
+  } else {
+    uint16_t idx = 0;
+    for (auto _iter : childMenu) {
+      Position &pos = _iter->position;
+      if (rowVisible(pos.y, _camera)) {
+        //绘制控件在列表中的指示器
+        for (auto _widget : _iter->childWidget) {
+          _widget->renderIndicator(
+              systemConfig.screenWeight - astraConfig.checkBoxRightMargin - astraConfig.checkBoxWidth,
+              pos.y + astraConfig.checkBoxTopMargin,
+              _camera);
+        }
+        drawRow(pos.x, pos.y, _iter->title, idx, !_iter->childWidget.empty(), _camera);
+        //这里的yTrg在addItem的时候就已经确定了
+        Animation::move(&pos.y, pos.yTrg, astraConfig.listAnimationSpeed);
+      } else if (pos.y != pos.yTrg) {
+        //缓动是单调的 起点和终点在视口同一侧时 途中也不会进入视口 直接落到终点
+        bool above = pos.y + _camera.y < 0;
+        if (!rowVisible(pos.yTrg, _camera) && above == (pos.yTrg + _camera.y < 0)) pos.y = pos.yTrg;
+        else Animation::move(&pos.y, pos.yTrg, astraConfig.listAnimationSpeed);
       }
-    }    //draw text (scroll if overflow)
-    float textX = _iter->position.x + _camera[0];
-    float textY = _iter->position.y + astraConfig.listTextHeight +
-                  astraConfig.listTextMargin + _camera[1];
-    float maxWidth = systemConfig.screenWeight - astraConfig.listBarWeight - astraConfig.listTextMargin - 2;
-    if (!_iter->childWidget.empty()) {
-      maxWidth -= (astraConfig.checkBoxRightMargin + astraConfig.checkBoxWidth);
+      idx++;
     }
-    if (maxWidth < 10) maxWidth = 10;
-    float textW = HAL::getFontWidth(_iter->title);
-    if (textW > maxWidth) {
-      float gap = std::max(8.0f, maxWidth * 0.2f);
-      float cyclePx = textW + gap;
-      float durationMs = astraConfig.listScrollLoopMs;
-      if (durationMs < 200.0f) durationMs = 200.0f;
-      float speedPxPerMs = cyclePx / durationMs;
-      float phaseMs = static_cast<float>(HAL::millis()) + idx * 200.0f;
-      float offset = std::fmod(phaseMs * speedPxPerMs, cyclePx);
-      float baseX = textX - offset;
-      HAL::drawChinese(baseX, textY, _iter->title);
-      HAL::drawChinese(baseX + cyclePx, textY, _iter->title);
-    } else {
-      HAL::drawChinese(textX, textY, _iter->title);
-    }
-    //这里的yTrg在addItem的时候就已经确定了
-    Animation::move(&_iter->position.y, _iter->position.yTrg, astraConfig.listAnimationSpeed);
-    idx++;
   }
 
   //draw bar.
@@ -223,8 +267,8 @@ void List::render(const std::vector<float> &_camera) {
   Animation::move(&positionForeground.hBar, positionForeground.hBarTrg, astraConfig.listAnimationSpeed);
 }
 
-void Tile::childPosInit(const std::vector<float> &_camera) {
-  unsigned char _index = 0;
+void Tile::childPosInit(const Vec2 &_camera) {
+  uint16_t _index = 0;
 
   for (auto _iter : childMenu) {
     _iter->position.y = 0;
@@ -235,7 +279,7 @@ void Tile::childPosInit(const std::vector<float> &_camera) {
     _index++;
 
     if (_iter->parent->parent == nullptr) { _iter->position.x = _iter->position.xTrg; continue; }
-    if (astraConfig.tileUnfold) { _iter->position.x = _camera[0] - astraConfig.tilePicWidth; continue; } //unfold from left.
+    if (astraConfig.tileUnfold) { _iter->position.x = _camera.x - astraConfig.tilePicWidth; continue; } //unfold from left.
   }
 }
 
@@ -314,14 +358,12 @@ Tile::Tile(const std::string &_title, const std::vector<unsigned char> &_pic) {
   this->positionForeground = {};
 }
 
-void Tile::render(const std::vector<float> &_camera) {
-  Item::updateConfig();
-
+void Tile::render(const Vec2 &_camera) {
   HAL::setDrawType(1);
   //draw pic.
   for (auto _iter : childMenu) {
-    HAL::drawBMP(_iter->position.x + _camera[0],
-                 astraConfig.tilePicTopMargin + _camera[1],
+    HAL::drawBMP(_iter->position.x + _camera.x,
+                 astraConfig.tilePicTopMargin + _camera.y,
                  astraConfig.tilePicWidth,
                  astraConfig.tilePicHeight,
                  _iter->pic.data());
@@ -7,6 +7,7 @@
 #define ASTRA_ASTRA__H
 
 #include "cstdint"
+#include <array>
 #include "string"
 #include <vector>
 #include "../item.h"
@@ -16,15 +17,15 @@ namespace astra {
 
 class Menu : public Item {
 public:
-  [[nodiscard]] virtual std::string getType() const { return "Base"; }
+  [[nodiscard]] virtual MenuType getType() const { return MenuType::Base; }
 
 public:
-  std::vector<float> cameraPosMemory = {};
-  void rememberCameraPos(const std::vector<float> &_camera) {
+  Vec2 cameraPosMemory = {};
+  void rememberCameraPos(const Vec2 &_camera) {
     cameraPosMemory = _camera;
     cameraPosMemoryFlag = true;
   }
-  [[nodiscard]] std::vector<float> getCameraMemoryPos() const { return cameraPosMemory; }
+  [[nodiscard]] Vec2 getCameraMemoryPos() const { return cameraPosMemory; }
   void resetCameraMemoryPos() { cameraPosMemory = {0, 0}; }
   //编写一个变量 指示该页面到底有没有记忆
   bool cameraPosMemoryFlag = false;
@@ -39,8 +40,9 @@ public:
 
   Position position{};
 
-  [[nodiscard]] Position getItemPosition(unsigned char _index) const;
-  virtual void childPosInit(const std::vector<float> &_camera) {}
+  [[nodiscard]] virtual Position getItemPosition(uint16_t _index) const;
+  [[nodiscard]] virtual const std::string &getItemTitle(uint16_t _index) const;
+  virtual void childPosInit(const Vec2 &_camera) {}
   virtual void forePosInit() {}
 
 public:
@@ -55,9 +57,9 @@ public:
   Menu *parent{};
   std::vector<Menu *> childMenu; //allow widget and menu.
   std::vector<Widget *> childWidget;
-  unsigned char selectIndex{};
+  uint16_t selectIndex{};
 
-  [[nodiscard]] unsigned char getItemNum() const;
+  [[nodiscard]] virtual uint16_t getItemNum() const;
   [[nodiscard]] Menu *getNextMenu() const;  //启动器调用该方法来获取下一个页面
   [[nodiscard]] Menu *getPreview() const;
 
@@ -69,20 +71,30 @@ public:
   virtual ~Menu() = default;
 
 public:
-  void init(const std::vector<float>& _camera); //每次打开页面都要调用一次
+  void init(const Vec2 &_camera); //每次打开页面都要调用一次
   void deInit(); //每次关闭页面都要调用一次
 
 public:
-  virtual void render(const std::vector<float> &_camera) {}  //render all child item.
+  virtual void render(const Vec2 &_camera) {}  //render all child item.
 
 public:
   bool addItem(Menu *_page);
   bool addItem(Menu *_page, Widget* _anyWidget); //新建一个带有控件的列表项
 };
 
+//虚拟列表的数据源 行数很多时不必为每一行创建 Menu 节点
+//只有落在视口内的行才会被取标题 选中哪一行由 List::selectIndex 给出
+//目前固件里没有用到: 设备列表的行带 id 更新时还要滑到新位置 用的是 device_menu 的行池 这里只有主机测试在用
+class ListSource {
+public:
+  virtual ~ListSource() = default;
+  [[nodiscard]] virtual uint16_t size() const = 0;
+  [[nodiscard]] virtual const std::string &title(uint16_t _index) const = 0;
+};
+
 class List : public Menu {
 public:
-  [[nodiscard]] std::string getType() const override { return "List"; }
+  [[nodiscard]] MenuType getType() const override { return MenuType::List; }
 
 public:
   //前景元素的坐标
@@ -94,7 +106,7 @@ public:
   PositionForeground positionForeground{};
 
 public:
-  void childPosInit(const std::vector<float> &_camera) override;
+  void childPosInit(const Vec2 &_camera) override;
   void forePosInit() override;
 
   List();
@@ -103,17 +115,30 @@ public:
   List(const std::string &_title, const std::vector<unsigned char>& _pic);
 
 public:
-  std::vector<unsigned char> boundary = {0, static_cast<unsigned char>(systemConfig.screenHeight / astraConfig.listLineHeight - 1)};
-  [[nodiscard]] std::vector<unsigned char> getBoundary() const { return boundary; }
-  void refreshBoundary(unsigned char _l, unsigned char _r) { boundary = {_l, _r}; }
+  std::array<uint16_t, 2> boundary = {0, static_cast<uint16_t>(systemConfig.screenHeight / astraConfig.listLineHeight - 1)};
+  [[nodiscard]] const std::array<uint16_t, 2> &getBoundary() const { return boundary; }
+  void refreshBoundary(uint16_t _l, uint16_t _r) { boundary = {_l, _r}; }
 
 public:
-  void render(const std::vector<float> &_camera) override;
+  //设置数据源后 childMenu 不再使用 行坐标由序号直接算出
+  ListSource *source = nullptr;
+  void setSource(ListSource *_source);
+
+  [[nodiscard]] uint16_t getItemNum() const override;
+  [[nodiscard]] Position getItemPosition(uint16_t _index) const override;
+  [[nodiscard]] const std::string &getItemTitle(uint16_t _index) const override;
+
+public:
+  void render(const Vec2 &_camera) override;
+
+private:
+  [[nodiscard]] bool rowVisible(float _y, const Vec2 &_camera) const;
+  void drawRow(float _x, float _y, const std::string &_title, uint16_t _index, bool _hasWidget, const Vec2 &_camera);
 };
 
 class Tile : public Menu {
 public:
-  [[nodiscard]] std::string getType() const override { return "Tile"; }
+  [[nodiscard]] MenuType getType() const override { return MenuType::Tile; }
 
 public:
   //前景元素的坐标
@@ -127,7 +152,7 @@ public:
   PositionForeground positionForeground{};
 
 public:
-  void childPosInit(const std::vector<float> &_camera) override;
+  void childPosInit(const Vec2 &_camera) override;
   void forePosInit() override;
 
   Tile();
@@ -136,7 +161,7 @@ public:
   Tile(const std::string &_title, const std::vector<unsigned char> &_pic);
 
 public:
-  void render(const std::vector<float> &_camera) override;
+  void render(const Vec2 &_camera) override;
 };
 
 }
@@ -8,7 +8,7 @@ namespace astra {
 
 void Selector::setPosition() {
   //在go的时候改变trg的值
-  if (menu->getType() == "Tile") {
+  if (menu->getType() == MenuType::Tile) {
 //    xTrg = menu->child[_index]->position.xTrg - (astraConfig.tileSelectBoxWeight - astraConfig.tilePicWidth) / 2;
 //    yTrg = menu->child[_index]->position.yTrg - (astraConfig.tileSelectBoxHeight - astraConfig.tilePicHeight) / 2;
     xTrg = menu->childMenu[menu->selectIndex]->position.xTrg - astraConfig.tileSelectBoxMargin;
@@ -19,11 +19,12 @@ void Selector::setPosition() {
 
     wTrg = astraConfig.tileSelectBoxWidth;
     hTrg = astraConfig.tileSelectBoxHeight;
-  } else if (menu->getType() == "List") {
-    xTrg = menu->childMenu[menu->selectIndex]->position.xTrg - astraConfig.selectorMargin;
-    yTrg = menu->childMenu[menu->selectIndex]->position.yTrg;
+  } else if (menu->getType() == MenuType::List) {
+    Menu::Position position = menu->getItemPosition(menu->selectIndex);
+    xTrg = position.xTrg - astraConfig.selectorMargin;
+    yTrg = position.yTrg;
 
-    wTrg = (float) HAL::getFontWidth(menu->childMenu[menu->selectIndex]->title) + astraConfig.listTextMargin * 2;
+    wTrg = (float) HAL::getFontWidth(menu->getItemTitle(menu->selectIndex)) + astraConfig.listTextMargin * 2;
     hTrg = astraConfig.listLineHeight;
     if (xTrg != x || yTrg != y || wTrg != w || hTrg != h) {
       listAnimStartMs = HAL::millis();
@@ -43,9 +44,7 @@ void Selector::setPosition() {
  * @note selector接管了移动选择指针的功能
  * @warning not support in loop. 不支持在循环内执行
  */
-void Selector::go(unsigned char _index) {
-  Item::updateConfig();
-
+void Selector::go(uint16_t _index) {
 //  if (_index > menu->childMenu.size() - 1) {
 //    if (astraConfig.menuLoop) _index = 0;
 //    else return;
@@ -54,7 +53,7 @@ void Selector::go(unsigned char _index) {
 //    else return;
 //  }
 
-  if (_index > menu->childMenu.size() - 1) return;
+  if (_index >= menu->getItemNum()) return;
   menu->selectIndex = _index;
   lastMoveMs = HAL::millis();
 
@@ -65,7 +64,7 @@ void Selector::goNext() {
   uint32_t now = HAL::millis();
   uint32_t pauseMs = static_cast<uint32_t>(astraConfig.wrapPauseMs);
   if (now < wrapPauseUntilMs && wrapPauseDir == 1) return;
-  if (this->menu->selectIndex == this->menu->childMenu.size() - 1) {
+  if (this->menu->selectIndex + 1 >= this->menu->getItemNum()) {
     if (astraConfig.menuLoop) {
       if (pauseMs == 0 || (lastMoveMs != 0 && (now - lastMoveMs) >= pauseMs)) {
         wrapArmed = false;
@@ -104,7 +103,7 @@ void Selector::goPreview() {
     if (astraConfig.menuLoop) {
       if (pauseMs == 0 || (lastMoveMs != 0 && (now - lastMoveMs) >= pauseMs)) {
         wrapArmed = false;
-        go(this->menu->childMenu.size() - 1);
+        go(this->menu->getItemNum() - 1);
         wrapPauseUntilMs = now + pauseMs;
         wrapPauseDir = -1;
         return;
@@ -118,7 +117,7 @@ void Selector::goPreview() {
       }
       if (now < wrapPauseUntilMs) return;
       wrapArmed = false;
-      go(this->menu->childMenu.size() - 1);
+      go(this->menu->getItemNum() - 1);
       wrapPauseUntilMs = now + pauseMs;
       wrapPauseDir = -1;
     } else {
@@ -150,11 +149,10 @@ bool Selector::destroy() {
   return true;
 }
 
-void Selector::render(std::vector<float> _camera) {
-  Item::updateConfig();
-
+void Selector::render(const Vec2 &_camera) {
   //实际上 这里已经实现过渡动画了
-  if (menu->getType() == "List" && listAnimActive) {
+  if (menu->getType() == MenuType::List && listAnimActive) {
+    Animation::busy();
     uint32_t now = HAL::millis();
     float duration = astraConfig.selectorListDurationMs;
     if (duration < 1.0f) duration = 1.0f;
@@ -175,7 +173,7 @@ void Selector::render(std::vector<float> _camera) {
     Animation::move(&w, wTrg, astraConfig.selectorWidthAnimationSpeed);
   }
 
-  if (menu->getType() == "Tile") {
+  if (menu->getType() == MenuType::Tile) {
     Animation::move(&yText, yTextTrg, astraConfig.selectorYAnimationSpeed);
 
     //draw text.
@@ -189,42 +187,42 @@ void Selector::render(std::vector<float> _camera) {
     //draw box.
     //大框需要受摄像机的影响
     HAL::setDrawType(2);
-    HAL::drawPixel(x + _camera[0], y + _camera[1]);
+    HAL::drawPixel(x + _camera.x, y + _camera.y);
     //左上角
-    HAL::drawHLine(x + _camera[0], y + _camera[1], astraConfig.tileSelectBoxLineLength + 1);
-    HAL::drawVLine(x + _camera[0], y + _camera[1], astraConfig.tileSelectBoxLineLength + 1);
+    HAL::drawHLine(x + _camera.x, y + _camera.y, astraConfig.tileSelectBoxLineLength + 1);
+    HAL::drawVLine(x + _camera.x, y + _camera.y, astraConfig.tileSelectBoxLineLength + 1);
     //左下角
-    HAL::drawHLine(x + _camera[0], y + _camera[1] + h - 1, astraConfig.tileSelectBoxLineLength + 1);
-    HAL::drawVLine(x + _camera[0],
-                   y + _camera[1] + h - astraConfig.tileSelectBoxLineLength - 1,
+    HAL::drawHLine(x + _camera.x, y + _camera.y + h - 1, astraConfig.tileSelectBoxLineLength + 1);
+    HAL::drawVLine(x + _camera.x,
+                   y + _camera.y + h - astraConfig.tileSelectBoxLineLength - 1,
                    astraConfig.tileSelectBoxLineLength);
     //右上角
-    HAL::drawHLine(x + _camera[0] + w - astraConfig.tileSelectBoxLineLength - 1,
-                   y + _camera[1],
+    HAL::drawHLine(x + _camera.x + w - astraConfig.tileSelectBoxLineLength - 1,
+                   y + _camera.y,
                    astraConfig.tileSelectBoxLineLength);
-    HAL::drawVLine(x + _camera[0] + w - 1, y + _camera[1], astraConfig.tileSelectBoxLineLength + 1);
+    HAL::drawVLine(x + _camera.x + w - 1, y + _camera.y, astraConfig.tileSelectBoxLineLength + 1);
     //右下角
-    HAL::drawHLine(x + _camera[0] + w - astraConfig.tileSelectBoxLineLength - 1,
-                   y + _camera[1] + h - 1,
+    HAL::drawHLine(x + _camera.x + w - astraConfig.tileSelectBoxLineLength - 1,
+                   y + _camera.y + h - 1,
                    astraConfig.tileSelectBoxLineLength);
-    HAL::drawVLine(x + _camera[0] + w - 1,
-                   y + _camera[1] + h - astraConfig.tileSelectBoxLineLength - 1,
+    HAL::drawVLine(x + _camera.x + w - 1,
+                   y + _camera.y + h - astraConfig.tileSelectBoxLineLength - 1,
                    astraConfig.tileSelectBoxLineLength);
 
-    HAL::drawPixel(x + _camera[0] + w - 1, y + _camera[1] + h - 1);
-  } else if (menu->getType() == "List") {
+    HAL::drawPixel(x + _camera.x + w - 1, y + _camera.y + h - 1);
+  } else if (menu->getType() == MenuType::List) {
     //animation(&h, hTrg, astraConfig.selectorAnimationSpeed);
 
     //draw select box.
     //受摄像机的影响
     HAL::setDrawType(2);
-    HAL::drawRBox(x + _camera[0], y + _camera[1], w, h - 1, astraConfig.selectorRadius);
+    HAL::drawRBox(x + _camera.x, y + _camera.y, w, h - 1, astraConfig.selectorRadius);
     //HAL::drawRBox(x, y, w, astraConfig.listLineHeight, astraConfig.selectorRadius);
     HAL::setDrawType(1);
   }
 }
 
-std::vector<float> Selector::getPosition() {
+Vec2 Selector::getPosition() const {
   return {xTrg, yTrg};
 }
 }
@@ -42,17 +42,17 @@ public:
   //最牛逼的来了 在磁贴中 文字和大框就是selector
   //这样就可以弄磁贴的文字出现动画了
 
-  std::vector<float> getPosition();
+  Vec2 getPosition() const;
   void setPosition();
 
-  void go(unsigned char _index);
+  void go(uint16_t _index);
   void goNext();
   void goPreview();
 
   bool inject(Menu *_menu); //inject menu instance to prepare for render.
   bool destroy(); //destroy menu instance.
 
-  void render(std::vector<float> _camera);
+  void render(const Vec2 &_camera);
 };
 }
 #endif //ASTRA_CORE_SRC_ASTRA_UI_ELEMENT_SELECTOR_SELECTOR_H_
@@ -1,6 +1,7 @@
 #include "widget.h"
 
 #include <cmath>
+#include <cstdio>
 
 namespace astra {
 
@@ -38,23 +39,22 @@ void CheckBox::deInit() {
   delete this;
 }
 
-void CheckBox::renderIndicator(float _x, float _y, const std::vector<float> &_camera) {
-  Item::updateConfig();
+void CheckBox::renderIndicator(float _x, float _y, const Vec2 &_camera) {
   //绘制外框
   HAL::setDrawType(1);
-  HAL::drawRFrame(_x + _camera[0],
-                  _y + _camera[1],
+  HAL::drawRFrame(_x + _camera.x,
+                  _y + _camera.y,
                   astraConfig.checkBoxWidth,
                   astraConfig.checkBoxHeight,
                   astraConfig.checkBoxRadius);
   if (isCheck) //绘制复选框内的点
-    HAL::drawBox(_x + _camera[0] + astraConfig.checkBoxWidth / 4,
-                 _y + _camera[1] + astraConfig.checkBoxHeight / 4,
+    HAL::drawBox(_x + _camera.x + astraConfig.checkBoxWidth / 4,
+                 _y + _camera.y + astraConfig.checkBoxHeight / 4,
                  astraConfig.checkBoxWidth / 2,
                  astraConfig.checkBoxHeight / 2);
 }
 
-void CheckBox::render(const std::vector<float> &_camera) {
+void CheckBox::render(const Vec2 &_camera) {
   //todo 选中复选框后弹出消息提醒 这玩意现在我倒觉得没啥必要 可以暂时不做
 }
 
@@ -92,14 +92,16 @@ void PopUp::deInit() {
   delete this;
 }
 
-void PopUp::renderIndicator(float _x, float _y, const std::vector<float> &_camera) {
-  Item::updateConfig();
+void PopUp::renderIndicator(float _x, float _y, const Vec2 &_camera) {
   HAL::setDrawType(1);
   //把左下角转换为左上角 居中
-  HAL::drawEnglish(_x + _camera[0] + 1, _y + _camera[1] + astraConfig.listTextHeight, std::to_string(value));
+  char valText[4];
+  snprintf(valText, sizeof(valText), "%u", static_cast<unsigned>(value));
+  indicatorText.assign(valText);
+  HAL::drawEnglish(_x + _camera.x + 1, _y + _camera.y + astraConfig.listTextHeight, indicatorText);
 }
 
-void PopUp::render(const std::vector<float> &_camera) {
+void PopUp::render(const Vec2 &_camera) {
   //Widget::render(_camera);
 }
 
@@ -145,10 +147,9 @@ void Slider::deInit() {
   delete this;
 }
 
-void Slider::renderIndicator(float _x, float _y, const std::vector<float> &_camera) {
-  Item::updateConfig();
+void Slider::renderIndicator(float _x, float _y, const Vec2 &_camera) {
   const float rightEdge = _x + astraConfig.checkBoxWidth;
-  const float top = _y + _camera[1];
+  const float top = _y + _camera.y;
 
   static const uint8_t BAYER4[4][4] = {
       {0, 8, 2, 10},
@@ -166,7 +167,7 @@ void Slider::renderIndicator(float _x, float _y, const std::vector<float> &_came
   };
 
   int displayValue = value;
-  std::string unit;
+  const char *unit = "";
   if (title.find("Volume") != std::string::npos) {
     unit = "%";
   } else if (title.find("SPI") != std::string::npos) {
@@ -202,14 +203,16 @@ void Slider::renderIndicator(float _x, float _y, const std::vector<float> &_came
     unit = " cps";
   }
 
-  std::string valText = std::to_string(displayValue) + unit;
-  float textW = HAL::getFontWidth(valText);
-  float textX = rightEdge - textW + _camera[0];
+  char valText[24];
+  snprintf(valText, sizeof(valText), "%d%s", displayValue, unit);
+  indicatorText.assign(valText);
+  float textW = HAL::getFontWidth(indicatorText);
+  float textX = rightEdge - textW + _camera.x;
   if (textX < 0.0f) textX = 0.0f;
   float textY = top + astraConfig.listTextHeight;
 
   HAL::setDrawType(1);
-  HAL::drawEnglish(textX, textY, valText);
+  HAL::drawEnglish(textX, textY, indicatorText);
 
   float lineY = textY + 2.0f;
   int lineW = static_cast<int>(std::round(textW));
@@ -232,7 +235,7 @@ void Slider::renderIndicator(float _x, float _y, const std::vector<float> &_came
   }
 }
 
-void Slider::render(const std::vector<float> &_camera) {
+void Slider::render(const Vec2 &_camera) {
   Widget::render(_camera);
 }
 }
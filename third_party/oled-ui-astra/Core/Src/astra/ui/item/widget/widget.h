@@ -6,13 +6,15 @@
 
 namespace astra {
 
+enum class WidgetType : unsigned char { Base, CheckBox, PopUp, Slider };
+
 class Widget : public Item {
 public:
   void *parent{};
   unsigned char value{};
 
 public:
-  [[nodiscard]] virtual std::string getType() const { return "base"; }
+  [[nodiscard]] virtual WidgetType getType() const { return WidgetType::Base; }
 
 public:
   Widget() = default;
@@ -25,15 +27,15 @@ public:
 
 public:
   //绘制控件在列表中的指示器
-  virtual void renderIndicator(float _x, float _y, const std::vector<float> &_camera) {}
+  virtual void renderIndicator(float _x, float _y, const Vec2 &_camera) {}
 
 public:
-  virtual void render(const std::vector<float> &_camera) {}
+  virtual void render(const Vec2 &_camera) {}
 };
 
 class CheckBox : public Widget {
 public:
-  [[nodiscard]] std::string getType() const override { return "CheckBox"; }
+  [[nodiscard]] WidgetType getType() const override { return WidgetType::CheckBox; }
 
 private:
   bool isCheck;
@@ -51,15 +53,15 @@ public:
   void deInit() override;
 
 public:
-  void renderIndicator(float _x, float _y, const std::vector<float> &_camera) override;
+  void renderIndicator(float _x, float _y, const Vec2 &_camera) override;
 
 public:
-  void render(const std::vector<float> &_camera) override;
+  void render(const Vec2 &_camera) override;
 };
 
 class PopUp : public Widget {
 public:
-  [[nodiscard]] std::string getType() const override { return "PopUp"; }
+  [[nodiscard]] WidgetType getType() const override { return WidgetType::PopUp; }
 
 public:
   typedef struct Position {
@@ -72,6 +74,7 @@ public:
 private:
   std::string title;
   std::vector<std::string> options;
+  std::string indicatorText;  //复用缓冲 每帧不分配
   unsigned char direction;
   unsigned char boundary;
 
@@ -92,15 +95,15 @@ public:
   void deInit() override;
 
 public:
-  void renderIndicator(float _x, float _y, const std::vector<float> &_camera) override;
+  void renderIndicator(float _x, float _y, const Vec2 &_camera) override;
 
 public:
-  void render(const std::vector<float> &_camera) override;
+  void render(const Vec2 &_camera) override;
 };
 
 class Slider : public Widget {
 public:
-  [[nodiscard]] std::string getType() const override { return "Slider"; }
+  [[nodiscard]] WidgetType getType() const override { return WidgetType::Slider; }
 
 public:
   typedef struct Position {
@@ -114,6 +117,7 @@ public:
 
 private:
   std::string title;
+  std::string indicatorText;  //复用缓冲 每帧不分配
   unsigned char maxLength;
   unsigned char min;
   unsigned char max;
@@ -139,10 +143,10 @@ public:
   void deInit() override;
 
 public:
-  void renderIndicator(float _x, float _y, const std::vector<float> &_camera) override;
+  void renderIndicator(float _x, float _y, const Vec2 &_camera) override;
 
 public:
-  void render(const std::vector<float> &_camera) override;
+  void render(const Vec2 &_camera) override;
 };
 }
 
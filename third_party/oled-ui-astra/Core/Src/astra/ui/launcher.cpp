@@ -6,62 +6,98 @@
 
 namespace astra {
 
-void Launcher::popInfo(std::string _info, uint16_t _time) {
-  bool onRender = true;
-  bool stickyByBackOnly = (_time == 65535);
-  uint32_t beginTimeMs = HAL::millis();
+/**
+ * @brief 弹出提示 立即返回
+ *
+ * @param _time 显示时长 65535 表示只能用返回键关闭
+ * @note 已有弹窗时排队 与正在显示或队尾相同的消息只刷新计时
+ */
+void Launcher::popInfo(const std::string &_info, uint16_t _time) {
+  if (!popShown) {
+    popStart(_info, _time);
+    return;
+  }
+  if (pop.info == _info && yPopTrg != yHide) {
+    pop.time = _time;
+    popBeginMs = HAL::millis();
+    return;
+  }
+  if (popCount > 0 && popQueue[(popHead + popCount - 1) % POP_QUEUE_SIZE].info == _info) return;
+  if (popCount == POP_QUEUE_SIZE) { //满了丢掉最旧的
+    popHead = (popHead + 1) % POP_QUEUE_SIZE;
+    popCount--;
+  }
+  Pop &slot = popQueue[(popHead + popCount) % POP_QUEUE_SIZE];
+  slot.info.assign(_info);
+  slot.time = _time;
+  popCount++;
+}
+
+void Launcher::popStart(const std::string &_info, uint16_t _time) {
+  pop.info.assign(_info);
+  pop.time = _time;
+  popShown = true;
+  popBeginMs = HAL::millis();
+  popDrawn = false; //上一条已经退到屏幕外
 
   float padX = getUIConfig().popMargin;
-  float padTop = 1.0f;
-  float padBottom = 2.0f;
-
-  float wPop = HAL::getFontWidth(_info) + 2 * padX;
-  float hPop = HAL::getFontHeight() + padTop + padBottom;
-  float yPop = 0 - hPop - 8;
-  float yPopTrg = (HAL::getSystemConfig().screenHeight - hPop) / 3;
-  float xPop = (HAL::getSystemConfig().screenWeight - wPop) / 2;
-  float yHide = 0 - hPop - 8;
-
-  while (onRender) {
-    Animation::tick();
-    time = HAL::millis();
-
-    HAL::canvasClear();
-    currentMenu->render(camera->getPosition());
-    selector->render(camera->getPosition());
-    camera->update(currentMenu, selector);
-    if (popRenderHook) {
-      popRenderHook();
-    }
+  wPop = HAL::getFontWidth(pop.info) + 2 * padX;
+  hPop = HAL::getFontHeight() + 1.0f + 2.0f;
+  xPop = (HAL::getSystemConfig().screenWeight - wPop) / 2;
+  yHide = 0 - hPop - 8;
+  yPop = yHide;
+  yPopTrg = (HAL::getSystemConfig().screenHeight - hPop) / 3;
+}
 
-    HAL::setDrawType(0);
-    HAL::drawRBox(xPop - 4, yPop - 4, wPop + 8, hPop + 8, getUIConfig().popRadius + 2);
-    HAL::setDrawType(1);
-    HAL::drawRFrame(xPop - 1, yPop - 1, wPop + 2, hPop + 2, getUIConfig().popRadius);
-    HAL::drawEnglish(xPop + padX,
-                     yPop + padTop + HAL::getFontHeight() - 2,
-                     _info);
-
-    HAL::canvasUpdate();
-    Animation::move(&yPop, yPopTrg, getUIConfig().popSpeed);
-
-    if (!stickyByBackOnly && time - beginTimeMs >= _time) yPopTrg = yHide;
-
-    HAL::keyScan();
-    if (HAL::getAnyKey()) {
-      for (unsigned char i = 0; i < key::KEY_NUM; i++) {
-        if (HAL::getKeyMap()[i] == key::CLICK) {
-          if (!stickyByBackOnly || i == key::KEY_0) {
-            yPopTrg = yHide;
-          }
-        }
-      }
-      std::fill(HAL::getKeyMap(), HAL::getKeyMap() + key::KEY_NUM, key::INVALID);
+bool Launcher::popKeys() {
+  if (!popShown) return false;
+  if (*HAL::getKeyFlag() == key::KEY_PRESSED) {
+    bool stickyByBackOnly = (pop.time == 65535);
+    for (unsigned char i = 0; i < key::KEY_NUM; i++) {
+      if (HAL::getKeyMap()[i] != key::CLICK) continue;  //长按不关弹窗
+      if (!stickyByBackOnly || i == key::KEY_0) yPopTrg = yHide;
     }
+    std::fill(HAL::getKeyMap(), HAL::getKeyMap() + key::KEY_NUM, key::INVALID);
+    *HAL::getKeyFlag() = key::KEY_NOT_PRESSED;
+  }
+  return true;
+}
+
+void Launcher::renderPopup() {
+  if (!popShown) return;
+  time = HAL::millis();
+  if (pop.time != 65535 && time - popBeginMs >= pop.time) yPopTrg = yHide;
 
-    if (std::fabs(yPop - yHide) <= 1.0f) {
-      yPop = yHide;
-      onRender = false;
+  float padX = getUIConfig().popMargin;
+  float padTop = 1.0f;
+  float top = yPop - 4, bottom = yPop + hPop + 4;
+  if (popDrawn) {
+    top = std::min(top, popDrawnY - 4);
+    bottom = std::max(bottom, popDrawnY + popDrawnH + 4);
+  }
+  popBandY = std::max(0.0f, top);
+  popBandH = std::max(0.0f, bottom - popBandY);
+  popDrawnY = yPop;
+  popDrawnH = hPop;
+  popDrawn = true;
+
+  HAL::setDrawType(0);
+  HAL::drawRBox(xPop - 4, yPop - 4, wPop + 8, hPop + 8, getUIConfig().popRadius + 2);
+  HAL::setDrawType(1);
+  HAL::drawRFrame(xPop - 1, yPop - 1, wPop + 2, hPop + 2, getUIConfig().popRadius);
+  HAL::drawEnglish(xPop + padX,
+                   yPop + padTop + HAL::getFontHeight() - 2,
+                   pop.info);
+
+  Animation::move(&yPop, yPopTrg, getUIConfig().popSpeed);
+
+  if (yPopTrg == yHide && std::fabs(yPop - yHide) <= 1.0f) {
+    popShown = false;
+    if (popCount > 0) {
+      Pop &next = popQueue[popHead];
+      popHead = (popHead + 1) % POP_QUEUE_SIZE;
+      popCount--;
+      popStart(next.info, next.time);
     }
   }
 }
@@ -98,7 +134,8 @@ bool Launcher::open() {
 
   currentMenu->rememberCameraPos(camera->getPositionTrg());
 
-  currentMenu->deInit();  //先析构（退场动画）再挪动指针
+  currentMenu->deInit();  //先析构再挪动指针 过渡动画在之后的帧里推进
+  beginTransition(1);
 
   currentMenu = currentMenu->getNextMenu();
   currentMenu->selectIndex = 0;
@@ -129,7 +166,8 @@ bool Launcher::close() {
 
   currentMenu->rememberCameraPos(camera->getPositionTrg());
 
-  currentMenu->deInit();  //先析构（退场动画）再挪动指针
+  currentMenu->deInit();  //先析构再挪动指针 过渡动画在之后的帧里推进
+  beginTransition(-1);
 
   currentMenu = currentMenu->getPreview();
   currentMenu->selectIndex = 0;
@@ -142,15 +180,51 @@ bool Launcher::close() {
   return true;
 }
 
+void Launcher::beginTransition(float _dir) {
+  transitionActive = true;
+  transitionStartMs = HAL::millis();
+  transitionDir = _dir;
+}
+
+/**
+ * @brief 推进页面过渡
+ *
+ * @return 0~1 的进度 没有过渡时为 1
+ */
+float Launcher::stepTransition() {
+  if (!transitionActive) return 1.0f;
+  float duration = getUIConfig().fadeAnimationSpeed;
+  if (duration < 1.0f) duration = 1.0f;
+  float t = static_cast<float>(HAL::millis() - transitionStartMs) / duration;
+  if (t >= 1.0f) {
+    transitionActive = false;
+    return 1.0f;
+  }
+  return t;
+}
+
 void Launcher::update() {
   Animation::tick();
   HAL::canvasClear();
 
-  currentMenu->render(camera->getPosition());
-  if (currentWidget != nullptr) currentWidget->render(camera->getPosition());
-  selector->render(camera->getPosition());
+  float t = stepTransition();
+  Vec2 view = camera->getPosition();
+  if (getUIConfig().pageTransition == PageTransition::Slide && t < 1.0f) {
+    float ease = t * t * (3.0f - 2.0f * t);
+    view.x += (1.0f - ease) * transitionDir * HAL::getSystemConfig().screenWeight;
+  }
+
+  currentMenu->render(view);
+  if (currentWidget != nullptr) currentWidget->render(view);
+  selector->render(view);
   camera->update(currentMenu, selector);
 
+  //新页面从全遮逐级淡入 遮罩在 HAL 扩展画布时套用
+  if (getUIConfig().pageTransition == PageTransition::Fade && t < 1.0f) {
+    auto level = static_cast<unsigned char>(t * (HAL::FADE_LEVELS + 1));
+    HAL::setCanvasFade(HAL::FADE_LEVELS - level, getUIConfig().lightMode);
+  }
+
 //  if (time == 500) selector->go(3);  //test
 //  if (time == 800) open();  //test
 //  if (time == 1200) selector->go(0);  //test
@@ -5,27 +5,58 @@
 #ifndef ASTRA_CORE_SRC_ASTRA_UI_SCHEDULER_H_
 #define ASTRA_CORE_SRC_ASTRA_UI_SCHEDULER_H_
 
+#include <array>
 #include "item/menu/menu.h"
 #include "item/selector/selector.h"
 #include "item/camera/camera.h"
 
 namespace astra {
 
-typedef void (*PopRenderHook)();
-
 class Launcher {
 private:
   Menu* currentMenu;
   Widget* currentWidget = nullptr;
   Selector* selector;
   Camera* camera;
-  PopRenderHook popRenderHook = nullptr;
 
   uint64_t time;
 
+  //弹窗是常驻的叠加层 由主循环每帧推进 不再自带渲染循环
+  //显示期间到来的消息排队 依次显示
+  struct Pop {
+    std::string info;
+    uint16_t time;
+  };
+  static constexpr unsigned char POP_QUEUE_SIZE = 4;
+  std::array<Pop, POP_QUEUE_SIZE> popQueue{};
+  unsigned char popHead = 0;
+  unsigned char popCount = 0;
+
+  Pop pop{};
+  bool popShown = false;
+  uint32_t popBeginMs = 0;
+  float xPop = 0, yPop = 0, yPopTrg = 0, yHide = 0, wPop = 0, hPop = 0;
+  //本帧弹窗需要重画的横带 包含上一帧画过的位置 用于只刷新弹窗区域
+  float popDrawnY = 0, popDrawnH = 0, popBandY = 0, popBandH = 0;
+  bool popDrawn = false;
+
+  void popStart(const std::string &_info, uint16_t _time);
+
+  //页面切换过渡 open/close 时开始 之后每帧按经过的时间推进
+  bool transitionActive = false;
+  uint32_t transitionStartMs = 0;
+  float transitionDir = 1; //滑入方向 打开从右侧 返回从左侧
+
+  void beginTransition(float _dir);
+  float stepTransition();
+
 public:
-  void popInfo(std::string _info, uint16_t _time);
-  void setPopRenderHook(PopRenderHook hook) { popRenderHook = hook; }
+  void popInfo(const std::string &_info, uint16_t _time);
+  [[nodiscard]] bool isPopShown() const { return popShown; }
+  bool popKeys();    //弹窗显示时吞掉按键 在 keyScan 之后调用
+  void renderPopup(); //在 canvasUpdate 之前调用 叠加在最上层
+  [[nodiscard]] float getPopBandY() const { return popBandY; }
+  [[nodiscard]] float getPopBandH() const { return popBandH; }
 
   void init(Menu* _rootPage);
 
@@ -33,6 +64,10 @@ public:
   bool close();
 
   void update();
+  //动画、弹窗和页面过渡都已静止 画面与上一帧相同 主循环可以跳过这一帧
+  [[nodiscard]] bool isIdle() const { return Animation::idle() && !popShown && !transitionActive; }
+  //页面本身静止 弹窗下面的画面可以复用
+  [[nodiscard]] bool isPageStill() const { return Animation::idle() && !transitionActive; }
 
   Camera* getCamera() { return camera; }
   Selector* getSelector() { return selector; }
@@ -6,6 +6,7 @@
 #define ASTRA_CORE_SRC_HAL_HAL_H_
 
 #include <string>
+#include <string_view>
 #include <utility>
 #include <array>
 #include <vector>
@@ -57,7 +58,7 @@ struct config {
   float screenBright = 255;
 };
 
-static config &getSystemConfig() {
+inline config &getSystemConfig() {
   static config sysConfig;
   return sysConfig;
 }
@@ -109,13 +110,53 @@ public:
 
   virtual void _canvasClear() {}
 
+  /**
+   * @brief 只刷新画布中的一条横带 弹窗等模态层静止背景时使用
+   *
+   * @param _y 横带顶部 UI坐标
+   * @param _h 横带高度
+   * @note 默认整屏刷新
+   */
+  static void canvasUpdateRegion(float _y, float _h) { get()->_canvasUpdateRegion(_y, _h); }
+
+  virtual void _canvasUpdateRegion(float _y, float _h) { _canvasUpdate(); }
+
+  /**
+   * @brief 保存当前画布 作为模态层的静态背景
+   *
+   * @return 不支持或内存不足时返回false 调用方应退回整帧绘制
+   */
+  static bool canvasSnapshot() { return get()->_canvasSnapshot(); }
+
+  virtual bool _canvasSnapshot() { return false; }
+
+  //用上一次canvasSnapshot的内容覆盖画布
+  static bool canvasRestore() { return get()->_canvasRestore(); }
+
+  virtual bool _canvasRestore() { return false; }
+
+  //四级棋盘格淡出遮罩 {偶数字节, 奇数字节} 按画布字节的奇偶取用
+  static constexpr unsigned char FADE_LEVELS = 4;
+  static constexpr uint8_t FADE_MASK[FADE_LEVELS + 1][2] = {
+      {0xFF, 0xFF}, {0xFF, 0xAA}, {0xFF, 0x00}, {0x55, 0x00}, {0x00, 0x00}};
+
+  /**
+   * @brief 下一次 canvasUpdate 扩展画布时套用淡出遮罩 刷新后自动清除
+   *
+   * @param _level 0 不遮 FADE_LEVELS 全遮
+   * @param _toSet 浅色模式下向点亮方向淡出
+   */
+  static void setCanvasFade(unsigned char _level, bool _toSet) { get()->_setCanvasFade(_level, _toSet); }
+
+  virtual void _setCanvasFade(unsigned char _level, bool _toSet) {}
+
   static void setFont(const unsigned char *_font) { get()->_setFont(_font); }
 
   virtual void _setFont(const unsigned char *_font) {}
 
-  static unsigned char getFontWidth(std::string &_text) { return get()->_getFontWidth(_text); }
+  static unsigned char getFontWidth(std::string_view _text) { return get()->_getFontWidth(_text); }
 
-  virtual unsigned char _getFontWidth(std::string &_text) { return 0; }
+  virtual unsigned char _getFontWidth(std::string_view _text) { return 0; }
 
   static unsigned char getFontHeight() { return get()->_getFontHeight(); }
 
@@ -134,13 +175,79 @@ public:
   virtual void _drawCircle(float _x, float _y, float _r) {}
 
   //notice: _x和_y是字体左下角的坐标 _x and _y is the coordinate the lower left corner of the font
-  static void drawEnglish(float _x, float _y, const std::string &_text) { get()->_drawEnglish(_x, _y, _text); }
+  static void drawEnglish(float _x, float _y, std::string_view _text) { get()->_drawEnglish(_x, _y, _text); }
+
+  virtual void _drawEnglish(float _x, float _y, std::string_view _text) {}
+
+  static void drawChinese(float _x, float _y, std::string_view _text) { get()->_drawChinese(_x, _y, _text); }
 
-  virtual void _drawEnglish(float _x, float _y, const std::string &_text) {}
+  virtual void _drawChinese(float _x, float _y, std::string_view _text) {}
 
-  static void drawChinese(float _x, float _y, const std::string &_text) { get()->_drawChinese(_x, _y, _text); }
+  //预先整形的文字 收到文本时整形一次 之后每帧只按缓存的字形句柄和步进绘制
+  //句柄只对整形时的字体有效
+  struct Glyph {
+    const void *handle; //HAL 内部的字形句柄 u8g2 下指向字体里的字形数据
+    int8_t advance;
+  };
+  static constexpr uint16_t SHAPED_MAX = 128;
+  struct ShapedText {
+    uint16_t count = 0;
+    int16_t width = 0; //与 getFontWidth 相同的量法 但不会在 255 处回绕
+    Glyph glyphs[SHAPED_MAX];
+  };
 
-  virtual void _drawChinese(float _x, float _y, const std::string &_text) {}
+  /**
+   * @brief 解码 UTF-8 并查好每个字形 字体里没有的字符换成 '?'
+   *
+   * @note 不支持的 HAL 输出空串
+   */
+  static void shapeText(std::string_view _text, ShapedText &_out) { get()->_shapeText(_text, _out); }
+
+  virtual void _shapeText(std::string_view _text, ShapedText &_out) { _out.count = 0; _out.width = 0; }
+
+  static void drawShaped(float _x, float _y, const ShapedText &_text) { get()->_drawShaped(_x, _y, _text); }
+
+  virtual void _drawShaped(float _x, float _y, const ShapedText &_text) {}
+
+  //文字条带 与画布同格式的小缓冲 整行文字只画一次 之后每帧按位置贴回画布
+  static constexpr unsigned char STRIP_TILE_ROWS = 2;
+  static size_t getStripBytes() { return static_cast<size_t>(getBufferTileWidth()) * 8 * STRIP_TILE_ROWS; }
+
+  /**
+   * @brief 清空条带后画入 _text 的 [_first, _first + _count) 个字形 最高的字形贴着条带顶部
+   *
+   * @param _strip getStripBytes() 字节
+   */
+  static void renderStrip(uint8_t *_strip, float _x, const ShapedText &_text, uint16_t _first, uint16_t _count) {
+    get()->_renderStrip(_strip, _x, _text, _first, _count);
+  }
+
+  virtual void _renderStrip(uint8_t *_strip, float _x, const ShapedText &_text, uint16_t _first, uint16_t _count) {}
+
+  /**
+   * @brief 把条带贴到画布上 _y 是条带顶部 UI坐标
+   *
+   * @param _clipY0 _clipY1 只贴这个纵向范围内的行
+   * @param _invert 异或贴上 在已画好的底色上反色高亮
+   */
+  static void drawStrip(const uint8_t *_strip, float _y, float _clipY0, float _clipY1, bool _invert) {
+    get()->_drawStrip(_strip, _y, _clipY0, _clipY1, _invert);
+  }
+
+  virtual void _drawStrip(const uint8_t *_strip, float _y, float _clipY0, float _clipY1, bool _invert) {}
+
+  //u8g2 需要以\0结尾的字符串 把 _text 拷到调用方栈上的 _buf 放不下时在UTF-8字符边界截断
+  static constexpr size_t TEXT_MAX = 255;
+  static const char *terminate(std::string_view _text, char (&_buf)[TEXT_MAX + 1]) {
+    size_t len = _text.size();
+    if (len > TEXT_MAX) {
+      len = TEXT_MAX;
+      while (len > 0 && (static_cast<unsigned char>(_text[len]) & 0xC0) == 0x80) len--;
+    }
+    _text.copy(_buf, len);
+    _buf[len] = '\0';
+    return _buf;
+  }
 
   static void setClipWindow(int _x0, int _y0, int _x1, int _y1) { get()->_setClipWindow(_x0, _y0, _x1, _y1); }
 
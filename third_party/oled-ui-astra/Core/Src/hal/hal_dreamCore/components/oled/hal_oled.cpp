@@ -189,8 +189,9 @@ void HALDreamCore::_setFont(const unsigned char *_font) {
   u8g2_SetFont(&canvasBuffer, _font);
 }
 
-unsigned char HALDreamCore::_getFontWidth(std::string &_text) {
-  return u8g2_GetUTF8Width(&canvasBuffer, _text.c_str());
+unsigned char HALDreamCore::_getFontWidth(std::string_view _text) {
+  char buf[TEXT_MAX + 1];
+  return u8g2_GetUTF8Width(&canvasBuffer, terminate(_text, buf));
 }
 
 unsigned char HALDreamCore::_getFontHeight() {
@@ -205,12 +206,14 @@ void HALDreamCore::_drawPixel(float _x, float _y) {
   u8g2_DrawPixel(&canvasBuffer, (int16_t)std::round(_x), (int16_t)std::round(_y));
 }
 
-void HALDreamCore::_drawEnglish(float _x, float _y, const std::string &_text) {
-  u8g2_DrawStr(&canvasBuffer, (int16_t)std::round(_x), (int16_t)std::round(_y), _text.c_str());
+void HALDreamCore::_drawEnglish(float _x, float _y, std::string_view _text) {
+  char buf[TEXT_MAX + 1];
+  u8g2_DrawStr(&canvasBuffer, (int16_t)std::round(_x), (int16_t)std::round(_y), terminate(_text, buf));
 }
 
-void HALDreamCore::_drawChinese(float _x, float _y, const std::string &_text) {
-  u8g2_DrawUTF8(&canvasBuffer, (int16_t)std::round(_x), (int16_t)std::round(_y), _text.c_str());
+void HALDreamCore::_drawChinese(float _x, float _y, std::string_view _text) {
+  char buf[TEXT_MAX + 1];
+  u8g2_DrawUTF8(&canvasBuffer, (int16_t)std::round(_x), (int16_t)std::round(_y), terminate(_text, buf));
 }
 
 void HALDreamCore::_drawVDottedLine(float _x, float _y, float _h) {
@@ -69,12 +69,12 @@ public:
   void _canvasUpdate() override;
   void _canvasClear() override;
   void _setFont(const unsigned char * _font) override;
-  unsigned char _getFontWidth(std::string& _text) override;
+  unsigned char _getFontWidth(std::string_view _text) override;
   unsigned char _getFontHeight() override;
   void _setDrawType(unsigned char _type) override;
   void _drawPixel(float _x, float _y) override;
-  void _drawEnglish(float _x, float _y, const std::string& _text) override;
-  void _drawChinese(float _x, float _y, const std::string& _text) override;
+  void _drawEnglish(float _x, float _y, std::string_view _text) override;
+  void _drawChinese(float _x, float _y, std::string_view _text) override;
   void _drawVDottedLine(float _x, float _y, float _h) override;
   void _drawHDottedLine(float _x, float _y, float _l) override;
   void _drawVLine(float _x, float _y, float _h) override;